@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct GbTimer;
+
+// Every sample averages the output over this many T-cycles, 65536 Hz
+#define GB_APU_SAMPLE_CYCLES 64
+#define GB_APU_SAMPLE_RATE (4194304 / GB_APU_SAMPLE_CYCLES)
+
+// Stereo frames, must be a power of two
+#define GB_APU_BUFFER_FRAMES 8192
+
+// Steps on the falling edge of bit 12 of the system counter, 512 Hz. Double speed moves it to bit 13, which keeps the
+// rate in master cycles
+#define GB_APU_FRAME_SEQUENCER_CYCLES 8192
+
+enum GbApuChannelType
+{
+    GB_APU_CHANNEL_SQUARE_1,
+    GB_APU_CHANNEL_SQUARE_2,
+    GB_APU_CHANNEL_WAVE,
+    GB_APU_CHANNEL_NOISE,
+
+    GB_APU_CHANNEL_COUNT,
+};
+
+struct GbApuChannel
+{
+    bool enabled;
+    bool dac_enabled;
+    bool length_enabled;
+    uint16_t length; // Frame sequencer steps until the channel turns itself off
+
+    // Waveform
+    uint32_t period; // T-cycles between two steps of the waveform
+    uint32_t countdown; // T-cycles until the next step
+    uint8_t position; // Duty step, wave sample or unused for noise
+    int8_t level; // Output of the DAC (-15 to 15), 0 while the channel or the DAC is off
+
+    // Envelope, unused by the wave channel
+    uint8_t volume;
+    uint8_t envelope_timer;
+};
+
+struct GbApu
+{
+    struct GbTimer *timer; // Owns the system counter that clocks the frame sequencer
+
+    // 0xff10-0xff3f - Sound registers and wave RAM, as written
+    uint8_t registers[0x30];
+
+    struct GbApuChannel channels[GB_APU_CHANNEL_COUNT];
+    uint8_t frame_sequencer_step;
+
+    // Square 1 sweep
+    bool sweep_enabled;
+    uint16_t sweep_frequency; // Shadow of the frequency the sweep calculates from
+    uint8_t sweep_timer;
+
+    // Noise
+    uint16_t lfsr;
+
+    // Catch-up
+    uint64_t cycles; // Master cycle the APU has run up to
+    uint32_t sample_cycles; // T-cycles of the current sample that already ran
+    int64_t sample_left; // Mixed output integrated over the current sample
+    int64_t sample_right;
+    float capacitor_left; // Charge of the high-pass filter that removes the DC offset of the DACs
+    float capacitor_right;
+
+    // Ring buffer of interleaved stereo samples, the oldest are overwritten once the host falls behind
+    int16_t samples[GB_APU_BUFFER_FRAMES * 2];
+    uint64_t sample_head; // Frames produced since power on
+    uint64_t sample_tail; // Frames taken by the host
+
+    // Headless recording
+    FILE *wav;
+    uint64_t wav_head; // Frames written to the WAV file
+    uint32_t wav_frames; // Frames since the recording started
+};
+
+struct GbApu *gb_apu_create(void);
+
+// Finishes the WAV file if one is recorded
+void gb_apu_destroy(struct GbApu *);
+
+// 0xff10-0xff3f, accesses have to come after a sync to the current cycle
+void gb_apu_write(struct GbApu *, uint16_t address, uint8_t value);
+uint8_t gb_apu_read(struct GbApu *, uint16_t address);
+
+// Has to be called before the timer resets DIV, which can step the frame sequencer
+void gb_apu_reset_div(struct GbApu *);
+
+// Runs every channel up to the master cycle `cycles` event by event and produces the samples that finished
+void gb_apu_sync(struct GbApu *, uint64_t cycles);
+
+// Moves up to `frames` stereo frames produced since the last call into `samples`, returns how many
+size_t gb_apu_take_samples(struct GbApu *, int16_t *samples, size_t frames);
+
+// Writes every sample from now on into a 16-bit stereo WAV file, returns false if it can't be created
+bool gb_apu_start_wav(struct GbApu *, const char *path);
+void gb_apu_stop_wav(struct GbApu *);
+
+#ifdef __cplusplus
+}
+#endif
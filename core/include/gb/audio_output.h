@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct GbAudioOutputQueue;
+
+// Taps of every filter phase, a multiple of 4 for the SIMD dot products
+#define GB_AUDIO_OUTPUT_TAPS 32
+#define GB_AUDIO_OUTPUT_PHASES 256
+
+// Input frames the resampler works on at once, plus the taps it keeps around for the next batch
+#define GB_AUDIO_OUTPUT_HISTORY_FRAMES (1024 + GB_AUDIO_OUTPUT_TAPS)
+
+// The largest change of the resampling ratio dynamic rate control makes, far below an audible pitch shift
+#define GB_AUDIO_OUTPUT_MAX_RATE_DEVIATION 0.005
+
+// Converts the APU samples to the host rate with a windowed-sinc polyphase filter that cuts off at the Nyquist
+// frequency of the slower rate, and queues the result for an audio thread
+struct GbAudioOutput
+{
+    uint32_t input_rate;
+    uint32_t output_rate;
+    double step; // Input frames per output frame at the nominal rates
+
+    // Dynamic rate control, steers the queue towards half full by stretching the ratio a little
+    bool dynamic_rate;
+    double rate_adjustment; // Last factor applied to `step`
+
+    // (GB_AUDIO_OUTPUT_PHASES + 1) rows of taps, neighbouring rows are interpolated between
+    float *coefficients;
+
+    // Planar input waiting to be resampled, `position` is the fractional frame the next output is centred on
+    float history[2][GB_AUDIO_OUTPUT_HISTORY_FRAMES];
+    size_t history_count;
+    double position;
+
+    // Lock-free single producer, single consumer queue of interleaved 16-bit stereo frames at the output rate
+    struct GbAudioOutputQueue *queue;
+    uint64_t dropped_frames; // Frames that didn't fit into the queue
+};
+
+// `queue_frames` is rounded up to a power of two, half of it is the latency dynamic rate control aims for
+struct GbAudioOutput *gb_audio_output_create(uint32_t input_rate, uint32_t output_rate, size_t queue_frames);
+void gb_audio_output_destroy(struct GbAudioOutput *);
+
+void gb_audio_output_set_dynamic_rate(struct GbAudioOutput *, bool enabled);
+
+// Resamples interleaved stereo frames at the input rate into the queue, producer thread only
+void gb_audio_output_write(struct GbAudioOutput *, const int16_t *samples, size_t frames);
+
+// Moves up to `frames` queued frames into `samples` and returns how many, consumer thread only
+size_t gb_audio_output_read(struct GbAudioOutput *, int16_t *samples, size_t frames);
+
+// Safe to call from either thread
+size_t gb_audio_output_get_queued(const struct GbAudioOutput *);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct Gb;
+
+// The DMG boot ROM covers 0x0000-0x00ff, the CGB one 0x0200-0x08ff as well, leaving the cartridge header visible
+#define GB_BOOT_ROM_DMG_SIZE 0x100
+#define GB_BOOT_ROM_CGB_SIZE 0x900
+
+// Leaves every component in the state the boot ROM of the model hands over to the cartridge with at 0x0100, instead
+// of running it from power on. Applied through the I/O registers like the boot ROM does, so it needs the CGB mode to
+// be set already
+void gb_boot_skip(struct Gb *);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,24 +6,79 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#include "gb/cartridge_header.h"
+#include "gb/rtc.h"
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+struct GbCpu;
+struct GbMappedFile;
+struct GbRom;
+
+#define GB_CARTRIDGE_ROM_BANK_SIZE 0x4000
+#define GB_CARTRIDGE_RAM_BANK_SIZE 0x2000
+
 struct GbCartridge
 {
-    uint8_t *rom;
+    struct GbCpu *cpu; // Master clock of the RTC, may be NULL for a cartridge on its own
+
+    // Memory
+    const uint8_t *rom; // Padded to a power of two banks, so bank numbers wrap with a mask
+    size_t rom_size;
+    const struct GbRom *shared_rom; // Owner of `rom` when it came from the ROM cache, NULL if the cartridge owns it
+    uint8_t *ram; // NULL if the cartridge has none
+    size_t ram_size;
+    struct GbMappedFile *save; // Backs `ram` and the RTC state after it on cartridges with a battery, may be NULL
+    struct GbRtc *rtc; // MBC3 with a timer only
+
+    // Header
+    struct GbCartridgeHeader header;
+
+    // Mapper registers
+    bool ram_enabled;
+    uint16_t rom_bank; // Switchable bank, only the bits the mapper has
+    uint8_t ram_bank; // RAM bank, doubles as the upper ROM bank bits on MBC1
+    bool banking_mode; // MBC1 only, applies the RAM bank register to 0x0000-0x3fff and 0xa000-0xbfff
+
+    // Page table, bank switches repoint these so reads never look at the mapper
+    const uint8_t *rom_pages[2]; // 0x0000-0x3fff and 0x4000-0x7fff
+    const uint8_t *ram_read_page; // 0xa000-0xbfff
+    uint8_t *ram_write_page;
+    uint16_t ram_mask; // Mirrors RAM smaller than a bank, 0 maps every address onto the bytes below while unmapped
+    bool rtc_mapped; // 0xa000-0xbfff shows an RTC register
+    uint8_t open_bus;
+    uint8_t ignored_write;
 };
 
+// Loads the ROM at the path through the ROM cache, NULL creates an empty cartridge without a mapper. Truncated ROMs
+// are refused. Battery backed RAM is mapped from the .sav file next to the ROM, so every write to it is saved
 struct GbCartridge *gb_cartridge_create(const char *rom);
+
+// `save` is the path of the save file, NULL keeps the RAM in memory
+struct GbCartridge *gb_cartridge_create_from_memory(const uint8_t *rom, size_t size, const char *save);
 void gb_cartridge_destroy(struct GbCartridge *);
 
+// Starts writing the save file back to the disk, which otherwise happens whenever the system gets to it
+void gb_cartridge_flush_save(struct GbCartridge *);
+
+// The RTC runs on the guest clock unless told otherwise
+void gb_cartridge_set_rtc_clock(struct GbCartridge *, enum GbRtcClock);
+
+// 0x0000-0x7fff, writes go to the mapper registers
 void gb_cartridge_write(struct GbCartridge *, uint16_t address, uint8_t value);
 uint8_t gb_cartridge_read(struct GbCartridge *, uint16_t address);
 
+// 0xa000-0xbfff - External RAM
+void gb_cartridge_write_ram(struct GbCartridge *, uint16_t address, uint8_t value);
+uint8_t gb_cartridge_read_ram(struct GbCartridge *, uint16_t address);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// The header sits at 0x0100-0x014f of every ROM
+#define GB_CARTRIDGE_HEADER_ADDRESS 0x0100
+#define GB_CARTRIDGE_HEADER_SIZE 0x50
+
+enum GbMapper
+{
+    GB_MAPPER_NONE,
+    GB_MAPPER_MBC1,
+    GB_MAPPER_MBC2,
+    GB_MAPPER_MBC3,
+    GB_MAPPER_MBC5,
+};
+
+enum GbCartridgeHeaderStatus
+{
+    GB_CARTRIDGE_HEADER_VALID,
+    GB_CARTRIDGE_HEADER_TRUNCATED, // The file ends before the header or before the ROM size the header gives
+    GB_CARTRIDGE_HEADER_INVALID_ROM_SIZE,
+};
+
+struct GbCartridgeHeader
+{
+    // Raw fields
+    char title[17]; // 0x0134-0x0143, printable characters up to the first other byte
+    uint8_t cgb_flag; // 0x0143
+    uint8_t type; // 0x0147
+    uint8_t rom_size; // 0x0148
+    uint8_t ram_size; // 0x0149
+    uint8_t header_checksum; // 0x014d
+    uint16_t global_checksum; // 0x014e-0x014f, big endian
+
+    // Derived from the fields above
+    bool cgb; // 0x80 (DMG compatible) or 0xc0 (CGB only), either runs in CGB mode
+    enum GbMapper mapper;
+    bool mapper_supported; // Unknown types fall back to GB_MAPPER_NONE
+    bool battery;
+    bool timer;
+    size_t rom_bytes; // 0 for an unknown ROM size
+    size_t ram_bytes; // RAM the cartridge actually has, MBC2 included
+    bool header_checksum_valid; // The boot ROM refuses to start a cartridge that fails it
+};
+
+// `bytes` holds the GB_CARTRIDGE_HEADER_SIZE bytes starting at GB_CARTRIDGE_HEADER_ADDRESS
+void gb_cartridge_header_parse(struct GbCartridgeHeader *, const uint8_t *bytes);
+
+// Checks the header against the size of the whole ROM file
+enum GbCartridgeHeaderStatus gb_cartridge_header_validate(const struct GbCartridgeHeader *, size_t file_size);
+
+// Sum of every ROM byte except the checksum itself, hardware never checks it
+uint16_t gb_cartridge_compute_global_checksum(const uint8_t *rom, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
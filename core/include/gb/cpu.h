@@ -117,6 +117,12 @@ struct GbCpu
 
     uint8_t interrupt_enable; // IE
     uint8_t interrupt_flag; // IF
+
+    // CGB speed, 0xff4d - KEY1. Double speed runs an M-cycle in 2 master cycles instead of 4
+    bool double_speed;
+    bool speed_switch_armed; // The next STOP switches the speed
+
+    uint64_t cycles; // Master cycles since power on, the clock the other components catch up to
 };
 
 struct GbCpu *gb_cpu_create(void);
@@ -6,15 +6,26 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gb/boot.h"
+#include "gb/rtc.h"
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+struct GbApu;
 struct GbCartridge;
 struct GbCpu;
+struct GbJoypad;
 struct GbMmu;
 struct GbPpu;
+struct GbScheduler;
+struct GbSerial;
 struct GbTimer;
 
 struct Gb
@@ -24,13 +35,71 @@ struct Gb
     struct GbCpu *cpu;
     struct GbPpu *ppu;
     struct GbTimer *timer;
+    struct GbApu *apu;
+    struct GbJoypad *joypad;
+    struct GbSerial *serial;
+    struct GbScheduler *scheduler;
+
+    bool cgb; // Runs in CGB mode, which the cartridge header asks for
 };
 
+// There are two ways to start, both return NULL if the ROM can't be loaded. gb_create skips the boot ROM and starts the
+// cartridge right away from a table of the state the boot ROM leaves behind, which is the fastest and what batch
+// workloads want
 struct Gb *gb_create(const char *rom);
+
+// Runs `boot_rom` from power on instead, until it unmaps itself by writing to 0xff50. Slower to start, but exact where
+// the table can only approximate, like the timing of the first frame. The boot ROM is copied and has to be
+// GB_BOOT_ROM_DMG_SIZE or GB_BOOT_ROM_CGB_SIZE bytes
+struct Gb *gb_create_with_boot_rom(const char *rom, const uint8_t *boot_rom, size_t size);
 void gb_destroy(struct Gb *);
 
+// Starts writing battery backed RAM to the save file, which is kept up to date by the system anyway and flushed on
+// destruction, so this only narrows what a crash of the whole machine can lose
+void gb_flush_save(struct Gb *);
+
+// The MBC3 clock counts emulated time by default, which keeps fast-forwarding and replays deterministic. The wall clock
+// suits interactive play, it should be selected before running
+void gb_set_rtc_clock(struct Gb *, enum GbRtcClock);
+
+// Every run function executes whole instructions and returns the T-cycles it ran, which can overshoot a budget by
+// the rest of the last instruction
+
+// Runs a fixed budget of GB_FRAME_CYCLES, which does not line up with the frames of the PPU
 void gb_run_frame(struct Gb *);
 
+// Runs until the PPU enters V-Blank, with the LCD off it gives up after two frames' worth of cycles
+uint64_t gb_run_until_vblank(struct Gb *);
+
+uint64_t gb_run_cycles(struct Gb *, uint64_t cycles);
+uint64_t gb_step(struct Gb *);
+
+// Runs until `condition` holds after an instruction or an event, or until `max_cycles` ran
+uint64_t gb_run_until(
+    struct Gb *,
+    bool (*condition)(struct Gb *, void *user_data),
+    void *user_data,
+    uint64_t max_cycles);
+uint64_t gb_run_until_pc(struct Gb *, uint16_t pc, uint64_t max_cycles);
+
+// Queues the pressed buttons (GbButton bits) from the master cycle `cycle` on, safe to call from one thread other than
+// the emulation without locking. Returns false if the queue is full. Inputs are picked up at the start of every run,
+// when the game reads the joypad and at their cycle if they were queued before the run
+bool gb_set_input(struct Gb *, uint8_t buttons, uint64_t cycle);
+
+// Moves up to `size` bytes the game sent over the serial port since the last call into `buffer`, returns how many
+size_t gb_take_serial_output(struct Gb *, uint8_t *buffer, size_t size);
+
+// Searches the serial output that wasn't taken yet, test ROMs print "Passed" or "Failed" there
+bool gb_find_serial_output(struct Gb *, const char *text);
+
+// Moves up to `frames` interleaved 16-bit stereo frames at GB_APU_SAMPLE_RATE into `samples`, returns how many. The
+// APU produces them whenever a run ends or this is called, and keeps the latest GB_APU_BUFFER_FRAMES
+size_t gb_take_audio_samples(struct Gb *, int16_t *samples, size_t frames);
+
+// Called after every finished frame, which gb_ppu_take_frame hands out
+void gb_set_frame_callback(struct Gb *, void (*callback)(void *user_data), void *user_data);
+
 #ifdef __cplusplus
 }
 #endif
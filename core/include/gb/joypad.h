@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct GbCpu;
+struct GbJoypadQueue;
+struct GbScheduler;
+
+// Must be a power of two
+#define GB_JOYPAD_QUEUE_SIZE 256
+
+// Set bits are pressed buttons
+enum GbButton
+{
+    GB_BUTTON_RIGHT = 1 << 0,
+    GB_BUTTON_LEFT = 1 << 1,
+    GB_BUTTON_UP = 1 << 2,
+    GB_BUTTON_DOWN = 1 << 3,
+    GB_BUTTON_A = 1 << 4,
+    GB_BUTTON_B = 1 << 5,
+    GB_BUTTON_SELECT = 1 << 6,
+    GB_BUTTON_START = 1 << 7,
+};
+
+struct GbInput
+{
+    uint8_t buttons;
+    uint64_t cycle; // Master cycle the buttons change at
+};
+
+struct GbJoypad
+{
+    struct GbCpu *cpu;
+    struct GbScheduler *scheduler;
+
+    uint8_t select; // 0xff00 bits 4-5, a cleared bit selects the d-pad or the buttons
+    uint8_t buttons;
+
+    // Lock-free single producer, single consumer queue of inputs, one other thread can push while the emulation runs
+    struct GbJoypadQueue *queue;
+};
+
+struct GbJoypad *gb_joypad_create(void);
+void gb_joypad_destroy(struct GbJoypad *);
+
+// 0xff00 - Joypad
+void gb_joypad_write(struct GbJoypad *, uint8_t value);
+uint8_t gb_joypad_read(struct GbJoypad *);
+
+// Queues a change of the pressed buttons without blocking, returns false if the queue is full. Inputs have to be
+// pushed in cycle order, ones in the past apply as soon as the emulation gets to them
+bool gb_joypad_push(struct GbJoypad *, uint8_t buttons, uint64_t cycle);
+
+// Applies every queued input up to the master cycle `cycles` and schedules the next one, emulation thread only
+void gb_joypad_sync(struct GbJoypad *, uint64_t cycles);
+
+#ifdef __cplusplus
+}
+#endif
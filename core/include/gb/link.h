@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct Gb;
+
+// Window of the socket link if none is given, one byte on the internal clock
+#define GB_LINK_DEFAULT_WINDOW_CYCLES 4096
+
+enum GbLinkMode
+{
+    GB_LINK_MODE_LOCAL, // Both instances live in this process
+    GB_LINK_MODE_SOCKET, // The partner is another process on the other end of a Unix socket
+};
+
+// Runs linked instances in windows and exchanges their serial bytes at the end of each. Transfers finish at the end of
+// the window they are due in, so the window size trades accuracy for synchronisation overhead
+struct GbLink
+{
+    enum GbLinkMode mode;
+    struct Gb *gbs[2]; // The socket link only has the first one
+    uint64_t bases[2]; // Master cycle of every instance when the link was connected
+    uint64_t cycles; // Cycles run since the link was connected
+    uint64_t window_cycles; // Fixed window of the socket link, local windows also end at every due transfer
+    int socket; // -1 once the partner disconnected
+};
+
+// Bound socket path of the listening end, partners can connect from the moment it exists
+struct GbLinkListener
+{
+    int socket;
+    char *path;
+};
+
+// Connects two instances in the same process, windows end exactly at the transfers so bytes arrive on time
+struct GbLink *gb_link_create_local(struct Gb *, struct Gb *);
+
+// Connects to the partner at the socket path, the listening end waits for it. Both ends have to use the same window,
+// a `window_cycles` of 0 selects GB_LINK_DEFAULT_WINDOW_CYCLES. Returns NULL if the connection fails
+struct GbLink *gb_link_create_socket(struct Gb *, const char *path, bool listen, uint64_t window_cycles);
+
+// Binds the socket path without waiting for a partner yet, so it can connect as soon as this returns. Returns NULL if
+// the path can't be bound
+struct GbLinkListener *gb_link_listen(const char *path);
+
+// Waits for a partner like the listening end of gb_link_create_socket and destroys the listener
+struct GbLink *gb_link_accept(struct GbLinkListener *, struct Gb *, uint64_t window_cycles);
+
+// Unbinds the socket path, for listeners nobody connected to
+void gb_link_listener_destroy(struct GbLinkListener *);
+
+// Disconnects, the instances go back to finishing transfers on their own
+void gb_link_destroy(struct GbLink *);
+
+// Runs every local instance for about `cycles`, returns the cycles the link advanced by
+uint64_t gb_link_run_cycles(struct GbLink *, uint64_t cycles);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -13,26 +15,38 @@ extern "C"
 {
 #endif
 
+struct GbApu;
 struct GbCartridge;
 struct GbCpu;
+struct GbJoypad;
 struct GbPpu;
+struct GbSerial;
 struct GbTimer;
 
 struct GbMmu
 {
+    struct GbApu *apu;
     struct GbCartridge *cartridge;
     struct GbCpu *cpu;
+    struct GbJoypad *joypad;
     struct GbPpu *ppu;
+    struct GbSerial *serial;
     struct GbTimer *timer;
 
+    bool cgb; // Maps the CGB registers
+
+    // Mapped over the cartridge until 0xff50 is written, NULL afterwards or if the boot ROM was skipped
+    uint8_t *boot_rom;
+    size_t boot_rom_size;
+
 #if TESTS_ENABLED
-    uint8_t *memory;
-#else
-    uint8_t *wram;
-    uint8_t *oam;
-    uint8_t *io;
-    uint8_t *hram;
+    uint8_t *memory; // Flat memory in place of the memory map, the I/O page stays reachable through gb_mmu_write_io
 #endif
+    uint8_t *wram; // 8 banks of 4 KiB, the DMG only has the first two
+    uint8_t *wram_bank; // Bank the CPU sees at 0xd000-0xdfff
+    uint8_t wram_bank_index; // 0xff70 - SVBK
+    uint8_t *io; // CGB registers that only hold a value, the rest stays 0xff like unused addresses read
+    uint8_t *hram;
 };
 
 struct GbMmu *gb_mmu_create(void);
@@ -41,6 +55,18 @@ void gb_mmu_destroy(struct GbMmu *);
 void gb_mmu_write(struct GbMmu *, uint16_t address, uint8_t value);
 uint8_t gb_mmu_read(struct GbMmu *, uint16_t address);
 
+// Accesses the I/O page at 0xff00-0xff7f, the components catch up first
+void gb_mmu_write_io(struct GbMmu *, uint16_t address, uint8_t value);
+uint8_t gb_mmu_read_io(struct GbMmu *, uint16_t address);
+
+// Copies a boot ROM of GB_BOOT_ROM_DMG_SIZE or GB_BOOT_ROM_CGB_SIZE bytes over the cartridge
+void gb_mmu_map_boot_rom(struct GbMmu *, const uint8_t *boot_rom, size_t size);
+
+void gb_mmu_set_cgb(struct GbMmu *, bool enabled);
+
+// Toggles the CGB speed armed through KEY1, called by STOP
+void gb_mmu_switch_speed(struct GbMmu *);
+
 #ifdef __cplusplus
 }
 #endif
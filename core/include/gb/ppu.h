@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 
+#include "gb/definitions.h"
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -15,6 +18,16 @@ extern "C"
 
 struct GbCpu;
 struct GbMmu;
+struct GbPpuCgb;
+struct GbPpuDeferred;
+struct GbPpuFifo;
+struct GbPpuFrameBuffers;
+struct GbPpuTileMapCache;
+struct GbScheduler;
+
+#define GB_PPU_OBJECT_COUNT 40
+#define GB_PPU_OBJECTS_PER_LINE 10
+#define GB_PPU_DIRTY_WORDS ((GB_SCREEN_HEIGHT + 63) / 64)
 
 enum GbColor
 {
@@ -32,13 +45,57 @@ enum GbPpuMode
     GB_PPU_MODE_VBLANK,
 };
 
+enum GbPpuRenderer
+{
+    GB_PPU_RENDERER_SCANLINE, // Draws whole lines at the start of H-Blank, the fast default
+    GB_PPU_RENDERER_FIFO, // Emulates the pixel fetcher and FIFOs dot by dot
+    GB_PPU_RENDERER_DEFERRED, // Records every line and draws the whole frame on worker threads at V-Blank
+};
+
+// Decides which frames are drawn into the screen, skipped frames keep all timing and interrupts
+enum GbPpuRenderPolicy
+{
+    GB_PPU_RENDER_ALWAYS,
+    GB_PPU_RENDER_EVERY_NTH,
+    GB_PPU_RENDER_ON_REQUEST, // Draws the next frame after gb_ppu_request_frame
+    GB_PPU_RENDER_NEVER,
+};
+
+enum GbPpuCompositor
+{
+    GB_PPU_COMPOSITOR_SCALAR,
+    GB_PPU_COMPOSITOR_SSE2,
+    GB_PPU_COMPOSITOR_AVX2,
+};
+
+// Layout of a byte in GbPpuLine::obj
+#define GB_OBJ_PIXEL_COLOR_MASK 0b0011
+#define GB_OBJ_PIXEL_PALETTE 0b0100 // Set if the pixel uses OBP1
+#define GB_OBJ_PIXEL_BG_PRIORITY 0b1000 // Set if BG colors 1-3 are drawn over the pixel
+#define GB_OBJ_PIXEL_CGB_PALETTE_SHIFT 4 // CGB palette (0-7) in bits 4-6
+
+// Layout of a byte in GbPpuLine::bg in CGB mode, the DMG only stores the color index
+#define GB_BG_PIXEL_COLOR_MASK 0b0011
+#define GB_BG_PIXEL_PALETTE_SHIFT 2 // CGB palette (0-7) in bits 2-4
+#define GB_BG_PIXEL_PRIORITY 0b10000000 // Set if colors 1-3 are drawn over every object
+
+// The layers of one scanline before they are mixed together
+struct GbPpuLine
+{
+    uint8_t bg[GB_SCREEN_WIDTH]; // BG/Window color index (0-3)
+    uint8_t obj[GB_SCREEN_WIDTH]; // OBJ color index and attributes, 0 is transparent
+};
+
 struct GbPpu
 {
     struct GbMmu *mmu;
     struct GbCpu *cpu;
+    struct GbScheduler *scheduler;
 
     // Memory
-    uint8_t *vram;
+    uint8_t *vram; // Bank 0, the only one on the DMG
+    uint8_t *vram_bank; // Bank the CPU sees at 0x8000-0x9fff
+    uint8_t *oam;
 
     // Registers
     uint8_t lcd_control; // 0xff40 - LCD control
@@ -56,8 +113,53 @@ struct GbPpu
     // Others
     uint16_t dots_counter;
     enum GbPpuMode mode;
+    bool stat_line; // All enabled STAT interrupt sources combined, the interrupt fires on its rising edge
+
+    // Catch-up
+    uint64_t cycles; // Master cycle the PPU has run up to
+    uint64_t next_interrupt; // Earliest master cycle the PPU can request an interrupt at
+
+    // Rendering
+    enum GbPpuRenderer renderer;
+    struct GbPpuFifo *fifo;
+    struct GbPpuDeferred *deferred; // Created once the deferred renderer is selected
+    enum GbPpuCompositor compositor;
+    struct GbPpuLine line;
+    struct GbPpuTileMapCache *tile_map_cache; // Optional, NULL unless enabled
+    struct GbPpuCgb *cgb; // CGB mode state, NULL on the DMG
+
+    // Frame skipping
+    enum GbPpuRenderPolicy render_policy;
+    uint32_t render_interval; // Distance between drawn frames for GB_PPU_RENDER_EVERY_NTH
+    uint32_t frame_counter; // Frames started since the policy was set
+    bool frame_requested;
+    bool render_frame; // The current frame is drawn into the screen
+    uint64_t vblank_count; // V-Blanks entered since power on, drawn or not
 
-    enum GbColor *screen;
+    // Dirty tracking, every drawn line is compared against a packed copy of what it showed before
+    uint8_t line_shades[GB_SCREEN_HEIGHT][GB_SCREEN_WIDTH / 4];
+    uint64_t dirty_lines[GB_PPU_DIRTY_WORDS]; // Lines that changed during the current frame
+
+    // Window
+    bool window_triggered; // LY matched WY during this frame
+    uint8_t window_line; // Internal line counter, only advances on lines that showed the window
+
+    // Objects bucketed by the lines they cover, rebuilt after OAM or the object size changed
+    bool object_cache_dirty;
+    uint8_t object_cache_height;
+    uint8_t object_cache_counts[GB_SCREEN_HEIGHT];
+    uint8_t object_cache[GB_SCREEN_HEIGHT][GB_PPU_OBJECTS_PER_LINE];
+
+    // Objects selected for the current line, in drawing priority order
+    uint8_t line_object_count;
+    uint8_t line_objects[GB_PPU_OBJECTS_PER_LINE];
+
+    // Output, the frontend takes finished frames while the next one is drawn into `screen`. Every pixel holds an
+    // enum GbColor shade, or in CGB mode a 15-bit color with red in bits 0-4, green in bits 5-9 and blue in bits 10-14
+    uint16_t *screen;
+    struct GbPpuFrameBuffers *frame_buffers;
+    void (*frame_callback)(void *user_data);
+    void *frame_callback_data;
 };
 
 struct GbPpu *gb_ppu_create(void);
@@ -66,6 +168,54 @@ void gb_ppu_destroy(struct GbPpu *);
 void gb_ppu_write(struct GbPpu *, uint16_t address, uint8_t value);
 uint8_t gb_ppu_read(struct GbPpu *, uint16_t address);
 
+void gb_ppu_write_oam(struct GbPpu *, uint16_t address, uint8_t value);
+uint8_t gb_ppu_read_oam(struct GbPpu *, uint16_t address);
+
+void gb_ppu_set_lcd_control(struct GbPpu *, uint8_t value);
+void gb_ppu_set_lcd_status(struct GbPpu *, uint8_t value);
+void gb_ppu_set_lyc(struct GbPpu *, uint8_t value);
+
+// Recomputes the mode and coincidence bits of STAT and requests the LCD interrupt on a rising edge
+void gb_ppu_update_stat(struct GbPpu *);
+
+// Moves the PPU event to the next time the PPU can request an interrupt or start an H-Blank DMA
+void gb_ppu_update_next_interrupt(struct GbPpu *);
+
+// Adds the second VRAM bank, color palettes and VRAM DMA. The FIFO and deferred renderers and the tile map cache only
+// know the DMG, so CGB mode always draws with the scanline renderer
+void gb_ppu_set_cgb(struct GbPpu *, bool enabled);
+
+void gb_ppu_set_renderer(struct GbPpu *, enum GbPpuRenderer);
+bool gb_ppu_set_compositor(struct GbPpu *, enum GbPpuCompositor);
+
+// Keeps both tile maps decoded, which turns background and window lines into copies while VRAM stays unchanged
+void gb_ppu_set_tile_map_cache(struct GbPpu *, bool enabled);
+
+void gb_ppu_set_render_policy(struct GbPpu *, enum GbPpuRenderPolicy, uint32_t interval);
+void gb_ppu_request_frame(struct GbPpu *);
+
+// Applies the render policy to the frame starting at LY 0
+void gb_ppu_start_frame(struct GbPpu *);
+
+// Marks `line` dirty if its finished pixels differ from what it showed before
+void gb_ppu_track_line(struct GbPpu *, uint8_t line);
+
+// Counts the V-Blank, hands the drawn frame over and calls the frame callback
+void gb_ppu_finish_frame(struct GbPpu *);
+
+// Called on the emulation thread after every finished frame
+void gb_ppu_set_frame_callback(struct GbPpu *, void (*callback)(void *user_data), void *user_data);
+
+// Returns the latest finished frame if there is a new one and the lines that changed since the last taken frame, the
+// frame stays untouched until the next call, which may come from another thread than the one running the PPU
+const uint16_t *gb_ppu_take_frame(struct GbPpu *, uint64_t lines[GB_PPU_DIRTY_WORDS]);
+
+// Draw LY like the scanline renderer without touching any frame state, the deferred renderer calls them on copies
+void gb_ppu_select_line_objects(struct GbPpu *);
+void gb_ppu_draw_line(struct GbPpu *);
+
+// Runs the PPU up to the master cycle `cycles`, a disabled LCD skips the time without any work
+void gb_ppu_sync(struct GbPpu *, uint64_t cycles);
 void gb_ppu_tick(struct GbPpu *, uint8_t t_cycles);
 
 #ifdef __cplusplus
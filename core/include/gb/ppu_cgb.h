@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gb/definitions.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct GbPpu;
+
+// 8 palettes of 4 little-endian 15-bit colors
+#define GB_PPU_CGB_PALETTE_BYTES 64
+
+// A VRAM DMA block, the CPU stalls this many master cycles per block of either DMA at either speed
+#define GB_PPU_CGB_DMA_BLOCK_SIZE 16
+#define GB_PPU_CGB_DMA_BLOCK_CYCLES 32
+
+struct GbPpuCgb
+{
+    uint8_t vram[0x2000]; // Bank 1, tile attributes and a second set of tiles
+    uint8_t vram_bank; // 0xff4f - VRAM bank
+
+    // 0xff68-0xff6b - Palette RAM, accessed through an index that can increment after every write
+    uint8_t bg_palettes[GB_PPU_CGB_PALETTE_BYTES];
+    uint8_t obj_palettes[GB_PPU_CGB_PALETTE_BYTES];
+    uint8_t bg_palette_index; // BCPS
+    uint8_t obj_palette_index; // OCPS
+
+    // 0xff51-0xff55 - VRAM DMA
+    uint16_t dma_source;
+    uint16_t dma_destination; // Offset into VRAM
+    uint8_t dma_blocks; // Blocks an H-Blank DMA has left
+    bool dma_active; // An H-Blank DMA copies a block at the start of every H-Blank until it runs out
+
+    // Dirty tracking, lines hold colors that don't fit into GbPpu::line_shades
+    uint16_t line_colors[GB_SCREEN_HEIGHT][GB_SCREEN_WIDTH];
+};
+
+struct GbPpuCgb *gb_ppu_cgb_create(void);
+void gb_ppu_cgb_destroy(struct GbPpuCgb *);
+
+// 0xff4f, repoints the bank the CPU sees
+void gb_ppu_cgb_set_vram_bank(struct GbPpu *, uint8_t value);
+uint8_t gb_ppu_cgb_get_vram_bank(struct GbPpu *);
+
+// 0xff68-0xff6b, writes have to come after a sync to the current cycle
+void gb_ppu_cgb_write_palette(struct GbPpu *, uint16_t address, uint8_t value);
+uint8_t gb_ppu_cgb_read_palette(struct GbPpu *, uint16_t address);
+
+// 0xff51-0xff55, writes have to come after a sync to the current cycle. Starting a general purpose DMA copies every
+// block right away and returns the master cycles the CPU stalls for it
+uint32_t gb_ppu_cgb_write_dma(struct GbPpu *, uint16_t address, uint8_t value);
+uint8_t gb_ppu_cgb_read_dma(struct GbPpu *, uint16_t address);
+
+// Copies the next block of a running H-Blank DMA and stalls the CPU for it
+void gb_ppu_cgb_copy_dma_block(struct GbPpu *);
+
+// Draws LY with tile attributes, OAM order object priority and the color palettes
+void gb_ppu_cgb_draw_line(struct GbPpu *);
+
+// Returns true if `line` shows other colors than the last time it was tracked
+bool gb_ppu_cgb_track_line(struct GbPpu *, uint8_t line);
+
+#ifdef __cplusplus
+}
+#endif
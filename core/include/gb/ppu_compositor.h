@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gb/ppu.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+bool gb_ppu_compositor_is_supported(enum GbPpuCompositor);
+enum GbPpuCompositor gb_ppu_compositor_detect(void);
+
+// Mixes the layers of a scanline and applies the palettes, writing GB_SCREEN_WIDTH pixels
+void gb_ppu_compose_line(
+    enum GbPpuCompositor,
+    const struct GbPpuLine *line,
+    uint8_t bgp,
+    uint8_t obp0,
+    uint8_t obp1,
+    uint16_t *output);
+
+#ifdef __cplusplus
+}
+#endif
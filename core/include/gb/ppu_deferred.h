@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gb/ppu.h"
+#include "gb/utils/thread.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define GB_PPU_DEFERRED_THREADS 4
+
+// Registers a line used, captured at the point the scanline renderer would have read them
+struct GbPpuLineState
+{
+    bool recorded;
+
+    // OAM scan
+    uint32_t scan_writes; // Length of the write log when the objects were selected
+    uint8_t scan_lcd_control;
+
+    // Drawing
+    uint32_t draw_writes; // Length of the write log when the line was drawn
+    uint8_t lcd_control;
+    uint8_t scy;
+    uint8_t scx;
+    uint8_t bgp;
+    uint8_t obp0;
+    uint8_t obp1;
+    uint8_t wx;
+    bool window_triggered;
+    uint8_t window_line;
+};
+
+struct GbPpuWrite
+{
+    uint16_t address;
+    uint8_t value;
+    bool oam;
+};
+
+struct GbPpuDeferred;
+
+// Every thread draws a band of lines on its own copy of the PPU, memory included
+struct GbPpuDeferredWorker
+{
+    struct GbPpuDeferred *deferred;
+    struct GbThread thread;
+    uint8_t first_line;
+    uint8_t last_line;
+    struct GbPpu ppu;
+    uint8_t vram[0x2000];
+    uint8_t oam[0xa0];
+};
+
+// State of the deferred renderer, which records the frame and draws all of its lines at V-Blank
+struct GbPpuDeferred
+{
+    bool recording;
+
+    // VRAM and OAM at the start of the frame plus every write since, which replays them for any line
+    uint8_t vram[0x2000];
+    uint8_t oam[0xa0];
+    struct GbPpuWrite *writes;
+    uint32_t write_count;
+    uint32_t write_capacity;
+
+    struct GbPpuLineState lines[GB_SCREEN_HEIGHT];
+
+    // Worker 0 is the calling thread, the others wait for the next frame
+    const struct GbPpu *source;
+    uint32_t worker_count;
+    struct GbPpuDeferredWorker *workers;
+    struct GbMutex mutex;
+    struct GbCondition start;
+    struct GbCondition done;
+    uint32_t generation;
+    uint32_t pending;
+    bool quit;
+};
+
+struct GbPpuDeferred *gb_ppu_deferred_create(uint32_t thread_count);
+void gb_ppu_deferred_destroy(struct GbPpuDeferred *);
+
+// Takes VRAM and OAM of the PPU as the start of a new frame and starts recording
+void gb_ppu_deferred_begin_frame(struct GbPpuDeferred *, const struct GbPpu *);
+
+void gb_ppu_deferred_log_write(struct GbPpuDeferred *, uint16_t address, uint8_t value, bool oam);
+void gb_ppu_deferred_record_scan(struct GbPpuDeferred *, const struct GbPpu *);
+void gb_ppu_deferred_record_line(struct GbPpuDeferred *, const struct GbPpu *);
+
+// Draws every recorded line into the screen of the PPU and stops recording, blocks until all threads are done
+void gb_ppu_deferred_render(struct GbPpuDeferred *, const struct GbPpu *);
+
+#ifdef __cplusplus
+}
+#endif
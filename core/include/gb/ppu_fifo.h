@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gb/ppu.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// State of the dot-by-dot renderer, which emulates the background/window fetcher and both pixel FIFOs
+struct GbPpuFifo
+{
+    uint16_t line_dot;
+
+    // Background FIFO
+    uint8_t bg_pixels[16];
+    uint8_t bg_head;
+    uint8_t bg_count;
+
+    // Object FIFO, the entries use the GbPpuLine::obj layout and slot 0 is shifted out first
+    uint8_t obj_pixels[8];
+
+    // Background/Window fetcher
+    uint8_t fetcher_dots;
+    uint8_t fetcher_x;
+    uint8_t tile_id;
+    uint8_t tile_low;
+    uint8_t tile_high;
+    bool fetching_window;
+    bool window_drawn;
+
+    // Objects found by the OAM scan, sorted by X when drawing starts
+    uint8_t object_count;
+    uint8_t objects[GB_PPU_OBJECTS_PER_LINE];
+    uint16_t objects_fetched;
+    int8_t object_fetch;
+    uint8_t object_fetch_dots;
+
+    uint8_t stall_dots;
+    uint8_t discard;
+    uint8_t lcd_x;
+};
+
+struct GbPpuFifo *gb_ppu_fifo_create(void);
+void gb_ppu_fifo_destroy(struct GbPpuFifo *);
+
+// Restarts the line LY is on, used when switching over from the scanline renderer or enabling the LCD
+void gb_ppu_fifo_restart_line(struct GbPpu *);
+
+void gb_ppu_fifo_advance(struct GbPpu *, uint64_t dots);
+
+#ifdef __cplusplus
+}
+#endif
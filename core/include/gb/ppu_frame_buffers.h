@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gb/ppu.h"
+#include "gb/utils/thread.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Triple buffer between the PPU and the frontend, finished frames change hands by swapping pointers
+struct GbPpuFrameBuffers
+{
+    struct GbMutex mutex;
+    uint16_t *buffers[3];
+
+    uint16_t *ready; // Latest finished frame
+    uint16_t *front; // Frame the frontend took last, the PPU never draws into it
+    bool fresh; // `ready` was not taken yet
+
+    uint64_t dirty_lines[GB_PPU_DIRTY_WORDS]; // Lines that changed since the frontend took a frame
+};
+
+struct GbPpuFrameBuffers *gb_ppu_frame_buffers_create(void);
+void gb_ppu_frame_buffers_destroy(struct GbPpuFrameBuffers *);
+
+// The buffer the first frame is drawn into
+uint16_t *gb_ppu_frame_buffers_get_back(struct GbPpuFrameBuffers *);
+
+// Publishes the finished `back` buffer together with its changed lines and returns the buffer to draw into next
+uint16_t *gb_ppu_frame_buffers_present(
+    struct GbPpuFrameBuffers *,
+    uint16_t *back,
+    const uint64_t dirty_lines[GB_PPU_DIRTY_WORDS]);
+
+// Returns the latest finished frame if it is new, it stays untouched until the next call
+const uint16_t *gb_ppu_frame_buffers_take(struct GbPpuFrameBuffers *, uint64_t dirty_lines[GB_PPU_DIRTY_WORDS]);
+
+#ifdef __cplusplus
+}
+#endif
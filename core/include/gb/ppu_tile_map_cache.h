@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gb/ppu.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define GB_TILE_MAP_SIZE 256
+#define GB_TILE_MAP_TILES 32
+#define GB_TILE_DATA_TILES 384
+
+// Both 256x256 tile maps decoded to color indices, cells are redrawn once their map entry or tile data changed
+struct GbPpuTileMapCache
+{
+    uint8_t pixels[2][GB_TILE_MAP_SIZE][GB_TILE_MAP_SIZE];
+
+    // Tile data index and version every cell was drawn with
+    uint16_t cell_tiles[2][GB_TILE_MAP_TILES][GB_TILE_MAP_TILES];
+    uint32_t cell_versions[2][GB_TILE_MAP_TILES][GB_TILE_MAP_TILES];
+
+    uint32_t tile_versions[GB_TILE_DATA_TILES];
+
+    // Rows are only checked again after a VRAM write or a switch of the addressing mode
+    bool unsigned_tiles;
+    uint64_t generation;
+    uint64_t row_generations[2][GB_TILE_MAP_TILES];
+};
+
+struct GbPpuTileMapCache *gb_ppu_tile_map_cache_create(void);
+void gb_ppu_tile_map_cache_destroy(struct GbPpuTileMapCache *);
+
+// Has to be called for every VRAM write, `address` is relative to 0x8000
+void gb_ppu_tile_map_cache_invalidate(struct GbPpuTileMapCache *, uint16_t address);
+
+// Copies `count` pixels of a tile map row starting at `map_x`, wrapping around the 256 pixel wide map
+void gb_ppu_tile_map_cache_fetch_row(
+    struct GbPpu *,
+    uint32_t tile_map_address,
+    uint8_t map_x,
+    uint8_t map_y,
+    uint32_t count,
+    uint8_t *output);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct GbMappedFile;
+
+// A ROM shared by every cartridge loaded from the same file or from a file with the same contents
+struct GbRom
+{
+    char *path;
+    uint64_t hash; // FNV-1a of the file contents
+    size_t file_size;
+
+    const uint8_t *data;
+    size_t size; // Padded like gb_rom_padded_size, the padding reads as 0xff
+
+    // Only one of them is set, files with the padded size are used as mapped
+    struct GbMappedFile *file;
+    uint8_t *copy;
+
+    uint32_t references;
+    struct GbRom *next;
+};
+
+// Two banks at least, grown to a power of two so bank numbers wrap with a mask
+size_t gb_rom_padded_size(size_t size);
+
+// Maps the ROM read-only on first use and hands out the same pages to every later caller, thread-safe
+const struct GbRom *gb_rom_cache_acquire(const char *path);
+void gb_rom_cache_release(const struct GbRom *);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gb/cartridge_header.h"
+#include "gb/utils/filesystem.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct GbRomLibraryEntry
+{
+    char *path;
+    struct GbFileInfo file;
+    uint8_t header_bytes[GB_CARTRIDGE_HEADER_SIZE]; // All the index file keeps, parsed again on load
+    struct GbCartridgeHeader header;
+    enum GbCartridgeHeaderStatus status;
+};
+
+// Every .gb and .gbc file below a directory with its header
+struct GbRomLibrary
+{
+    struct GbRomLibraryEntry *entries; // Sorted by path
+    size_t count;
+    size_t capacity;
+    size_t scanned_count; // Entries whose header was read from the ROM, the others came from the index file
+};
+
+// Reads the headers of new or changed ROMs on `thread_count` threads, unchanged ones are taken from the index file,
+// which is written back afterwards. `index` may be NULL to scan everything without caching
+struct GbRomLibrary *gb_rom_library_create(const char *directory, const char *index, uint32_t thread_count);
+void gb_rom_library_destroy(struct GbRomLibrary *);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Size of the clock state appended to the save file, the layout most emulators share
+#define GB_RTC_SAVE_SIZE 48
+
+enum GbRtcClock
+{
+    GB_RTC_CLOCK_GUEST, // Counts master cycles, so it runs with the emulation at any speed and replays exactly
+    GB_RTC_CLOCK_WALL, // Follows the host clock and catches up on the time the game was not running
+};
+
+enum GbRtcRegister
+{
+    GB_RTC_SECONDS,
+    GB_RTC_MINUTES,
+    GB_RTC_HOURS,
+    GB_RTC_DAY_LOW,
+    GB_RTC_DAY_HIGH, // Bit 0 is day bit 8, bit 6 halts the clock, bit 7 is the day counter carry
+    GB_RTC_REGISTER_COUNT,
+};
+
+// MBC3 real-time clock, the counters are only brought up to date when the game latches or writes them
+struct GbRtc
+{
+    enum GbRtcClock clock;
+    uint8_t registers[GB_RTC_REGISTER_COUNT]; // Counters as of `cycles`
+    uint8_t latched[GB_RTC_REGISTER_COUNT]; // What the game reads
+    uint8_t latch_value; // Last write to 0x6000-0x7fff, going from 0x00 to 0x01 latches
+
+    uint64_t cycles; // Master cycle the counters were last brought up to date at, minus the started second
+    int64_t wall_time; // Host time in seconds the counters were last brought up to date at, only for GB_RTC_CLOCK_WALL
+};
+
+struct GbRtc *gb_rtc_create(void);
+void gb_rtc_destroy(struct GbRtc *);
+
+// The guest clock never asks the host for the time, switching to the wall clock catches up from the time stamp of the
+// loaded save
+void gb_rtc_set_clock(struct GbRtc *, enum GbRtcClock, uint64_t cycles);
+
+// Advances the counters to the master cycle `cycles`
+void gb_rtc_update(struct GbRtc *, uint64_t cycles);
+
+void gb_rtc_write_latch(struct GbRtc *, uint64_t cycles, uint8_t value);
+void gb_rtc_write(struct GbRtc *, uint64_t cycles, enum GbRtcRegister, uint8_t value);
+
+void gb_rtc_save(const struct GbRtc *, uint8_t data[GB_RTC_SAVE_SIZE]);
+void gb_rtc_load(struct GbRtc *, const uint8_t data[GB_RTC_SAVE_SIZE], uint64_t cycles);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+enum GbEvent
+{
+    GB_EVENT_PPU, // The PPU can request an interrupt
+    GB_EVENT_TIMER, // TIMA overflows
+    GB_EVENT_JOYPAD, // A queued input is due
+    GB_EVENT_SERIAL, // A transfer finishes
+    GB_EVENT_RUN_END, // The running gb_run_* call used up its cycles
+
+    GB_EVENT_COUNT,
+};
+
+struct GbSchedulerEntry
+{
+    uint64_t deadline;
+    enum GbEvent event;
+};
+
+// Min-heap of the master cycles components have to run at, every event is scheduled at most once
+struct GbScheduler
+{
+    struct GbSchedulerEntry heap[GB_EVENT_COUNT];
+    uint32_t count;
+    uint32_t positions[GB_EVENT_COUNT]; // Heap index of every event, UINT32_MAX if it is not scheduled
+};
+
+struct GbScheduler *gb_scheduler_create(void);
+void gb_scheduler_destroy(struct GbScheduler *);
+
+// Moves an already scheduled event, a deadline of UINT64_MAX cancels it
+void gb_scheduler_schedule(struct GbScheduler *, enum GbEvent, uint64_t deadline);
+void gb_scheduler_cancel(struct GbScheduler *, enum GbEvent);
+
+// UINT64_MAX if nothing is scheduled
+uint64_t gb_scheduler_get_next_deadline(struct GbScheduler *);
+
+// Removes the earliest event if it is due at `cycles`
+bool gb_scheduler_pop(struct GbScheduler *, uint64_t cycles, enum GbEvent *event);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct GbCpu;
+struct GbScheduler;
+
+// Must be a power of two
+#define GB_SERIAL_OUTPUT_SIZE 4096
+
+// 8 bits at 8192 Hz on the internal clock, the CGB can double it with double speed and go 32 times faster with SC bit 1
+#define GB_SERIAL_TRANSFER_CYCLES (8 * 512)
+
+struct GbSerial
+{
+    struct GbCpu *cpu;
+    struct GbScheduler *scheduler;
+
+    // Registers
+    uint8_t sb; // 0xff01 - Serial transfer data
+    uint8_t sc; // 0xff02 - Serial transfer control
+
+    // Transfer
+    uint64_t transfer_end; // Master cycle the running transfer finishes at, UINT64_MAX if there is none
+    bool linked; // A link cable finishes transfers instead of the serial unit
+    bool cgb; // Enables the fast clock
+
+    // Ring buffer of every byte sent, the oldest bytes are overwritten once the host falls behind
+    uint8_t output[GB_SERIAL_OUTPUT_SIZE];
+    uint64_t output_head; // Bytes sent since power on
+    uint64_t output_tail; // Bytes taken by the host
+};
+
+struct GbSerial *gb_serial_create(void);
+void gb_serial_destroy(struct GbSerial *);
+
+// 0xff01 - Serial transfer data
+void gb_serial_set_sb(struct GbSerial *, uint8_t value);
+
+// 0xff02 - Serial transfer control, starting a transfer records SB in the output
+void gb_serial_set_sc(struct GbSerial *, uint8_t value);
+uint8_t gb_serial_get_sc(struct GbSerial *);
+
+// Finishes the running transfer if it is due at the master cycle `cycles`. Without a link partner the bits shifted in
+// are all set, and transfers on the external clock never finish
+void gb_serial_sync(struct GbSerial *, uint64_t cycles);
+
+// Hands the transfers over to a link cable or back to the serial unit
+void gb_serial_set_linked(struct GbSerial *, bool linked);
+
+// Shifts in the byte the partner sent, a transfer that was started ends with the serial interrupt
+void gb_serial_receive(struct GbSerial *, uint8_t value);
+
+// Copies up to `size` of the bytes sent since the last call into `buffer` and removes them, returns how many
+size_t gb_serial_take_output(struct GbSerial *, uint8_t *buffer, size_t size);
+
+// Searches the bytes that weren't taken yet for `text`, which is handy for test ROMs that report over the serial port
+bool gb_serial_find_output(const struct GbSerial *, const char *text);
+
+#ifdef __cplusplus
+}
+#endif
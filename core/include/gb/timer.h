@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -14,16 +15,21 @@ extern "C"
 #endif
 
 struct GbCpu;
+struct GbScheduler;
 
+// DIV and TIMA are derived from the master clock, so the timer only has to run when TIMA can overflow
 struct GbTimer
 {
     struct GbCpu *cpu;
+    struct GbScheduler *scheduler;
 
-    uint16_t div_counter;
-    uint16_t counter;
+    // Catch-up
+    uint64_t cycles; // Master cycle the timer has run up to
+    uint64_t next_interrupt; // Master cycle of the next TIMA overflow
+    uint64_t div_base; // Master cycle the 16-bit system counter behind DIV was last reset at
+    uint8_t speed_shift; // 1 in CGB double speed, where the system counter counts two steps per master cycle
 
     // Registers
-    uint8_t div; // 0xff04 - Divider register
     uint8_t tima; // 0xff05 - Timer counter
     uint8_t tma; // 0xff06 - Timer modulo
     uint8_t tac; // 0xff07 - Timer control
@@ -32,6 +38,23 @@ struct GbTimer
 struct GbTimer *gb_timer_create(void);
 void gb_timer_destroy(struct GbTimer *);
 
+// 0xff04 - Divider register, the upper byte of the system counter
+uint8_t gb_timer_get_div(struct GbTimer *);
+
+// Writes have to come after a sync to the current cycle, resetting DIV or changing TAC can step TIMA
+void gb_timer_reset_div(struct GbTimer *);
+void gb_timer_set_tima(struct GbTimer *, uint8_t value);
+void gb_timer_set_tma(struct GbTimer *, uint8_t value);
+void gb_timer_set_tac(struct GbTimer *, uint8_t value);
+
+// Sets the system counter behind DIV without the falling edge a reset can cause, the boot ROM leaves it running
+void gb_timer_set_system_counter(struct GbTimer *, uint16_t counter);
+
+// Switches the CGB speed, which resets DIV like the STOP instruction that does it. Has to come after a sync
+void gb_timer_set_double_speed(struct GbTimer *, bool enabled);
+
+// Runs the timer up to the master cycle `cycles` in constant time
+void gb_timer_sync(struct GbTimer *, uint64_t cycles);
 void gb_timer_tick(struct GbTimer *, uint8_t t_cycles);
 
 #ifdef __cplusplus
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#if !defined(_WIN32)
+#    include <stdatomic.h>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Atomic size on <stdatomic.h> or the Win32 interlocked functions, as MSVC only has the former in C with
+// /experimental:c11atomics. Loads acquire and stores release, which is all the single producer queues need
+struct GbAtomic
+{
+#if defined(_WIN32)
+    void *volatile value;
+#else
+    atomic_size_t value;
+#endif
+};
+
+// Sets the value before any other thread sees the atomic
+void gb_atomic_init(struct GbAtomic *, size_t value);
+
+size_t gb_atomic_load(struct GbAtomic *);
+void gb_atomic_store(struct GbAtomic *, size_t value);
+
+// Returns the value before the addition
+size_t gb_atomic_fetch_add(struct GbAtomic *, size_t value);
+
+#ifdef __cplusplus
+}
+#endif
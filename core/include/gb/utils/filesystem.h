@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct GbFileInfo
+{
+    uint64_t size;
+    int64_t modified; // Nanoseconds since an epoch that only has to stay the same across runs
+};
+
+bool gb_file_get_info(const char *path, struct GbFileInfo *);
+
+// Calls `callback` for every regular file in `directory` and all directories below it, without following links to
+// directories
+bool gb_directory_walk(const char *directory, void (*callback)(const char *path, void *user_data), void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// A file mapped into memory, writes to a writable mapping end up in the file without any explicit save
+struct GbMappedFile
+{
+    uint8_t *data;
+    size_t size;
+    bool writable;
+
+#if defined(_WIN32)
+    void *file;
+    void *mapping;
+#else
+    int descriptor;
+#endif
+};
+
+// Maps the first `size` bytes of the file for reading and writing, a missing or shorter file is extended with zeros
+struct GbMappedFile *gb_mapped_file_create(const char *path, size_t size);
+struct GbMappedFile *gb_mapped_file_create_read_only(const char *path);
+
+// Writes the changed pages of a writable mapping back before unmapping
+void gb_mapped_file_destroy(struct GbMappedFile *);
+
+// Starts writing the changed pages back, `wait` blocks until they reached the disk
+void gb_mapped_file_flush(struct GbMappedFile *, bool wait);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#if !defined(_WIN32)
+#    include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Threads, mutexes and condition variables on pthreads or Win32, as <threads.h> is missing on macOS and older MSVC.
+// The Win32 objects are all pointer sized, so they are stored as pointers to keep <windows.h> out of the headers
+struct GbThread
+{
+#if defined(_WIN32)
+    void *handle;
+#else
+    pthread_t handle;
+#endif
+};
+
+struct GbMutex
+{
+#if defined(_WIN32)
+    void *lock;
+#else
+    pthread_mutex_t lock;
+#endif
+};
+
+struct GbCondition
+{
+#if defined(_WIN32)
+    void *condition;
+#else
+    pthread_cond_t condition;
+#endif
+};
+
+// Initialises a mutex with static storage duration without a call to gb_mutex_init
+#if defined(_WIN32)
+#    define GB_MUTEX_INITIALIZER { 0 }
+#else
+#    define GB_MUTEX_INITIALIZER { PTHREAD_MUTEX_INITIALIZER }
+#endif
+
+// Starts `function` on a new thread, returns false if the thread couldn't be created
+bool gb_thread_create(struct GbThread *, void (*function)(void *argument), void *argument);
+void gb_thread_join(struct GbThread *);
+
+void gb_mutex_init(struct GbMutex *);
+void gb_mutex_destroy(struct GbMutex *);
+void gb_mutex_lock(struct GbMutex *);
+void gb_mutex_unlock(struct GbMutex *);
+
+void gb_condition_init(struct GbCondition *);
+void gb_condition_destroy(struct GbCondition *);
+
+// Unlocks `mutex` while waiting and locks it again before returning, which may happen without a signal
+void gb_condition_wait(struct GbCondition *, struct GbMutex *mutex);
+void gb_condition_signal(struct GbCondition *);
+void gb_condition_broadcast(struct GbCondition *);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,674 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/apu.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gb/timer.h"
+#include "gb/utils/bits.h"
+#include "gb/utils/log.h"
+
+// Register indices relative to 0xff10
+#define NR10 0x00
+#define NR30 0x0a
+#define NR32 0x0c
+#define NR43 0x12
+#define NR50 0x14
+#define NR51 0x15
+#define NR52 0x16
+#define WAVE_RAM 0x20
+
+// Every channel owns five registers starting at NRx0
+#define CHANNEL_REGISTERS 5
+
+// 0.999958 per T-cycle, the charge factor of the output capacitor
+#define HIGH_PASS_CHARGE 0.997316f
+
+#define WAV_HEADER_SIZE 44
+
+// Bits that read back as set, write-only and unused bits read as 1
+static const uint8_t s_read_masks[WAVE_RAM] = {
+    0x80, 0x3f, 0x00, 0xff, 0xbf, // NR10-NR14
+    0xff, 0x3f, 0x00, 0xff, 0xbf, // NR20-NR24
+    0x7f, 0xff, 0x9f, 0xff, 0xbf, // NR30-NR34
+    0xff, 0xff, 0x00, 0x00, 0xbf, // NR40-NR44
+    0x00, 0x00, 0x70, // NR50-NR52
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+// Bit n is the output of duty step n
+static const uint8_t s_duty_patterns[4] = { 0x80, 0x81, 0xe1, 0x7e };
+
+static uint8_t get_register(const struct GbApu *apu, const enum GbApuChannelType type, const uint8_t offset)
+{
+    return apu->registers[type * CHANNEL_REGISTERS + offset];
+}
+
+static bool is_powered(const struct GbApu *apu) { return GB_BIT_CHECK(apu->registers[NR52], 7); }
+
+static uint16_t get_frequency(const struct GbApu *apu, const enum GbApuChannelType type)
+{
+    return (uint16_t) (get_register(apu, type, 3) | ((get_register(apu, type, 4) & 0x07) << 8));
+}
+
+static void update_period(struct GbApu *apu, const enum GbApuChannelType type)
+{
+    struct GbApuChannel *channel = &apu->channels[type];
+    switch (type)
+    {
+    case GB_APU_CHANNEL_SQUARE_1:
+    case GB_APU_CHANNEL_SQUARE_2:
+        channel->period = (uint32_t) (2048 - get_frequency(apu, type)) * 4;
+        break;
+    case GB_APU_CHANNEL_WAVE:
+        channel->period = (uint32_t) (2048 - get_frequency(apu, type)) * 2;
+        break;
+    case GB_APU_CHANNEL_NOISE:
+    {
+        // Shifts of 14 and 15 stop the LFSR
+        const uint8_t nr43 = apu->registers[NR43];
+        const uint8_t shift = nr43 >> 4;
+        const uint32_t divisor = (nr43 & 0x07) == 0 ? 8 : (uint32_t) (nr43 & 0x07) * 16;
+        channel->period = shift >= 14 ? UINT32_MAX : divisor << shift;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static uint8_t get_digital_output(const struct GbApu *apu, const enum GbApuChannelType type)
+{
+    const struct GbApuChannel *channel = &apu->channels[type];
+    switch (type)
+    {
+    case GB_APU_CHANNEL_SQUARE_1:
+    case GB_APU_CHANNEL_SQUARE_2:
+    {
+        const uint8_t pattern = s_duty_patterns[get_register(apu, type, 1) >> 6];
+        return GB_BIT_CHECK(pattern, channel->position) ? channel->volume : 0;
+    }
+    case GB_APU_CHANNEL_WAVE:
+    {
+        // Output levels 1-3 shift the sample right by 0-2, level 0 mutes
+        const uint8_t byte = apu->registers[WAVE_RAM + channel->position / 2];
+        const uint8_t sample = (channel->position & 1) != 0 ? byte & 0x0f : byte >> 4;
+        const uint8_t level = (apu->registers[NR32] >> 5) & 0x03;
+        return level == 0 ? 0 : (uint8_t) (sample >> (level - 1));
+    }
+    case GB_APU_CHANNEL_NOISE:
+        return (apu->lfsr & 1) == 0 ? channel->volume : 0;
+    default:
+        return 0;
+    }
+}
+
+static void update_level(struct GbApu *apu, const enum GbApuChannelType type)
+{
+    struct GbApuChannel *channel = &apu->channels[type];
+    if (!channel->enabled || !channel->dac_enabled)
+    {
+        channel->level = 0;
+        return;
+    }
+
+    // The DAC maps 0-15 linearly onto its whole range
+    channel->level = (int8_t) (get_digital_output(apu, type) * 2 - 15);
+}
+
+static void disable_channel(struct GbApu *apu, const enum GbApuChannelType type)
+{
+    apu->channels[type].enabled = false;
+    update_level(apu, type);
+}
+
+static void step_waveform(struct GbApu *apu, const enum GbApuChannelType type)
+{
+    struct GbApuChannel *channel = &apu->channels[type];
+    switch (type)
+    {
+    case GB_APU_CHANNEL_SQUARE_1:
+    case GB_APU_CHANNEL_SQUARE_2:
+        channel->position = (channel->position + 1) & 0x07;
+        break;
+    case GB_APU_CHANNEL_WAVE:
+        channel->position = (channel->position + 1) & 0x1f;
+        break;
+    case GB_APU_CHANNEL_NOISE:
+    {
+        // The 7-bit mode feeds the result into bit 6 as well
+        const uint16_t bit = (apu->lfsr ^ (apu->lfsr >> 1)) & 1;
+        apu->lfsr = (uint16_t) ((apu->lfsr >> 1) | (bit << 14));
+        if (GB_BIT_CHECK(apu->registers[NR43], 3))
+        {
+            apu->lfsr = (uint16_t) ((apu->lfsr & ~0x40) | (bit << 6));
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    update_level(apu, type);
+}
+
+// Steps the waveform through the next `cycles` and returns the integral of the DAC output over them
+static int64_t run_channel(struct GbApu *apu, const enum GbApuChannelType type, uint32_t cycles)
+{
+    struct GbApuChannel *channel = &apu->channels[type];
+    if (!channel->enabled)
+    {
+        return 0;
+    }
+
+    if (channel->period == UINT32_MAX)
+    {
+        return (int64_t) channel->level * cycles;
+    }
+
+    int64_t integral = 0;
+    while (cycles >= channel->countdown)
+    {
+        integral += (int64_t) channel->level * channel->countdown;
+        cycles -= channel->countdown;
+        channel->countdown = channel->period;
+        step_waveform(apu, type);
+    }
+
+    integral += (int64_t) channel->level * cycles;
+    channel->countdown -= cycles;
+    return integral;
+}
+
+static uint16_t calculate_sweep(struct GbApu *apu)
+{
+    const uint8_t nr10 = apu->registers[NR10];
+    const uint16_t delta = apu->sweep_frequency >> (nr10 & 0x07);
+    const uint16_t frequency = GB_BIT_CHECK(nr10, 3) ? (uint16_t) (apu->sweep_frequency - delta)
+                                                     : (uint16_t) (apu->sweep_frequency + delta);
+    if (frequency > 2047)
+    {
+        disable_channel(apu, GB_APU_CHANNEL_SQUARE_1);
+    }
+
+    return frequency;
+}
+
+static void clock_sweep(struct GbApu *apu)
+{
+    if (apu->sweep_timer > 0)
+    {
+        apu->sweep_timer -= 1;
+    }
+
+    if (apu->sweep_timer != 0)
+    {
+        return;
+    }
+
+    const uint8_t nr10 = apu->registers[NR10];
+    const uint8_t pace = (nr10 >> 4) & 0x07;
+    apu->sweep_timer = pace == 0 ? 8 : pace;
+    if (!apu->sweep_enabled || pace == 0)
+    {
+        return;
+    }
+
+    const uint16_t frequency = calculate_sweep(apu);
+    if (frequency <= 2047 && (nr10 & 0x07) != 0)
+    {
+        apu->sweep_frequency = frequency;
+        apu->registers[NR10 + 3] = (uint8_t) frequency;
+        apu->registers[NR10 + 4] = (uint8_t) ((apu->registers[NR10 + 4] & ~0x07) | (frequency >> 8));
+        update_period(apu, GB_APU_CHANNEL_SQUARE_1);
+
+        // The new frequency is checked for an overflow right away
+        calculate_sweep(apu);
+    }
+}
+
+static void clock_length(struct GbApu *apu, const enum GbApuChannelType type)
+{
+    struct GbApuChannel *channel = &apu->channels[type];
+    if (!channel->length_enabled || channel->length == 0)
+    {
+        return;
+    }
+
+    channel->length -= 1;
+    if (channel->length == 0)
+    {
+        disable_channel(apu, type);
+    }
+}
+
+static void clock_envelope(struct GbApu *apu, const enum GbApuChannelType type)
+{
+    struct GbApuChannel *channel = &apu->channels[type];
+    const uint8_t envelope = get_register(apu, type, 2);
+    const uint8_t pace = envelope & 0x07;
+    if (pace == 0)
+    {
+        return;
+    }
+
+    if (channel->envelope_timer > 0)
+    {
+        channel->envelope_timer -= 1;
+    }
+
+    if (channel->envelope_timer != 0)
+    {
+        return;
+    }
+
+    channel->envelope_timer = pace;
+    if (GB_BIT_CHECK(envelope, 3) && channel->volume < 15)
+    {
+        channel->volume += 1;
+    }
+    else if (!GB_BIT_CHECK(envelope, 3) && channel->volume > 0)
+    {
+        channel->volume -= 1;
+    }
+
+    update_level(apu, type);
+}
+
+static void step_frame_sequencer(struct GbApu *apu)
+{
+    const uint8_t step = apu->frame_sequencer_step;
+    if ((step & 1) == 0)
+    {
+        for (uint32_t type = 0; type < GB_APU_CHANNEL_COUNT; ++type)
+        {
+            clock_length(apu, (enum GbApuChannelType) type);
+        }
+    }
+
+    if (step == 2 || step == 6)
+    {
+        clock_sweep(apu);
+    }
+
+    if (step == 7)
+    {
+        clock_envelope(apu, GB_APU_CHANNEL_SQUARE_1);
+        clock_envelope(apu, GB_APU_CHANNEL_SQUARE_2);
+        clock_envelope(apu, GB_APU_CHANNEL_NOISE);
+    }
+
+    apu->frame_sequencer_step = (step + 1) & 0x07;
+}
+
+static void trigger(struct GbApu *apu, const enum GbApuChannelType type)
+{
+    struct GbApuChannel *channel = &apu->channels[type];
+    channel->enabled = channel->dac_enabled;
+    if (channel->length == 0)
+    {
+        channel->length = type == GB_APU_CHANNEL_WAVE ? 256 : 64;
+    }
+
+    update_period(apu, type);
+    channel->countdown = channel->period;
+
+    const uint8_t envelope = get_register(apu, type, 2);
+    channel->volume = envelope >> 4;
+    channel->envelope_timer = envelope & 0x07;
+
+    switch (type)
+    {
+    case GB_APU_CHANNEL_SQUARE_1:
+    {
+        const uint8_t nr10 = apu->registers[NR10];
+        const uint8_t pace = (nr10 >> 4) & 0x07;
+        apu->sweep_frequency = get_frequency(apu, type);
+        apu->sweep_timer = pace == 0 ? 8 : pace;
+        apu->sweep_enabled = pace != 0 || (nr10 & 0x07) != 0;
+        if ((nr10 & 0x07) != 0)
+        {
+            calculate_sweep(apu);
+        }
+        break;
+    }
+    case GB_APU_CHANNEL_WAVE:
+        channel->position = 0;
+        break;
+    case GB_APU_CHANNEL_NOISE:
+        apu->lfsr = 0x7fff;
+        break;
+    default:
+        break;
+    }
+
+    update_level(apu, type);
+}
+
+static void write_channel(
+    struct GbApu *apu,
+    const enum GbApuChannelType type,
+    const uint8_t offset,
+    const uint8_t value)
+{
+    struct GbApuChannel *channel = &apu->channels[type];
+    switch (offset)
+    {
+    case 0:
+        // NR30 is the DAC switch of the wave channel, NR10 is read by the sweep directly
+        if (type == GB_APU_CHANNEL_WAVE)
+        {
+            channel->dac_enabled = GB_BIT_CHECK(value, 7);
+        }
+        break;
+    case 1:
+        channel->length = type == GB_APU_CHANNEL_WAVE ? (uint16_t) (256 - value) : (uint16_t) (64 - (value & 0x3f));
+        break;
+    case 2:
+        // The envelope registers switch the DAC off if neither volume nor direction is set
+        if (type != GB_APU_CHANNEL_WAVE)
+        {
+            channel->dac_enabled = (value & 0xf8) != 0;
+        }
+        break;
+    case 3:
+        update_period(apu, type);
+        break;
+    case 4:
+        channel->length_enabled = GB_BIT_CHECK(value, 6);
+        update_period(apu, type);
+        if (GB_BIT_CHECK(value, 7))
+        {
+            trigger(apu, type);
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (!channel->dac_enabled)
+    {
+        channel->enabled = false;
+    }
+
+    update_level(apu, type);
+}
+
+static void set_power(struct GbApu *apu, const bool powered)
+{
+    if (powered == is_powered(apu))
+    {
+        return;
+    }
+
+    // Turning the APU off clears every register but the wave RAM
+    if (!powered)
+    {
+        memset(apu->registers, 0, WAVE_RAM);
+        memset(apu->channels, 0, sizeof(apu->channels));
+        apu->sweep_enabled = false;
+        return;
+    }
+
+    apu->registers[NR52] = 0x80;
+    apu->frame_sequencer_step = 0;
+}
+
+static void write_wav_header(FILE *file, const uint32_t data_size)
+{
+    const uint32_t channels = 2;
+    const uint32_t bytes_per_frame = channels * sizeof(int16_t);
+    const uint32_t fields[] = { 0x46464952, 36 + data_size, 0x45564157, 0x20746d66, 16,
+                                (channels << 16) | 1, GB_APU_SAMPLE_RATE, GB_APU_SAMPLE_RATE * bytes_per_frame,
+                                (16 << 16) | bytes_per_frame, 0x61746164, data_size };
+
+    // RIFF is little-endian no matter the host
+    uint8_t header[WAV_HEADER_SIZE];
+    for (size_t i = 0; i < WAV_HEADER_SIZE; ++i)
+    {
+        header[i] = (uint8_t) (fields[i / 4] >> ((i % 4) * 8));
+    }
+
+    fseek(file, 0, SEEK_SET);
+    fwrite(header, 1, WAV_HEADER_SIZE, file);
+}
+
+// Appends the frames the WAV file is missing, the samples are written as they are on a little-endian host
+static void write_wav(struct GbApu *apu)
+{
+    while (apu->wav_head < apu->sample_head)
+    {
+        const size_t start = (size_t) (apu->wav_head & (GB_APU_BUFFER_FRAMES - 1));
+        const uint64_t available = apu->sample_head - apu->wav_head;
+        const size_t count = (size_t) (available < GB_APU_BUFFER_FRAMES - start ? available
+                                                                                : GB_APU_BUFFER_FRAMES - start);
+        fwrite(&apu->samples[start * 2], sizeof(int16_t) * 2, count, apu->wav);
+        apu->wav_head += count;
+        apu->wav_frames += (uint32_t) count;
+    }
+}
+
+static float high_pass(float *capacitor, const float input)
+{
+    const float output = input - *capacitor;
+    *capacitor = input - output * HIGH_PASS_CHARGE;
+    return output;
+}
+
+static int16_t to_sample(const float value)
+{
+    const float scaled = value * 32767.0f;
+    return (int16_t) (scaled > 32767.0f ? 32767.0f : scaled < -32768.0f ? -32768.0f : scaled);
+}
+
+static void emit_sample(struct GbApu *apu)
+{
+    // Full scale is four channels at 15 with the master volume at 8
+    const uint8_t nr50 = apu->registers[NR50];
+    const float scale = 1.0f / (GB_APU_SAMPLE_CYCLES * 4 * 15 * 8);
+    const float left = (float) apu->sample_left * (float) (((nr50 >> 4) & 0x07) + 1) * scale;
+    const float right = (float) apu->sample_right * (float) ((nr50 & 0x07) + 1) * scale;
+
+    // The recording must not fall a whole buffer behind
+    if (apu->wav && apu->sample_head - apu->wav_head == GB_APU_BUFFER_FRAMES)
+    {
+        write_wav(apu);
+    }
+
+    const size_t index = (size_t) (apu->sample_head & (GB_APU_BUFFER_FRAMES - 1));
+    apu->samples[index * 2] = to_sample(high_pass(&apu->capacitor_left, left));
+    apu->samples[index * 2 + 1] = to_sample(high_pass(&apu->capacitor_right, right));
+    apu->sample_head += 1;
+
+    apu->sample_cycles = 0;
+    apu->sample_left = 0;
+    apu->sample_right = 0;
+}
+
+static void mix_channels(struct GbApu *apu, const uint32_t cycles)
+{
+    const uint8_t nr51 = apu->registers[NR51];
+    for (uint32_t type = 0; type < GB_APU_CHANNEL_COUNT; ++type)
+    {
+        const int64_t integral = run_channel(apu, (enum GbApuChannelType) type, cycles);
+        if (GB_BIT_CHECK(nr51, type + 4))
+        {
+            apu->sample_left += integral;
+        }
+
+        if (GB_BIT_CHECK(nr51, type))
+        {
+            apu->sample_right += integral;
+        }
+    }
+}
+
+struct GbApu *gb_apu_create(void)
+{
+    struct GbApu *apu = calloc(1, sizeof(struct GbApu));
+    apu->timer = NULL;
+    apu->frame_sequencer_step = 0;
+    apu->lfsr = 0x7fff;
+    apu->cycles = 0;
+    apu->wav = NULL;
+
+    // Powered off with every register cleared, the boot ROM turns it on
+    update_period(apu, GB_APU_CHANNEL_NOISE);
+
+    return apu;
+}
+
+void gb_apu_destroy(struct GbApu *apu)
+{
+    gb_apu_stop_wav(apu);
+    free(apu);
+}
+
+void gb_apu_write(struct GbApu *apu, const uint16_t address, const uint8_t value)
+{
+    const uint8_t index = (uint8_t) (address - 0xff10);
+    if (index >= WAVE_RAM)
+    {
+        apu->registers[index] = value;
+        update_level(apu, GB_APU_CHANNEL_WAVE);
+        return;
+    }
+
+    if (index == NR52)
+    {
+        set_power(apu, GB_BIT_CHECK(value, 7));
+        return;
+    }
+
+    // FIXME: The length timers stay writable while the APU is off on the DMG
+    if (!is_powered(apu) || index > NR52)
+    {
+        return;
+    }
+
+    apu->registers[index] = value;
+    if (index < NR50)
+    {
+        write_channel(apu, (enum GbApuChannelType) (index / CHANNEL_REGISTERS), index % CHANNEL_REGISTERS, value);
+    }
+}
+
+uint8_t gb_apu_read(struct GbApu *apu, const uint16_t address)
+{
+    const uint8_t index = (uint8_t) (address - 0xff10);
+    if (index >= WAVE_RAM)
+    {
+        return apu->registers[index];
+    }
+
+    if (index == NR52)
+    {
+        uint8_t status = (uint8_t) ((apu->registers[NR52] & 0x80) | s_read_masks[NR52]);
+        for (uint32_t type = 0; type < GB_APU_CHANNEL_COUNT; ++type)
+        {
+            if (apu->channels[type].enabled)
+            {
+                status |= (uint8_t) (1 << type);
+            }
+        }
+
+        return status;
+    }
+
+    return apu->registers[index] | s_read_masks[index];
+}
+
+void gb_apu_reset_div(struct GbApu *apu)
+{
+    // Clearing the system counter while bit 12 is set is a falling edge
+    if (is_powered(apu) && ((apu->cycles - apu->timer->div_base) & (GB_APU_FRAME_SEQUENCER_CYCLES / 2)) != 0)
+    {
+        step_frame_sequencer(apu);
+    }
+}
+
+void gb_apu_sync(struct GbApu *apu, const uint64_t cycles)
+{
+    while (apu->cycles < cycles)
+    {
+        // Runs to whichever comes first of the target, the next frame sequencer step and the end of the sample
+        const uint64_t counter = (apu->cycles - apu->timer->div_base) % GB_APU_FRAME_SEQUENCER_CYCLES;
+        const uint64_t next_step = apu->cycles + (GB_APU_FRAME_SEQUENCER_CYCLES - counter);
+        uint64_t end = apu->cycles + (GB_APU_SAMPLE_CYCLES - apu->sample_cycles);
+        end = end < next_step ? end : next_step;
+        end = end < cycles ? end : cycles;
+
+        const uint32_t duration = (uint32_t) (end - apu->cycles);
+        mix_channels(apu, duration);
+        apu->cycles = end;
+
+        apu->sample_cycles += duration;
+        if (apu->sample_cycles == GB_APU_SAMPLE_CYCLES)
+        {
+            emit_sample(apu);
+        }
+
+        if (end == next_step && is_powered(apu))
+        {
+            step_frame_sequencer(apu);
+        }
+    }
+
+    if (apu->wav)
+    {
+        write_wav(apu);
+    }
+}
+
+size_t gb_apu_take_samples(struct GbApu *apu, int16_t *samples, const size_t frames)
+{
+    const uint64_t oldest = apu->sample_head > GB_APU_BUFFER_FRAMES ? apu->sample_head - GB_APU_BUFFER_FRAMES : 0;
+    uint64_t index = apu->sample_tail > oldest ? apu->sample_tail : oldest;
+
+    size_t count = 0;
+    for (; index < apu->sample_head && count < frames; ++index, ++count)
+    {
+        const size_t slot = (size_t) (index & (GB_APU_BUFFER_FRAMES - 1));
+        samples[count * 2] = apu->samples[slot * 2];
+        samples[count * 2 + 1] = apu->samples[slot * 2 + 1];
+    }
+
+    apu->sample_tail = index;
+    return count;
+}
+
+bool gb_apu_start_wav(struct GbApu *apu, const char *path)
+{
+    gb_apu_stop_wav(apu);
+
+    apu->wav = fopen(path, "wb");
+    if (apu->wav == NULL)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to create %s\n", path);
+        return false;
+    }
+
+    // The sizes are filled in once the recording stops
+    write_wav_header(apu->wav, 0);
+    apu->wav_head = apu->sample_head;
+    apu->wav_frames = 0;
+    return true;
+}
+
+void gb_apu_stop_wav(struct GbApu *apu)
+{
+    if (apu->wav == NULL)
+    {
+        return;
+    }
+
+    write_wav(apu);
+    write_wav_header(apu->wav, apu->wav_frames * (uint32_t) (sizeof(int16_t) * 2));
+    fclose(apu->wav);
+    apu->wav = NULL;
+}
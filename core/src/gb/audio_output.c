@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/audio_output.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define GB_AUDIO_OUTPUT_SSE2 1
+#    include <emmintrin.h>
+#else
+#    define GB_AUDIO_OUTPUT_SSE2 0
+#endif
+
+#include "gb/utils/atomic.h"
+
+#define PI 3.14159265358979323846
+
+// The first tap of a frame centred on input frame n is n - HALF_TAPS + 1, the last is n + HALF_TAPS
+#define HALF_TAPS (GB_AUDIO_OUTPUT_TAPS / 2)
+
+static_assert(GB_AUDIO_OUTPUT_TAPS % 4 == 0, "The SIMD dot products expect whole vectors of taps");
+
+struct GbAudioOutputQueue
+{
+    int16_t *frames;
+    size_t capacity;
+    struct GbAtomic head; // Next frame the producer writes
+    struct GbAtomic tail; // Next frame the consumer reads
+};
+
+static double sinc(const double x) { return x == 0.0 ? 1.0 : sin(PI * x) / (PI * x); }
+
+// Blackman-windowed sinc, every row sums to 1 so the filter keeps DC as it is
+static void build_coefficients(struct GbAudioOutput *output)
+{
+    // Cut off at the Nyquist frequency of the slower side, in cycles per input frame
+    const double ratio = (double) output->output_rate / (double) output->input_rate;
+    const double cutoff = 0.5 * (ratio < 1.0 ? ratio : 1.0);
+
+    for (uint32_t phase = 0; phase <= GB_AUDIO_OUTPUT_PHASES; ++phase)
+    {
+        const double fraction = (double) phase / GB_AUDIO_OUTPUT_PHASES;
+        float *row = &output->coefficients[phase * GB_AUDIO_OUTPUT_TAPS];
+
+        double taps[GB_AUDIO_OUTPUT_TAPS];
+        double sum = 0.0;
+        for (uint32_t tap = 0; tap < GB_AUDIO_OUTPUT_TAPS; ++tap)
+        {
+            const double distance = (double) tap - (HALF_TAPS - 1) - fraction;
+            const double window_position = (distance + HALF_TAPS) / GB_AUDIO_OUTPUT_TAPS;
+            const double window
+                = 0.42 - 0.5 * cos(2.0 * PI * window_position) + 0.08 * cos(4.0 * PI * window_position);
+            taps[tap] = 2.0 * cutoff * sinc(2.0 * cutoff * distance) * window;
+            sum += taps[tap];
+        }
+
+        for (uint32_t tap = 0; tap < GB_AUDIO_OUTPUT_TAPS; ++tap)
+        {
+            row[tap] = (float) (taps[tap] / sum);
+        }
+    }
+}
+
+// Filters both channels with two neighbouring phases at once, the caller interpolates between them
+static void filter_frame(
+    const float *left,
+    const float *right,
+    const float *row,
+    const float *next_row,
+    float results[4])
+{
+#if GB_AUDIO_OUTPUT_SSE2
+    __m128 left_sum = _mm_setzero_ps();
+    __m128 left_next_sum = _mm_setzero_ps();
+    __m128 right_sum = _mm_setzero_ps();
+    __m128 right_next_sum = _mm_setzero_ps();
+    for (uint32_t tap = 0; tap < GB_AUDIO_OUTPUT_TAPS; tap += 4)
+    {
+        const __m128 coefficients = _mm_loadu_ps(&row[tap]);
+        const __m128 next_coefficients = _mm_loadu_ps(&next_row[tap]);
+        const __m128 left_samples = _mm_loadu_ps(&left[tap]);
+        const __m128 right_samples = _mm_loadu_ps(&right[tap]);
+        left_sum = _mm_add_ps(left_sum, _mm_mul_ps(left_samples, coefficients));
+        left_next_sum = _mm_add_ps(left_next_sum, _mm_mul_ps(left_samples, next_coefficients));
+        right_sum = _mm_add_ps(right_sum, _mm_mul_ps(right_samples, coefficients));
+        right_next_sum = _mm_add_ps(right_next_sum, _mm_mul_ps(right_samples, next_coefficients));
+    }
+
+    // Transposes the four sums so one addition tree reduces all of them
+    _MM_TRANSPOSE4_PS(left_sum, left_next_sum, right_sum, right_next_sum);
+    const __m128 sums = _mm_add_ps(_mm_add_ps(left_sum, left_next_sum), _mm_add_ps(right_sum, right_next_sum));
+    _mm_storeu_ps(results, sums);
+#else
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        results[i] = 0.0f;
+    }
+
+    for (uint32_t tap = 0; tap < GB_AUDIO_OUTPUT_TAPS; ++tap)
+    {
+        results[0] += left[tap] * row[tap];
+        results[1] += left[tap] * next_row[tap];
+        results[2] += right[tap] * row[tap];
+        results[3] += right[tap] * next_row[tap];
+    }
+#endif
+}
+
+static int16_t to_sample(const float value)
+{
+    const float scaled = value * 32768.0f;
+    return (int16_t) (scaled > 32767.0f ? 32767.0f : scaled < -32768.0f ? -32768.0f : scaled);
+}
+
+// Produces every output frame the history has enough taps for, returns the new head of the queue
+static size_t resample(struct GbAudioOutput *output, const double step, size_t head, const size_t tail)
+{
+    struct GbAudioOutputQueue *queue = output->queue;
+    for (;;)
+    {
+        const size_t base = (size_t) output->position;
+        if (base + HALF_TAPS >= output->history_count)
+        {
+            break;
+        }
+
+        const double phase_position = (output->position - (double) base) * GB_AUDIO_OUTPUT_PHASES;
+        const size_t phase = (size_t) phase_position;
+        const float blend = (float) (phase_position - (double) phase);
+        const float *row = &output->coefficients[phase * GB_AUDIO_OUTPUT_TAPS];
+        const size_t first = base + 1 - HALF_TAPS;
+
+        float results[4];
+        filter_frame(
+            &output->history[0][first],
+            &output->history[1][first],
+            row,
+            row + GB_AUDIO_OUTPUT_TAPS,
+            results);
+
+        output->position += step;
+        if (head - tail == queue->capacity)
+        {
+            output->dropped_frames += 1;
+            continue;
+        }
+
+        int16_t *frame = &queue->frames[(head & (queue->capacity - 1)) * 2];
+        frame[0] = to_sample(results[0] + (results[1] - results[0]) * blend);
+        frame[1] = to_sample(results[2] + (results[3] - results[2]) * blend);
+        head += 1;
+    }
+
+    // Drops the input no future frame reaches back to
+    const size_t first_needed = (size_t) output->position + 1 - HALF_TAPS;
+    const size_t discarded = first_needed < output->history_count ? first_needed : output->history_count;
+    const size_t remaining = output->history_count - discarded;
+    memmove(output->history[0], &output->history[0][discarded], remaining * sizeof(float));
+    memmove(output->history[1], &output->history[1][discarded], remaining * sizeof(float));
+    output->history_count = remaining;
+    output->position -= (double) discarded;
+
+    return head;
+}
+
+struct GbAudioOutput *gb_audio_output_create(const uint32_t input_rate, const uint32_t output_rate, size_t queue_frames)
+{
+    struct GbAudioOutput *output = malloc(sizeof(struct GbAudioOutput));
+    output->input_rate = input_rate;
+    output->output_rate = output_rate;
+    output->step = (double) input_rate / (double) output_rate;
+    output->dynamic_rate = true;
+    output->rate_adjustment = 1.0;
+    output->coefficients = malloc(sizeof(float) * (GB_AUDIO_OUTPUT_PHASES + 1) * GB_AUDIO_OUTPUT_TAPS);
+    build_coefficients(output);
+
+    // Silence in front of the first frame, so the filter has taps to reach back to
+    memset(output->history, 0, sizeof(output->history));
+    output->history_count = HALF_TAPS - 1;
+    output->position = HALF_TAPS - 1;
+
+    size_t capacity = 1;
+    while (capacity < queue_frames)
+    {
+        capacity *= 2;
+    }
+
+    output->queue = malloc(sizeof(struct GbAudioOutputQueue));
+    output->queue->frames = calloc(capacity * 2, sizeof(int16_t));
+    output->queue->capacity = capacity;
+    gb_atomic_init(&output->queue->head, 0);
+    gb_atomic_init(&output->queue->tail, 0);
+    output->dropped_frames = 0;
+
+    return output;
+}
+
+void gb_audio_output_destroy(struct GbAudioOutput *output)
+{
+    free(output->queue->frames);
+    free(output->queue);
+    free(output->coefficients);
+    free(output);
+}
+
+void gb_audio_output_set_dynamic_rate(struct GbAudioOutput *output, const bool enabled)
+{
+    output->dynamic_rate = enabled;
+    output->rate_adjustment = 1.0;
+}
+
+void gb_audio_output_write(struct GbAudioOutput *output, const int16_t *samples, const size_t frames)
+{
+    struct GbAudioOutputQueue *queue = output->queue;
+    size_t head = gb_atomic_load(&queue->head);
+    const size_t tail = gb_atomic_load(&queue->tail);
+
+    // A fuller queue consumes the input faster and produces fewer frames, an emptier one the opposite
+    if (output->dynamic_rate)
+    {
+        const double fill = (double) (head - tail) / (double) queue->capacity;
+        output->rate_adjustment = 1.0 + (2.0 * fill - 1.0) * GB_AUDIO_OUTPUT_MAX_RATE_DEVIATION;
+    }
+
+    const double step = output->step * output->rate_adjustment;
+    for (size_t offset = 0; offset < frames;)
+    {
+        const size_t space = GB_AUDIO_OUTPUT_HISTORY_FRAMES - output->history_count;
+        const size_t count = frames - offset < space ? frames - offset : space;
+        for (size_t i = 0; i < count; ++i)
+        {
+            output->history[0][output->history_count + i] = (float) samples[(offset + i) * 2] / 32768.0f;
+            output->history[1][output->history_count + i] = (float) samples[(offset + i) * 2 + 1] / 32768.0f;
+        }
+
+        output->history_count += count;
+        offset += count;
+        head = resample(output, step, head, tail);
+    }
+
+    gb_atomic_store(&queue->head, head);
+}
+
+size_t gb_audio_output_read(struct GbAudioOutput *output, int16_t *samples, const size_t frames)
+{
+    struct GbAudioOutputQueue *queue = output->queue;
+    const size_t head = gb_atomic_load(&queue->head);
+    size_t tail = gb_atomic_load(&queue->tail);
+
+    size_t count = 0;
+    for (; tail != head && count < frames; ++tail, ++count)
+    {
+        const size_t slot = tail & (queue->capacity - 1);
+        samples[count * 2] = queue->frames[slot * 2];
+        samples[count * 2 + 1] = queue->frames[slot * 2 + 1];
+    }
+
+    gb_atomic_store(&queue->tail, tail);
+    return count;
+}
+
+size_t gb_audio_output_get_queued(const struct GbAudioOutput *output)
+{
+    const size_t tail = gb_atomic_load(&output->queue->tail);
+    const size_t head = gb_atomic_load(&output->queue->head);
+    return head - tail;
+}
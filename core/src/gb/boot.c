@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/boot.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gb/cpu.h"
+#include "gb/gb.h"
+#include "gb/mmu.h"
+#include "gb/ppu.h"
+#include "gb/timer.h"
+
+// The boot ROM hands over on the last V-Blank line, which the hardware already reports as LY 0
+#define HANDOVER_LINE 153
+
+struct GbBootRegister
+{
+    uint16_t address;
+    uint8_t value;
+};
+
+// Written in order, so the APU is powered before its registers are set. Left out are DIV, which can't be set through
+// its register, LY and DMA, which the boot ROM never touches, and the wave RAM, which is random at power on
+static const struct GbBootRegister s_dmg_registers[] = {
+    { 0xff26, 0x80 }, // NR52
+    { 0xff00, 0x30 }, // P1, no button group selected
+    { 0xff01, 0x00 }, // SB
+    { 0xff02, 0x00 }, // SC
+    { 0xff05, 0x00 }, // TIMA
+    { 0xff06, 0x00 }, // TMA
+    { 0xff07, 0x00 }, // TAC
+    { 0xff0f, 0x01 }, // IF, V-Blank is left pending
+    { 0xff10, 0x80 }, // NR10
+    { 0xff11, 0xbf }, // NR11
+    { 0xff12, 0xf3 }, // NR12
+    { 0xff13, 0xc1 }, // NR13
+    { 0xff14, 0x87 }, // NR14, square 1 keeps fading out the sound of the logo
+    { 0xff16, 0x3f }, // NR21
+    { 0xff17, 0x00 }, // NR22
+    { 0xff18, 0x00 }, // NR23
+    { 0xff19, 0x00 }, // NR24
+    { 0xff1a, 0x00 }, // NR30
+    { 0xff1b, 0xff }, // NR31
+    { 0xff1c, 0x00 }, // NR32
+    { 0xff1d, 0x00 }, // NR33
+    { 0xff1e, 0x00 }, // NR34
+    { 0xff20, 0xff }, // NR41
+    { 0xff21, 0x00 }, // NR42
+    { 0xff22, 0x00 }, // NR43
+    { 0xff23, 0x00 }, // NR44
+    { 0xff24, 0x77 }, // NR50
+    { 0xff25, 0xf3 }, // NR51
+    { 0xff40, 0x91 }, // LCDC
+    { 0xff41, 0x00 }, // STAT
+    { 0xff42, 0x00 }, // SCY
+    { 0xff43, 0x00 }, // SCX
+    { 0xff45, 0x00 }, // LYC
+    { 0xff47, 0xfc }, // BGP
+    { 0xff48, 0x00 }, // OBP0, random at power on and never written
+    { 0xff49, 0x00 }, // OBP1, random at power on and never written
+    { 0xff4a, 0x00 }, // WY
+    { 0xff4b, 0x00 }, // WX
+};
+
+// Written after the DMG registers. HDMA1-HDMA5 and the palette RAM are left alone, as writing them starts a DMA or
+// moves the palette index
+static const struct GbBootRegister s_cgb_registers[] = {
+    { 0xff4c, 0x80 }, // KEY0, CGB mode, locked without the boot ROM mapped
+    { 0xff4d, 0x00 }, // KEY1
+    { 0xff4f, 0x00 }, // VBK
+    { 0xff6c, 0x00 }, // OPRI, objects are prioritised by their OAM index
+    { 0xff70, 0x00 }, // SVBK, selects bank 1
+    { 0xff72, 0x00 },
+    { 0xff73, 0x00 },
+    { 0xff74, 0x00 },
+    { 0xff75, 0x00 },
+};
+
+static void write_registers(struct Gb *gb, const struct GbBootRegister *registers, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        gb_mmu_write_io(gb->mmu, registers[i].address, registers[i].value);
+    }
+}
+
+void gb_boot_skip(struct Gb *gb)
+{
+    struct GbCpu *cpu = gb->cpu;
+
+    write_registers(gb, s_dmg_registers, sizeof(s_dmg_registers) / sizeof(s_dmg_registers[0]));
+    if (gb->cgb)
+    {
+        write_registers(gb, s_cgb_registers, sizeof(s_cgb_registers) / sizeof(s_cgb_registers[0]));
+
+        // A = 0x11 tells games they run on a CGB. DIV depends on how long the logo took, which varies with the header
+        cpu->registers.af = 0x1180;
+        cpu->registers.bc = 0x0000;
+        cpu->registers.de = 0xff56;
+        cpu->registers.hl = 0x000d;
+        gb_timer_set_system_counter(gb->timer, 0x1ea0);
+    }
+    else
+    {
+        cpu->registers.af = 0x01b0;
+        cpu->registers.bc = 0x0013;
+        cpu->registers.de = 0x00d8;
+        cpu->registers.hl = 0x014d;
+        gb_timer_set_system_counter(gb->timer, 0xabcc);
+    }
+
+    cpu->registers.sp = 0xfffe;
+    cpu->registers.pc = 0x0100;
+
+    // Enabling the LCD started it at the top of the frame, the boot ROM leaves it near the end of one
+    struct GbPpu *ppu = gb->ppu;
+    ppu->ly = HANDOVER_LINE;
+    ppu->mode = GB_PPU_MODE_VBLANK;
+    ppu->dots_counter = 0;
+    ppu->window_triggered = false;
+    ppu->window_line = 0;
+    gb_ppu_update_stat(ppu);
+    gb_ppu_update_next_interrupt(ppu);
+}
@@ -6,52 +6,358 @@
 
 #include "gb/cartridge.h"
 
-#include <assert.h>
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "gb/cpu.h"
+#include "gb/rom_cache.h"
+#include "gb/rtc.h"
 #include "gb/utils/log.h"
+#include "gb/utils/mapped_file.h"
 
-struct GbCartridge *gb_cartridge_create(const char *rom)
+static uint64_t get_cycles(const struct GbCartridge *cartridge)
 {
-    struct GbCartridge *cartridge = malloc(sizeof(struct GbCartridge));
-    cartridge->rom = NULL;
+    return cartridge->cpu != NULL ? cartridge->cpu->cycles : 0;
+}
+
+static size_t rom_bank_count(const struct GbCartridge *cartridge)
+{
+    return cartridge->rom_size / GB_CARTRIDGE_ROM_BANK_SIZE;
+}
 
-    if (rom != NULL)
+static void map_rom(struct GbCartridge *cartridge, const uint32_t page, const size_t bank)
+{
+    const size_t offset = (bank & (rom_bank_count(cartridge) - 1)) * GB_CARTRIDGE_ROM_BANK_SIZE;
+    cartridge->rom_pages[page] = &cartridge->rom[offset];
+}
+
+static void map_ram(struct GbCartridge *cartridge, const bool mapped, const size_t bank)
+{
+    if (!mapped || !cartridge->ram_enabled || cartridge->ram == NULL)
     {
-        FILE *file = fopen(rom, "rb");
-        if (file == NULL)
-        {
-            gb_log(GB_LOG_ERROR, "Failed to open rom file\n");
-            free(cartridge);
-            return NULL;
-        }
+        cartridge->ram_read_page = &cartridge->open_bus;
+        cartridge->ram_write_page = &cartridge->ignored_write;
+        cartridge->ram_mask = 0;
+        return;
+    }
+
+    // RAM sizes are powers of two, so this wraps the bank and leaves small RAM at offset 0
+    const size_t offset = (bank * GB_CARTRIDGE_RAM_BANK_SIZE) & (cartridge->ram_size - 1);
+    const size_t size = cartridge->ram_size < GB_CARTRIDGE_RAM_BANK_SIZE ? cartridge->ram_size
+                                                                          : GB_CARTRIDGE_RAM_BANK_SIZE;
+    cartridge->ram_read_page = &cartridge->ram[offset];
+    cartridge->ram_write_page = &cartridge->ram[offset];
+    cartridge->ram_mask = (uint16_t) (size - 1);
+}
 
-        fseek(file, 0, SEEK_END);
+// The latched registers are read like RAM, writes go through the clock
+static void map_rtc(struct GbCartridge *cartridge, const uint32_t reg)
+{
+    cartridge->ram_read_page = &cartridge->rtc->latched[reg];
+    cartridge->ram_write_page = &cartridge->ignored_write;
+    cartridge->ram_mask = 0;
+    cartridge->rtc_mapped = true;
+}
 
-        const size_t file_size = ftell(file);
-        if (file_size == 0)
+static void update_pages(struct GbCartridge *cartridge)
+{
+    cartridge->rtc_mapped = false;
+
+    switch (cartridge->header.mapper)
+    {
+    case GB_MAPPER_NONE:
+        map_rom(cartridge, 0, 0);
+        map_rom(cartridge, 1, 1);
+        map_ram(cartridge, true, 0);
+        break;
+    case GB_MAPPER_MBC1:
+    {
+        const size_t upper_bits = (size_t) cartridge->ram_bank << 5;
+        map_rom(cartridge, 0, cartridge->banking_mode ? upper_bits : 0);
+        map_rom(cartridge, 1, upper_bits | cartridge->rom_bank);
+        map_ram(cartridge, true, cartridge->banking_mode ? cartridge->ram_bank : 0);
+        break;
+    }
+    case GB_MAPPER_MBC2:
+        map_rom(cartridge, 0, 0);
+        map_rom(cartridge, 1, cartridge->rom_bank);
+        map_ram(cartridge, true, 0);
+        break;
+    case GB_MAPPER_MBC3:
+        map_rom(cartridge, 0, 0);
+        map_rom(cartridge, 1, cartridge->rom_bank);
+        if (cartridge->ram_bank >= 0x08 && cartridge->ram_bank <= 0x0c && cartridge->rtc != NULL
+            && cartridge->ram_enabled)
         {
-            gb_log(GB_LOG_ERROR, "Failed to get size of rom file\n");
-            fclose(file);
-            free(cartridge);
-            return NULL;
+            map_rtc(cartridge, cartridge->ram_bank - 0x08);
         }
+        else
+        {
+            map_ram(cartridge, cartridge->ram_bank <= 0x03, cartridge->ram_bank);
+        }
+        break;
+    case GB_MAPPER_MBC5:
+        map_rom(cartridge, 0, 0);
+        map_rom(cartridge, 1, cartridge->rom_bank);
+        map_ram(cartridge, true, cartridge->ram_bank);
+        break;
+    }
+}
+
+static void write_mbc1(struct GbCartridge *cartridge, const uint16_t address, const uint8_t value)
+{
+    if (address <= 0x1fff)
+    {
+        cartridge->ram_enabled = (value & 0x0f) == 0x0a;
+    }
+    else if (address <= 0x3fff)
+    {
+        // Bank 0 can't be selected, which also turns 0x20, 0x40 and 0x60 into the bank after them
+        const uint8_t bank = value & 0x1f;
+        cartridge->rom_bank = bank == 0 ? 1 : bank;
+    }
+    else if (address <= 0x5fff)
+    {
+        cartridge->ram_bank = value & 0x03;
+    }
+    else
+    {
+        cartridge->banking_mode = (value & 0x01) != 0;
+    }
+}
+
+static void write_mbc2(struct GbCartridge *cartridge, const uint16_t address, const uint8_t value)
+{
+    if (address > 0x3fff)
+    {
+        return;
+    }
+
+    // Bit 8 of the address decides between the two registers
+    if ((address & 0x0100) == 0)
+    {
+        cartridge->ram_enabled = (value & 0x0f) == 0x0a;
+    }
+    else
+    {
+        const uint8_t bank = value & 0x0f;
+        cartridge->rom_bank = bank == 0 ? 1 : bank;
+    }
+}
 
-        fseek(file, 0, SEEK_SET);
+static void write_mbc3(struct GbCartridge *cartridge, const uint16_t address, const uint8_t value)
+{
+    if (address <= 0x1fff)
+    {
+        cartridge->ram_enabled = (value & 0x0f) == 0x0a;
+    }
+    else if (address <= 0x3fff)
+    {
+        const uint8_t bank = value & 0x7f;
+        cartridge->rom_bank = bank == 0 ? 1 : bank;
+    }
+    else if (address <= 0x5fff)
+    {
+        cartridge->ram_bank = value & 0x0f;
+    }
+    else if (cartridge->rtc != NULL)
+    {
+        gb_rtc_write_latch(cartridge->rtc, get_cycles(cartridge), value);
+    }
+}
 
-        cartridge->rom = malloc(file_size);
+static void write_mbc5(struct GbCartridge *cartridge, const uint16_t address, const uint8_t value)
+{
+    if (address <= 0x1fff)
+    {
+        cartridge->ram_enabled = (value & 0x0f) == 0x0a;
+    }
+    else if (address <= 0x2fff)
+    {
+        cartridge->rom_bank = (uint16_t) ((cartridge->rom_bank & 0x100) | value);
+    }
+    else if (address <= 0x3fff)
+    {
+        cartridge->rom_bank = (uint16_t) ((cartridge->rom_bank & 0xff) | ((value & 0x01) << 8));
+    }
+    else if (address <= 0x5fff)
+    {
+        cartridge->ram_bank = value & 0x0f;
+    }
+}
+
+static bool check_header(const struct GbCartridgeHeader *header, const size_t file_size)
+{
+    switch (gb_cartridge_header_validate(header, file_size))
+    {
+    case GB_CARTRIDGE_HEADER_VALID:
+        break;
+    case GB_CARTRIDGE_HEADER_TRUNCATED:
+        gb_log(GB_LOG_ERROR, "Rom file is truncated\n");
+        return false;
+    case GB_CARTRIDGE_HEADER_INVALID_ROM_SIZE:
+        gb_log(GB_LOG_ERROR, "Invalid rom size 0x%02x\n", header->rom_size);
+        return false;
+    }
 
-        const size_t read_size = fread(cartridge->rom, sizeof(uint8_t), file_size, file);
-        if (read_size != file_size)
+    if (!header->mapper_supported)
+    {
+        gb_log(GB_LOG_WARN, "Unsupported cartridge type 0x%02x, running it without a mapper\n", header->type);
+    }
+
+    if (!header->header_checksum_valid)
+    {
+        gb_log(GB_LOG_WARN, "Header checksum mismatch, real hardware would refuse to start the game\n");
+    }
+
+    return true;
+}
+
+static void create_ram(struct GbCartridge *cartridge, const char *save)
+{
+    // The clock state follows the RAM in the save file
+    const size_t save_size = cartridge->ram_size + (cartridge->rtc != NULL ? GB_RTC_SAVE_SIZE : 0);
+    if (save_size == 0)
+    {
+        return;
+    }
+
+    // Only the pages the game touches are read in, so even large saves load instantly
+    if (cartridge->header.battery && save != NULL)
+    {
+        cartridge->save = gb_mapped_file_create(save, save_size);
+        if (cartridge->save != NULL)
         {
-            gb_log(GB_LOG_ERROR, "Failed to read rom file\n");
-            fclose(file);
-            free(cartridge);
-            return NULL;
+            cartridge->ram = cartridge->ram_size != 0 ? cartridge->save->data : NULL;
+            if (cartridge->rtc != NULL)
+            {
+                gb_rtc_load(cartridge->rtc, &cartridge->save->data[cartridge->ram_size], 0);
+            }
+
+            return;
         }
 
-        fclose(file);
+        gb_log(GB_LOG_WARN, "Failed to map save file, the game won't be saved\n");
+    }
+
+    if (cartridge->ram_size != 0)
+    {
+        cartridge->ram = malloc(cartridge->ram_size);
+        memset(cartridge->ram, 0xff, cartridge->ram_size);
+    }
+}
+
+static void save_rtc(struct GbCartridge *cartridge)
+{
+    if (cartridge->rtc != NULL && cartridge->save != NULL)
+    {
+        gb_rtc_update(cartridge->rtc, get_cycles(cartridge));
+        gb_rtc_save(cartridge->rtc, &cartridge->save->data[cartridge->ram_size]);
+    }
+}
+
+// Replaces the extension of the ROM path with .sav
+static char *create_save_path(const char *rom)
+{
+    const char *extension = strrchr(rom, '.');
+    const char *separator = strrchr(rom, '/');
+    const char *windows_separator = strrchr(rom, '\\');
+    if (extension == NULL || extension < separator || extension < windows_separator)
+    {
+        extension = rom + strlen(rom);
+    }
+
+    const size_t length = (size_t) (extension - rom);
+    char *save = malloc(length + sizeof(".sav"));
+    memcpy(save, rom, length);
+    memcpy(&save[length], ".sav", sizeof(".sav"));
+    return save;
+}
+
+static struct GbCartridge *create_cartridge(
+    const uint8_t *rom,
+    const size_t rom_size,
+    const size_t file_size,
+    const char *save)
+{
+    struct GbCartridge *cartridge = malloc(sizeof(struct GbCartridge));
+    cartridge->rom = rom;
+    cartridge->rom_size = rom_size;
+    cartridge->shared_rom = NULL;
+    cartridge->cpu = NULL;
+    cartridge->ram = NULL;
+    cartridge->ram_size = 0;
+    cartridge->save = NULL;
+    cartridge->ram_enabled = false;
+    cartridge->rom_bank = 1;
+    cartridge->ram_bank = 0;
+    cartridge->banking_mode = false;
+    cartridge->open_bus = 0xff;
+    cartridge->ignored_write = 0xff;
+
+    // An empty cartridge has no header, which leaves it without a mapper or RAM
+    uint8_t blank_header[GB_CARTRIDGE_HEADER_SIZE] = { 0 };
+    gb_cartridge_header_parse(&cartridge->header, file_size == 0 ? blank_header : &rom[GB_CARTRIDGE_HEADER_ADDRESS]);
+    if (file_size != 0 && !check_header(&cartridge->header, file_size))
+    {
+        free(cartridge);
+        return NULL;
+    }
+
+    cartridge->ram_size = cartridge->header.ram_bytes;
+    cartridge->rtc = cartridge->header.mapper == GB_MAPPER_MBC3 && cartridge->header.timer ? gb_rtc_create() : NULL;
+    create_ram(cartridge, save);
+
+    // Without a mapper there is nothing to enable the RAM with
+    cartridge->ram_enabled = cartridge->header.mapper == GB_MAPPER_NONE;
+    update_pages(cartridge);
+
+    return cartridge;
+}
+
+struct GbCartridge *gb_cartridge_create(const char *rom)
+{
+    if (rom == NULL)
+    {
+        return gb_cartridge_create_from_memory(NULL, 0, NULL);
+    }
+
+    const struct GbRom *shared_rom = gb_rom_cache_acquire(rom);
+    if (shared_rom == NULL)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to load rom file\n");
+        return NULL;
+    }
+
+    char *save = create_save_path(rom);
+    struct GbCartridge *cartridge = create_cartridge(shared_rom->data, shared_rom->size, shared_rom->file_size, save);
+    free(save);
+    if (cartridge == NULL)
+    {
+        gb_rom_cache_release(shared_rom);
+        return NULL;
+    }
+
+    cartridge->shared_rom = shared_rom;
+
+    return cartridge;
+}
+
+struct GbCartridge *gb_cartridge_create_from_memory(const uint8_t *rom, const size_t size, const char *save)
+{
+    const size_t rom_size = gb_rom_padded_size(size);
+    uint8_t *data = malloc(rom_size);
+    if (size != 0)
+    {
+        memcpy(data, rom, size);
+    }
+
+    memset(&data[size], 0xff, rom_size - size);
+
+    struct GbCartridge *cartridge = create_cartridge(data, rom_size, size, save);
+    if (cartridge == NULL)
+    {
+        free(data);
     }
 
     return cartridge;
@@ -59,16 +365,92 @@ struct GbCartridge *gb_cartridge_create(const char *rom)
 
 void gb_cartridge_destroy(struct GbCartridge *cartridge)
 {
-    free(cartridge->rom);
+    if (cartridge->save != NULL)
+    {
+        save_rtc(cartridge);
+        gb_mapped_file_destroy(cartridge->save);
+    }
+    else
+    {
+        free(cartridge->ram);
+    }
+
+    if (cartridge->rtc != NULL)
+    {
+        gb_rtc_destroy(cartridge->rtc);
+    }
+
+    if (cartridge->shared_rom != NULL)
+    {
+        gb_rom_cache_release(cartridge->shared_rom);
+    }
+    else
+    {
+        free((uint8_t *) cartridge->rom);
+    }
+
     free(cartridge);
 }
 
+void gb_cartridge_flush_save(struct GbCartridge *cartridge)
+{
+    if (cartridge->save != NULL)
+    {
+        save_rtc(cartridge);
+        gb_mapped_file_flush(cartridge->save, false);
+    }
+}
+
+void gb_cartridge_set_rtc_clock(struct GbCartridge *cartridge, const enum GbRtcClock clock)
+{
+    if (cartridge->rtc != NULL)
+    {
+        gb_rtc_set_clock(cartridge->rtc, clock, get_cycles(cartridge));
+    }
+}
+
 void gb_cartridge_write(struct GbCartridge *cartridge, const uint16_t address, const uint8_t value)
 {
-    // FIXME: Implement Mappers
-    (void) cartridge;
-    (void) address;
-    (void) value;
+    switch (cartridge->header.mapper)
+    {
+    case GB_MAPPER_NONE:
+        return;
+    case GB_MAPPER_MBC1:
+        write_mbc1(cartridge, address, value);
+        break;
+    case GB_MAPPER_MBC2:
+        write_mbc2(cartridge, address, value);
+        break;
+    case GB_MAPPER_MBC3:
+        write_mbc3(cartridge, address, value);
+        break;
+    case GB_MAPPER_MBC5:
+        write_mbc5(cartridge, address, value);
+        break;
+    }
+
+    update_pages(cartridge);
 }
 
-uint8_t gb_cartridge_read(struct GbCartridge *cartridge, const uint16_t address) { return cartridge->rom[address]; }
+uint8_t gb_cartridge_read(struct GbCartridge *cartridge, const uint16_t address)
+{
+    return cartridge->rom_pages[address >> 14][address & 0x3fff];
+}
+
+void gb_cartridge_write_ram(struct GbCartridge *cartridge, const uint16_t address, const uint8_t value)
+{
+    if (cartridge->rtc_mapped)
+    {
+        gb_rtc_write(cartridge->rtc, get_cycles(cartridge), (enum GbRtcRegister) (cartridge->ram_bank - 0x08), value);
+        return;
+    }
+
+    // MBC2 only stores the lower half of each byte, the upper one reads as set
+    const uint8_t stored = cartridge->header.mapper == GB_MAPPER_MBC2 ? (uint8_t) (value | 0xf0) : value;
+    cartridge->ram_write_page[address & cartridge->ram_mask] = stored;
+}
+
+uint8_t gb_cartridge_read_ram(struct GbCartridge *cartridge, const uint16_t address)
+{
+    return cartridge->ram_read_page[address & cartridge->ram_mask];
+}
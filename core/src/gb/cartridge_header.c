@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/cartridge_header.h"
+
+#include <string.h>
+
+// Offsets into the header bytes
+#define TITLE (0x0134 - GB_CARTRIDGE_HEADER_ADDRESS)
+#define TITLE_LENGTH 16
+#define CGB_FLAG (0x0143 - GB_CARTRIDGE_HEADER_ADDRESS)
+#define TYPE (0x0147 - GB_CARTRIDGE_HEADER_ADDRESS)
+#define ROM_SIZE (0x0148 - GB_CARTRIDGE_HEADER_ADDRESS)
+#define RAM_SIZE (0x0149 - GB_CARTRIDGE_HEADER_ADDRESS)
+#define HEADER_CHECKSUM (0x014d - GB_CARTRIDGE_HEADER_ADDRESS)
+#define GLOBAL_CHECKSUM (0x014e - GB_CARTRIDGE_HEADER_ADDRESS)
+
+#define GLOBAL_CHECKSUM_ADDRESS 0x014e
+#define MBC2_RAM_SIZE 0x200
+
+static void parse_type(struct GbCartridgeHeader *header, bool *has_ram)
+{
+    header->mapper_supported = true;
+
+    switch (header->type)
+    {
+    case 0x00:
+        break;
+    case 0x08:
+        *has_ram = true;
+        break;
+    case 0x09:
+        *has_ram = true;
+        header->battery = true;
+        break;
+    case 0x01:
+        header->mapper = GB_MAPPER_MBC1;
+        break;
+    case 0x02:
+        header->mapper = GB_MAPPER_MBC1;
+        *has_ram = true;
+        break;
+    case 0x03:
+        header->mapper = GB_MAPPER_MBC1;
+        *has_ram = true;
+        header->battery = true;
+        break;
+    case 0x05:
+        header->mapper = GB_MAPPER_MBC2;
+        break;
+    case 0x06:
+        header->mapper = GB_MAPPER_MBC2;
+        header->battery = true;
+        break;
+    case 0x0f:
+        header->mapper = GB_MAPPER_MBC3;
+        header->battery = true;
+        header->timer = true;
+        break;
+    case 0x10:
+        header->mapper = GB_MAPPER_MBC3;
+        *has_ram = true;
+        header->battery = true;
+        header->timer = true;
+        break;
+    case 0x11:
+        header->mapper = GB_MAPPER_MBC3;
+        break;
+    case 0x12:
+        header->mapper = GB_MAPPER_MBC3;
+        *has_ram = true;
+        break;
+    case 0x13:
+        header->mapper = GB_MAPPER_MBC3;
+        *has_ram = true;
+        header->battery = true;
+        break;
+    case 0x19:
+    case 0x1c:
+        header->mapper = GB_MAPPER_MBC5;
+        break;
+    case 0x1a:
+    case 0x1d:
+        header->mapper = GB_MAPPER_MBC5;
+        *has_ram = true;
+        break;
+    case 0x1b:
+    case 0x1e:
+        header->mapper = GB_MAPPER_MBC5;
+        *has_ram = true;
+        header->battery = true;
+        break;
+    default:
+        header->mapper_supported = false;
+        break;
+    }
+}
+
+void gb_cartridge_header_parse(struct GbCartridgeHeader *header, const uint8_t *bytes)
+{
+    memset(header, 0, sizeof(struct GbCartridgeHeader));
+
+    for (uint32_t i = 0; i < TITLE_LENGTH; ++i)
+    {
+        const uint8_t character = bytes[TITLE + i];
+        if (character < 0x20 || character > 0x7e)
+        {
+            break;
+        }
+
+        header->title[i] = (char) character;
+    }
+
+    header->cgb_flag = bytes[CGB_FLAG];
+    header->cgb = header->cgb_flag == 0x80 || header->cgb_flag == 0xc0;
+    header->type = bytes[TYPE];
+    header->rom_size = bytes[ROM_SIZE];
+    header->ram_size = bytes[RAM_SIZE];
+    header->header_checksum = bytes[HEADER_CHECKSUM];
+    header->global_checksum = (uint16_t) ((bytes[GLOBAL_CHECKSUM] << 8) | bytes[GLOBAL_CHECKSUM + 1]);
+
+    bool has_ram = false;
+    parse_type(header, &has_ram);
+
+    if (header->rom_size <= 0x08)
+    {
+        header->rom_bytes = (size_t) 0x8000 << header->rom_size;
+    }
+
+    if (header->mapper == GB_MAPPER_MBC2)
+    {
+        // Built into the mapper, 512 half bytes
+        header->ram_bytes = MBC2_RAM_SIZE;
+    }
+    else if (has_ram)
+    {
+        static const size_t s_ram_sizes[] = { 0, 0x800, 0x2000, 0x8000, 0x20000, 0x10000 };
+        if (header->ram_size < sizeof(s_ram_sizes) / sizeof(s_ram_sizes[0]))
+        {
+            header->ram_bytes = s_ram_sizes[header->ram_size];
+        }
+    }
+
+    uint8_t checksum = 0;
+    for (uint32_t i = TITLE; i < HEADER_CHECKSUM; ++i)
+    {
+        checksum = (uint8_t) (checksum - bytes[i] - 1);
+    }
+
+    header->header_checksum_valid = checksum == header->header_checksum;
+}
+
+enum GbCartridgeHeaderStatus gb_cartridge_header_validate(
+    const struct GbCartridgeHeader *header,
+    const size_t file_size)
+{
+    if (file_size < GB_CARTRIDGE_HEADER_ADDRESS + GB_CARTRIDGE_HEADER_SIZE)
+    {
+        return GB_CARTRIDGE_HEADER_TRUNCATED;
+    }
+
+    if (header->rom_bytes == 0)
+    {
+        return GB_CARTRIDGE_HEADER_INVALID_ROM_SIZE;
+    }
+
+    if (file_size < header->rom_bytes)
+    {
+        return GB_CARTRIDGE_HEADER_TRUNCATED;
+    }
+
+    return GB_CARTRIDGE_HEADER_VALID;
+}
+
+uint16_t gb_cartridge_compute_global_checksum(const uint8_t *rom, const size_t size)
+{
+    uint16_t checksum = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (i != GLOBAL_CHECKSUM_ADDRESS && i != GLOBAL_CHECKSUM_ADDRESS + 1)
+        {
+            checksum = (uint16_t) (checksum + rom[i]);
+        }
+    }
+
+    return checksum;
+}
@@ -22,22 +22,13 @@ struct GbCpu *gb_cpu_create(void)
     struct GbCpu *cpu = malloc(sizeof(struct GbCpu));
     cpu->mmu = NULL;
 
-    cpu->registers.a = 0x01;
-    cpu->registers.f = 0x00;
-
-    gb_cpu_set_flag(cpu, GB_FLAG_Z, true);
-    gb_cpu_set_flag(cpu, GB_FLAG_N, false);
-    gb_cpu_set_flag(cpu, GB_FLAG_H, true);
-    gb_cpu_set_flag(cpu, GB_FLAG_C, true);
-
-    cpu->registers.b = 0x00;
-    cpu->registers.c = 0x13;
-    cpu->registers.d = 0x00;
-    cpu->registers.e = 0xd8;
-    cpu->registers.h = 0x01;
-    cpu->registers.l = 0x4d;
-    cpu->registers.pc = 0x0100;
-    cpu->registers.sp = 0xfffe;
+    // Power on state, the boot ROM sets up the rest
+    cpu->registers.af = 0x0000;
+    cpu->registers.bc = 0x0000;
+    cpu->registers.de = 0x0000;
+    cpu->registers.hl = 0x0000;
+    cpu->registers.pc = 0x0000;
+    cpu->registers.sp = 0x0000;
 
     cpu->interrupt_master_enable = false;
     cpu->ime_delay = 0;
@@ -45,6 +36,11 @@ struct GbCpu *gb_cpu_create(void)
     cpu->interrupt_enable = 0;
     cpu->interrupt_flag = 0;
 
+    cpu->double_speed = false;
+    cpu->speed_switch_armed = false;
+
+    cpu->cycles = 0;
+
     return cpu;
 }
 
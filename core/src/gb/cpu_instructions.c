@@ -1146,7 +1146,11 @@ uint8_t cpu_nop(struct GbCpu *cpu)
 /// STOP
 uint8_t cpu_stop(struct GbCpu *cpu)
 {
-    (void) cpu;
-    // FIXME: Implement me
-    return 0;
+    // FIXME: Only the CGB speed switch is implemented, not the low power mode
+    if (cpu->speed_switch_armed)
+    {
+        gb_mmu_switch_speed(cpu->mmu);
+    }
+
+    return 1;
 }
@@ -6,60 +6,276 @@
 
 #include "gb/gb.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
 
+#include "gb/apu.h"
+#include "gb/boot.h"
 #include "gb/cartridge.h"
 #include "gb/cpu.h"
 #include "gb/definitions.h"
+#include "gb/joypad.h"
 #include "gb/mmu.h"
 #include "gb/ppu.h"
+#include "gb/scheduler.h"
+#include "gb/serial.h"
 #include "gb/timer.h"
+#include "gb/utils/log.h"
 
-struct Gb *gb_create(const char *rom)
+// GB_FRAME_CYCLES rounded up, as frames end on the first instruction that reaches it
+#define FRAME_CYCLES ((uint64_t) GB_FRAME_CYCLES + 1)
+
+// Enabling the LCD restarts it on line 0, so V-Blank can be up to two PPU frames away
+#define VBLANK_TIMEOUT_CYCLES (2 * 154 * 456)
+
+static void enable_cgb(struct Gb *gb)
+{
+    gb->cgb = true;
+    gb_mmu_set_cgb(gb->mmu, true);
+    gb_ppu_set_cgb(gb->ppu, true);
+    gb->serial->cgb = true;
+}
+
+static struct Gb *create(const char *rom, const uint8_t *boot_rom, const size_t boot_rom_size)
 {
+    if (boot_rom != NULL && boot_rom_size != GB_BOOT_ROM_DMG_SIZE && boot_rom_size != GB_BOOT_ROM_CGB_SIZE)
+    {
+        gb_log(GB_LOG_ERROR, "Boot ROM has to be 256 or 2304 bytes\n");
+        return NULL;
+    }
+
     struct Gb *gb = malloc(sizeof(struct Gb));
     gb->cartridge = gb_cartridge_create(rom);
+    if (gb->cartridge == NULL)
+    {
+        free(gb);
+        return NULL;
+    }
+
     gb->mmu = gb_mmu_create();
     gb->cpu = gb_cpu_create();
     gb->ppu = gb_ppu_create();
     gb->timer = gb_timer_create();
+    gb->apu = gb_apu_create();
+    gb->joypad = gb_joypad_create();
+    gb->serial = gb_serial_create();
+    gb->scheduler = gb_scheduler_create();
+
+    gb->cartridge->cpu = gb->cpu;
 
+    gb->mmu->apu = gb->apu;
     gb->mmu->cartridge = gb->cartridge;
     gb->mmu->cpu = gb->cpu;
+    gb->mmu->joypad = gb->joypad;
     gb->mmu->ppu = gb->ppu;
+    gb->mmu->serial = gb->serial;
     gb->mmu->timer = gb->timer;
 
     gb->cpu->mmu = gb->mmu;
 
     gb->ppu->mmu = gb->mmu;
     gb->ppu->cpu = gb->cpu;
+    gb->ppu->scheduler = gb->scheduler;
 
     gb->timer->cpu = gb->cpu;
+    gb->timer->scheduler = gb->scheduler;
+
+    gb->apu->timer = gb->timer;
+
+    gb->joypad->cpu = gb->cpu;
+    gb->joypad->scheduler = gb->scheduler;
+
+    gb->serial->cpu = gb->cpu;
+    gb->serial->scheduler = gb->scheduler;
+
+    gb->cgb = false;
+    if (gb->cartridge->header.cgb)
+    {
+        enable_cgb(gb);
+    }
+
+    // The components start in their power on state
+    if (boot_rom != NULL)
+    {
+        gb_mmu_map_boot_rom(gb->mmu, boot_rom, boot_rom_size);
+    }
+    else
+    {
+        gb_boot_skip(gb);
+    }
+
+    // Both components reschedule themselves from here on
+    gb_scheduler_schedule(gb->scheduler, GB_EVENT_PPU, gb->ppu->next_interrupt);
+    gb_scheduler_schedule(gb->scheduler, GB_EVENT_TIMER, gb->timer->next_interrupt);
 
     return gb;
 }
 
+struct Gb *gb_create(const char *rom) { return create(rom, NULL, 0); }
+
+struct Gb *gb_create_with_boot_rom(const char *rom, const uint8_t *boot_rom, const size_t size)
+{
+    return create(rom, boot_rom, size);
+}
+
 void gb_destroy(struct Gb *gb)
 {
+    // Saving brings the RTC up to date with the CPU
+    gb_cartridge_destroy(gb->cartridge);
+    gb_scheduler_destroy(gb->scheduler);
+    gb_serial_destroy(gb->serial);
+    gb_joypad_destroy(gb->joypad);
+    gb_apu_destroy(gb->apu);
     gb_timer_destroy(gb->timer);
     gb_ppu_destroy(gb->ppu);
     gb_cpu_destroy(gb->cpu);
     gb_mmu_destroy(gb->mmu);
-    gb_cartridge_destroy(gb->cartridge);
 
     free(gb);
 }
 
-void gb_run_frame(struct Gb *gb)
+void gb_flush_save(struct Gb *gb) { gb_cartridge_flush_save(gb->cartridge); }
+
+void gb_set_rtc_clock(struct Gb *gb, const enum GbRtcClock clock) { gb_cartridge_set_rtc_clock(gb->cartridge, clock); }
+
+static void step_cpu(struct Gb *gb)
+{
+    // NOTE: The cycles are given as m-cycles
+    const uint8_t m_cycles = gb_cpu_tick(gb->cpu);
+    gb->cpu->cycles += m_cycles * (gb->cpu->double_speed ? 2u : 4u);
+}
+
+// Handles the due events, returns true once the run used up its cycles
+static bool handle_events(struct Gb *gb)
+{
+    bool run_ended = false;
+
+    enum GbEvent event;
+    while (gb_scheduler_pop(gb->scheduler, gb->cpu->cycles, &event))
+    {
+        switch (event)
+        {
+        case GB_EVENT_PPU:
+            gb_ppu_sync(gb->ppu, gb->cpu->cycles);
+            break;
+        case GB_EVENT_TIMER:
+            gb_timer_sync(gb->timer, gb->cpu->cycles);
+            break;
+        case GB_EVENT_JOYPAD:
+            gb_joypad_sync(gb->joypad, gb->cpu->cycles);
+            break;
+        case GB_EVENT_SERIAL:
+            gb_serial_sync(gb->serial, gb->cpu->cycles);
+            break;
+        case GB_EVENT_RUN_END:
+            run_ended = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return run_ended;
+}
+
+// Leaves the components caught up, so their state can be inspected between runs
+static uint64_t finish_run(struct Gb *gb, const uint64_t start)
+{
+    gb_scheduler_cancel(gb->scheduler, GB_EVENT_RUN_END);
+    gb_ppu_sync(gb->ppu, gb->cpu->cycles);
+    gb_timer_sync(gb->timer, gb->cpu->cycles);
+    gb_apu_sync(gb->apu, gb->cpu->cycles);
+
+    return gb->cpu->cycles - start;
+}
+
+uint64_t gb_run_until(
+    struct Gb *gb,
+    bool (*condition)(struct Gb *, void *user_data),
+    void *user_data,
+    const uint64_t max_cycles)
 {
-    uint32_t cycles_this_frame = 0;
-    while (cycles_this_frame < GB_FRAME_CYCLES)
+    const uint64_t start = gb->cpu->cycles;
+    gb_scheduler_schedule(gb->scheduler, GB_EVENT_RUN_END, start + max_cycles);
+
+    // Picks up inputs queued since the last run
+    gb_joypad_sync(gb->joypad, start);
+
+    for (;;)
     {
-        // NOTE: The cycles are given as m-cycles
-        const uint8_t m_cycles = gb_cpu_tick(gb->cpu);
-        const uint8_t t_cycles = m_cycles * 4;
-        gb_ppu_tick(gb->ppu, t_cycles);
-        gb_timer_tick(gb->timer, t_cycles);
-        cycles_this_frame += t_cycles;
+        // Accesses to a component catch it up on their own, otherwise it only has to run at its next event. Register
+        // writes can move that event closer, so the deadline is looked up again after every instruction
+        while (gb->cpu->cycles < gb_scheduler_get_next_deadline(gb->scheduler))
+        {
+            step_cpu(gb);
+            if (condition && condition(gb, user_data))
+            {
+                return finish_run(gb, start);
+            }
+        }
+
+        const bool run_ended = handle_events(gb);
+        if (run_ended || (condition && condition(gb, user_data)))
+        {
+            return finish_run(gb, start);
+        }
     }
 }
+
+void gb_run_frame(struct Gb *gb) { gb_run_until(gb, NULL, NULL, FRAME_CYCLES); }
+
+static bool is_vblank_entered(struct Gb *gb, void *user_data)
+{
+    return gb->ppu->vblank_count != *(const uint64_t *) user_data;
+}
+
+uint64_t gb_run_until_vblank(struct Gb *gb)
+{
+    // The PPU always has an event at the start of V-Blank, so it is caught up right when it enters it
+    uint64_t vblank_count = gb->ppu->vblank_count;
+    return gb_run_until(gb, is_vblank_entered, &vblank_count, VBLANK_TIMEOUT_CYCLES);
+}
+
+uint64_t gb_run_cycles(struct Gb *gb, const uint64_t cycles) { return gb_run_until(gb, NULL, NULL, cycles); }
+
+uint64_t gb_step(struct Gb *gb)
+{
+    const uint64_t start = gb->cpu->cycles;
+    step_cpu(gb);
+    handle_events(gb);
+
+    return finish_run(gb, start);
+}
+
+static bool is_at_pc(struct Gb *gb, void *user_data)
+{
+    return gb->cpu->registers.pc == *(const uint16_t *) user_data;
+}
+
+uint64_t gb_run_until_pc(struct Gb *gb, uint16_t pc, const uint64_t max_cycles)
+{
+    return gb_run_until(gb, is_at_pc, &pc, max_cycles);
+}
+
+bool gb_set_input(struct Gb *gb, const uint8_t buttons, const uint64_t cycle)
+{
+    return gb_joypad_push(gb->joypad, buttons, cycle);
+}
+
+size_t gb_take_audio_samples(struct Gb *gb, int16_t *samples, const size_t frames)
+{
+    gb_apu_sync(gb->apu, gb->cpu->cycles);
+    return gb_apu_take_samples(gb->apu, samples, frames);
+}
+
+size_t gb_take_serial_output(struct Gb *gb, uint8_t *buffer, const size_t size)
+{
+    return gb_serial_take_output(gb->serial, buffer, size);
+}
+
+bool gb_find_serial_output(struct Gb *gb, const char *text) { return gb_serial_find_output(gb->serial, text); }
+
+void gb_set_frame_callback(struct Gb *gb, void (*callback)(void *user_data), void *user_data)
+{
+    gb_ppu_set_frame_callback(gb->ppu, callback, user_data);
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/joypad.h"
+
+#include <stdlib.h>
+
+#include "gb/cpu.h"
+#include "gb/scheduler.h"
+#include "gb/utils/atomic.h"
+#include "gb/utils/bits.h"
+
+struct GbJoypadQueue
+{
+    struct GbInput inputs[GB_JOYPAD_QUEUE_SIZE];
+    struct GbAtomic head; // Next slot the producer writes
+    struct GbAtomic tail; // Next slot the emulation reads
+};
+
+// The four input lines as the game reads them, a cleared bit is a pressed button in a selected group
+static uint8_t get_lines(const struct GbJoypad *joypad)
+{
+    uint8_t lines = 0x0f;
+    if (!GB_BIT_CHECK(joypad->select, 4))
+    {
+        lines &= (uint8_t) ~(joypad->buttons & 0x0f);
+    }
+
+    if (!GB_BIT_CHECK(joypad->select, 5))
+    {
+        lines &= (uint8_t) ~(joypad->buttons >> 4);
+    }
+
+    return lines;
+}
+
+// The interrupt fires when any line goes low
+static void update_lines(struct GbJoypad *joypad, const uint8_t previous_lines)
+{
+    if ((previous_lines & ~get_lines(joypad)) != 0)
+    {
+        gb_cpu_request_interrupt(joypad->cpu, GB_INTERRUPT_JOYPAD);
+    }
+}
+
+struct GbJoypad *gb_joypad_create(void)
+{
+    struct GbJoypad *joypad = malloc(sizeof(struct GbJoypad));
+    joypad->cpu = NULL;
+    joypad->scheduler = NULL;
+    joypad->select = 0x30;
+    joypad->buttons = 0x00;
+    joypad->queue = malloc(sizeof(struct GbJoypadQueue));
+    gb_atomic_init(&joypad->queue->head, 0);
+    gb_atomic_init(&joypad->queue->tail, 0);
+
+    return joypad;
+}
+
+void gb_joypad_destroy(struct GbJoypad *joypad)
+{
+    free(joypad->queue);
+    free(joypad);
+}
+
+void gb_joypad_write(struct GbJoypad *joypad, const uint8_t value)
+{
+    const uint8_t previous_lines = get_lines(joypad);
+    joypad->select = value & 0x30;
+    update_lines(joypad, previous_lines);
+}
+
+uint8_t gb_joypad_read(struct GbJoypad *joypad) { return (uint8_t) (0xc0 | joypad->select | get_lines(joypad)); }
+
+bool gb_joypad_push(struct GbJoypad *joypad, const uint8_t buttons, const uint64_t cycle)
+{
+    struct GbJoypadQueue *queue = joypad->queue;
+    const size_t head = gb_atomic_load(&queue->head);
+    const size_t tail = gb_atomic_load(&queue->tail);
+    if (head - tail == GB_JOYPAD_QUEUE_SIZE)
+    {
+        return false;
+    }
+
+    queue->inputs[head & (GB_JOYPAD_QUEUE_SIZE - 1)] = (struct GbInput) {
+        .buttons = buttons,
+        .cycle = cycle,
+    };
+    gb_atomic_store(&queue->head, head + 1);
+    return true;
+}
+
+void gb_joypad_sync(struct GbJoypad *joypad, const uint64_t cycles)
+{
+    struct GbJoypadQueue *queue = joypad->queue;
+    const size_t head = gb_atomic_load(&queue->head);
+    size_t tail = gb_atomic_load(&queue->tail);
+
+    uint64_t next_input = UINT64_MAX;
+    for (; tail != head; ++tail)
+    {
+        const struct GbInput *input = &queue->inputs[tail & (GB_JOYPAD_QUEUE_SIZE - 1)];
+        if (input->cycle > cycles)
+        {
+            next_input = input->cycle;
+            break;
+        }
+
+        const uint8_t previous_lines = get_lines(joypad);
+        joypad->buttons = input->buttons;
+        update_lines(joypad, previous_lines);
+    }
+
+    gb_atomic_store(&queue->tail, tail);
+    gb_scheduler_schedule(joypad->scheduler, GB_EVENT_JOYPAD, next_input);
+}
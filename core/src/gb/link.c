@@ -0,0 +1,459 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#if !defined(_WIN32)
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "gb/link.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#    include <signal.h>
+#    include <sys/socket.h>
+#    include <sys/un.h>
+#    include <unistd.h>
+#endif
+
+#include "gb/cpu.h"
+#include "gb/gb.h"
+#include "gb/serial.h"
+#include "gb/utils/log.h"
+
+#define STATE_SIZE 3
+#define HANDSHAKE_SIZE 8
+
+// Serial state at the end of a window, the only thing the two ends exchange
+struct GbLinkState
+{
+    uint8_t sb;
+    uint8_t sc;
+    bool transfer_due; // A transfer on the internal clock finished during the window
+};
+
+static struct GbLinkState get_state(const struct GbLink *link, const uint32_t index)
+{
+    const struct GbSerial *serial = link->gbs[index]->serial;
+    return (struct GbLinkState) {
+        .sb = serial->sb,
+        .sc = serial->sc,
+        .transfer_due = serial->transfer_end <= link->bases[index] + link->cycles,
+    };
+}
+
+// Both ends resolve a window from the same two states, so they agree on the outcome without another round trip
+static void exchange(struct GbSerial *serial, const struct GbLinkState *own, const struct GbLinkState *partner)
+{
+    if (own->transfer_due || partner->transfer_due)
+    {
+        gb_serial_receive(serial, partner->sb);
+    }
+}
+
+static void run_instance(struct GbLink *link, const uint32_t index, const uint64_t cycles)
+{
+    // Instances overshoot by the rest of their last instruction, which the next window takes off again
+    struct Gb *gb = link->gbs[index];
+    const uint64_t target = link->bases[index] + cycles;
+    if (gb->cpu->cycles < target)
+    {
+        gb_run_cycles(gb, target - gb->cpu->cycles);
+    }
+}
+
+static struct GbLink *create_link(const enum GbLinkMode mode, struct Gb *first, struct Gb *second)
+{
+    struct GbLink *link = malloc(sizeof(struct GbLink));
+    link->mode = mode;
+    link->gbs[0] = first;
+    link->gbs[1] = second;
+    link->bases[0] = first->cpu->cycles;
+    link->bases[1] = second ? second->cpu->cycles : 0;
+    link->cycles = 0;
+    link->window_cycles = GB_LINK_DEFAULT_WINDOW_CYCLES;
+    link->socket = -1;
+
+    gb_serial_set_linked(first->serial, true);
+    if (second)
+    {
+        gb_serial_set_linked(second->serial, true);
+    }
+
+    return link;
+}
+
+#if defined(_WIN32)
+
+static int connect_to_partner(const char *path)
+{
+    gb_log(GB_LOG_ERROR, "Failed to connect to %s, socket links are not supported on Windows\n", path);
+    return -1;
+}
+
+static int listen_for_partner(const char *path)
+{
+    gb_log(GB_LOG_ERROR, "Failed to listen on %s, socket links are not supported on Windows\n", path);
+    return -1;
+}
+
+static int accept_partner(const int descriptor, const char *path)
+{
+    (void) descriptor;
+    (void) path;
+    return -1;
+}
+
+static void close_descriptor(const int descriptor) { (void) descriptor; }
+
+static void close_socket(struct GbLink *link) { link->socket = -1; }
+
+static bool exchange_bytes(struct GbLink *link, const uint8_t *sent, uint8_t *received, const size_t size)
+{
+    (void) link;
+    (void) sent;
+    (void) received;
+    (void) size;
+    return false;
+}
+
+#else
+
+// Writing to a socket the partner closed raises SIGPIPE, which would kill the process instead of failing the send
+#    if defined(MSG_NOSIGNAL)
+#        define SEND_FLAGS MSG_NOSIGNAL
+#    else
+#        define SEND_FLAGS 0
+#    endif
+
+static bool suppress_sigpipe(const int descriptor)
+{
+#    if defined(SO_NOSIGPIPE)
+    const int enabled = 1;
+    return setsockopt(descriptor, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled)) == 0;
+#    elif defined(MSG_NOSIGNAL)
+    (void) descriptor;
+    return true;
+#    else
+    // Neither is available, so the signal is ignored for the whole process
+    (void) descriptor;
+    return signal(SIGPIPE, SIG_IGN) != SIG_ERR;
+#    endif
+}
+
+static bool send_all(const int descriptor, const uint8_t *data, size_t size)
+{
+    while (size != 0)
+    {
+        const ssize_t sent = send(descriptor, data, size, SEND_FLAGS);
+        if (sent <= 0)
+        {
+            return false;
+        }
+
+        data += sent;
+        size -= (size_t) sent;
+    }
+
+    return true;
+}
+
+static bool receive_all(const int descriptor, uint8_t *data, size_t size)
+{
+    while (size != 0)
+    {
+        const ssize_t received = recv(descriptor, data, size, 0);
+        if (received <= 0)
+        {
+            return false;
+        }
+
+        data += received;
+        size -= (size_t) received;
+    }
+
+    return true;
+}
+
+static void close_socket(struct GbLink *link)
+{
+    if (link->socket != -1)
+    {
+        close(link->socket);
+        link->socket = -1;
+    }
+}
+
+// Both ends send before they receive, every message fits into the socket buffer
+static bool exchange_bytes(struct GbLink *link, const uint8_t *sent, uint8_t *received, const size_t size)
+{
+    return send_all(link->socket, sent, size) && receive_all(link->socket, received, size);
+}
+
+static bool get_address(const char *path, struct sockaddr_un *address)
+{
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address->sun_path))
+    {
+        gb_log(GB_LOG_ERROR, "Socket path %s is too long\n", path);
+        return false;
+    }
+
+    strcpy(address->sun_path, path);
+    return true;
+}
+
+static int connect_to_partner(const char *path)
+{
+    struct sockaddr_un address;
+    if (!get_address(path, &address))
+    {
+        return -1;
+    }
+
+    const int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (descriptor == -1)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to create socket for %s\n", path);
+        return -1;
+    }
+
+    if (connect(descriptor, (const struct sockaddr *) &address, sizeof(address)) != 0)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to connect to %s\n", path);
+        close(descriptor);
+        return -1;
+    }
+
+    if (!suppress_sigpipe(descriptor))
+    {
+        gb_log(GB_LOG_ERROR, "Failed to configure socket for %s\n", path);
+        close(descriptor);
+        return -1;
+    }
+
+    return descriptor;
+}
+
+static int listen_for_partner(const char *path)
+{
+    struct sockaddr_un address;
+    if (!get_address(path, &address))
+    {
+        return -1;
+    }
+
+    const int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (descriptor == -1)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to create socket for %s\n", path);
+        return -1;
+    }
+
+    // A socket file left behind by an earlier run would make the bind fail
+    unlink(path);
+    if (bind(descriptor, (const struct sockaddr *) &address, sizeof(address)) != 0 || listen(descriptor, 1) != 0)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to listen on %s\n", path);
+        close(descriptor);
+        return -1;
+    }
+
+    return descriptor;
+}
+
+static int accept_partner(const int descriptor, const char *path)
+{
+    const int connection = accept(descriptor, NULL, NULL);
+    if (connection == -1)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to accept partner on %s\n", path);
+        return -1;
+    }
+
+    if (!suppress_sigpipe(connection))
+    {
+        gb_log(GB_LOG_ERROR, "Failed to configure socket for %s\n", path);
+        close(connection);
+        return -1;
+    }
+
+    return connection;
+}
+
+static void close_descriptor(const int descriptor) { close(descriptor); }
+
+#endif
+
+static struct GbLink *start_link(struct Gb *gb, const int descriptor, const char *path, const uint64_t window_cycles)
+{
+    struct GbLink *link = create_link(GB_LINK_MODE_SOCKET, gb, NULL);
+    link->socket = descriptor;
+    link->window_cycles = window_cycles == 0 ? GB_LINK_DEFAULT_WINDOW_CYCLES : window_cycles;
+
+    // Both ends have to cut the time into the same windows
+    uint8_t handshake[HANDSHAKE_SIZE];
+    uint8_t partner_handshake[HANDSHAKE_SIZE];
+    for (uint32_t i = 0; i < HANDSHAKE_SIZE; ++i)
+    {
+        handshake[i] = (uint8_t) (link->window_cycles >> (i * 8));
+    }
+
+    if (!exchange_bytes(link, handshake, partner_handshake, HANDSHAKE_SIZE))
+    {
+        gb_log(GB_LOG_ERROR, "Failed to reach the partner on %s\n", path);
+        gb_link_destroy(link);
+        return NULL;
+    }
+
+    if (memcmp(handshake, partner_handshake, HANDSHAKE_SIZE) != 0)
+    {
+        gb_log(GB_LOG_ERROR, "Partner on %s uses a different window size\n", path);
+        gb_link_destroy(link);
+        return NULL;
+    }
+
+    return link;
+}
+
+struct GbLink *gb_link_create_local(struct Gb *first, struct Gb *second)
+{
+    // A window never outlasts a transfer, so none can start and finish within the same one
+    return create_link(GB_LINK_MODE_LOCAL, first, second);
+}
+
+struct GbLink *gb_link_create_socket(struct Gb *gb, const char *path, const bool listen, const uint64_t window_cycles)
+{
+    if (listen)
+    {
+        struct GbLinkListener *listener = gb_link_listen(path);
+        return listener ? gb_link_accept(listener, gb, window_cycles) : NULL;
+    }
+
+    const int descriptor = connect_to_partner(path);
+    return descriptor != -1 ? start_link(gb, descriptor, path, window_cycles) : NULL;
+}
+
+struct GbLinkListener *gb_link_listen(const char *path)
+{
+    const int descriptor = listen_for_partner(path);
+    if (descriptor == -1)
+    {
+        return NULL;
+    }
+
+    struct GbLinkListener *listener = malloc(sizeof(struct GbLinkListener));
+    listener->socket = descriptor;
+    listener->path = malloc(strlen(path) + 1);
+    strcpy(listener->path, path);
+    return listener;
+}
+
+struct GbLink *gb_link_accept(struct GbLinkListener *listener, struct Gb *gb, const uint64_t window_cycles)
+{
+    const int descriptor = accept_partner(listener->socket, listener->path);
+    struct GbLink *link = descriptor != -1 ? start_link(gb, descriptor, listener->path, window_cycles) : NULL;
+    gb_link_listener_destroy(listener);
+    return link;
+}
+
+void gb_link_listener_destroy(struct GbLinkListener *listener)
+{
+    close_descriptor(listener->socket);
+#if !defined(_WIN32)
+    unlink(listener->path);
+#endif
+    free(listener->path);
+    free(listener);
+}
+
+void gb_link_destroy(struct GbLink *link)
+{
+    close_socket(link);
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        if (link->gbs[i])
+        {
+            gb_serial_set_linked(link->gbs[i]->serial, false);
+        }
+    }
+
+    free(link);
+}
+
+static void run_local_window(struct GbLink *link, const uint64_t end)
+{
+    uint64_t window_end = link->cycles + link->window_cycles;
+    window_end = window_end < end ? window_end : end;
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        const uint64_t transfer_end = link->gbs[i]->serial->transfer_end;
+        if (transfer_end != UINT64_MAX && transfer_end - link->bases[i] < window_end)
+        {
+            window_end = transfer_end - link->bases[i];
+        }
+    }
+
+    run_instance(link, 0, window_end);
+    run_instance(link, 1, window_end);
+    link->cycles = window_end;
+
+    const struct GbLinkState states[2] = { get_state(link, 0), get_state(link, 1) };
+    exchange(link->gbs[0]->serial, &states[0], &states[1]);
+    exchange(link->gbs[1]->serial, &states[1], &states[0]);
+}
+
+static void run_socket_window(struct GbLink *link)
+{
+    run_instance(link, 0, link->cycles + link->window_cycles);
+    link->cycles += link->window_cycles;
+
+    // The partner went away, the instance carries on as if the cable was pulled
+    if (link->socket == -1)
+    {
+        return;
+    }
+
+    const struct GbLinkState state = get_state(link, 0);
+    const uint8_t message[STATE_SIZE] = { state.sb, state.sc, state.transfer_due };
+    uint8_t partner_message[STATE_SIZE];
+    if (!exchange_bytes(link, message, partner_message, STATE_SIZE))
+    {
+        gb_log(GB_LOG_WARN, "Link partner disconnected\n");
+        close_socket(link);
+        gb_serial_set_linked(link->gbs[0]->serial, false);
+        return;
+    }
+
+    const struct GbLinkState partner_state = {
+        .sb = partner_message[0],
+        .sc = partner_message[1],
+        .transfer_due = partner_message[2] != 0,
+    };
+    exchange(link->gbs[0]->serial, &state, &partner_state);
+}
+
+uint64_t gb_link_run_cycles(struct GbLink *link, const uint64_t cycles)
+{
+    // Socket windows are never cut short, both ends have to see the same boundaries
+    const uint64_t start = link->cycles;
+    const uint64_t end = start + cycles;
+    while (link->cycles < end)
+    {
+        if (link->mode == GB_LINK_MODE_LOCAL)
+        {
+            run_local_window(link, end);
+        }
+        else
+        {
+            run_socket_window(link);
+        }
+    }
+
+    return link->cycles - start;
+}
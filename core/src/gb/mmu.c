@@ -6,34 +6,49 @@
 
 #include "gb/mmu.h"
 
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "gb/apu.h"
 #include "gb/cartridge.h"
 #include "gb/cpu.h"
+#include "gb/joypad.h"
 #include "gb/ppu.h"
+#include "gb/ppu_cgb.h"
+#include "gb/serial.h"
 #include "gb/timer.h"
+#include "gb/utils/bits.h"
 #include "gb/utils/log.h"
 
-static void mmu_write_io(struct GbMmu *mmu, uint16_t address, uint8_t value);
-static uint8_t mmu_read_io(struct GbMmu *mmu, uint16_t address);
+// A speed switch stops the CPU for 2050 M-cycles, counted in master cycles at normal speed
+#define SPEED_SWITCH_CYCLES (2050 * 4)
+
+static void mmu_oam_dma(struct GbMmu *mmu, uint8_t source);
+static void mmu_reset_div(struct GbMmu *mmu);
+static void mmu_set_wram_bank(struct GbMmu *mmu, uint8_t value);
 
 struct GbMmu *gb_mmu_create(void)
 {
     struct GbMmu *mmu = malloc(sizeof(struct GbMmu));
+    mmu->apu = NULL;
     mmu->cartridge = NULL;
     mmu->cpu = NULL;
+    mmu->joypad = NULL;
     mmu->ppu = NULL;
+    mmu->serial = NULL;
     mmu->timer = NULL;
+    mmu->cgb = false;
+    mmu->boot_rom = NULL;
+    mmu->boot_rom_size = 0;
 
 #if TESTS_ENABLED
     mmu->memory = malloc(sizeof(uint8_t) * 0x10000);
-#else
-    mmu->wram = calloc(1, 0x2000);
-    mmu->oam = calloc(1, 0xa0);
-    mmu->io = calloc(1, 0x80);
-    mmu->hram = calloc(1, 0x7f);
 #endif
+    mmu->wram = calloc(1, 0x8000);
+    mmu_set_wram_bank(mmu, 0x01);
+    mmu->io = malloc(0x80);
+    memset(mmu->io, 0xff, 0x80);
+    mmu->hram = calloc(1, 0x7f);
 
     return mmu;
 }
@@ -42,18 +57,43 @@ void gb_mmu_destroy(struct GbMmu *mmu)
 {
 #if TESTS_ENABLED
     free(mmu->memory);
-#else
+#endif
     free(mmu->hram);
     free(mmu->io);
-    free(mmu->oam);
     free(mmu->wram);
-#endif
+    free(mmu->boot_rom);
 
     free(mmu);
 }
 
+// The CGB boot ROM leaves a gap for the cartridge header
+static bool is_boot_rom_address(const struct GbMmu *mmu, const uint16_t address)
+{
+    return mmu->boot_rom != NULL && (address < 0x0100 || (address >= 0x0200 && address < mmu->boot_rom_size));
+}
+
+void gb_mmu_map_boot_rom(struct GbMmu *mmu, const uint8_t *boot_rom, const size_t size)
+{
+    free(mmu->boot_rom);
+    mmu->boot_rom = malloc(size);
+    memcpy(mmu->boot_rom, boot_rom, size);
+    mmu->boot_rom_size = size;
+}
+
 void gb_mmu_write(struct GbMmu *mmu, const uint16_t address, const uint8_t value)
 {
+    // The boot ROM unmaps itself for good, nothing maps it back in
+    if (address == 0xff50 && mmu->boot_rom != NULL)
+    {
+        if (GB_BIT_CHECK(value, 0))
+        {
+            free(mmu->boot_rom);
+            mmu->boot_rom = NULL;
+        }
+
+        return;
+    }
+
 #if TESTS_ENABLED
     mmu->memory[address] = value;
 #else
@@ -65,27 +105,39 @@ void gb_mmu_write(struct GbMmu *mmu, const uint16_t address, const uint8_t value
 
     if (address >= 0x8000 && address <= 0x9fff)
     {
+        gb_ppu_sync(mmu->ppu, mmu->cpu->cycles);
         gb_ppu_write(mmu->ppu, address - 0x8000, value);
         return;
     }
 
-    // FIXME: Implement 0xa000-0xbfff - External RAM
+    if (address >= 0xa000 && address <= 0xbfff)
+    {
+        gb_cartridge_write_ram(mmu->cartridge, address - 0xa000, value);
+        return;
+    }
 
-    if (address >= 0xc000 && address <= 0xdfff)
+    if (address >= 0xc000 && address <= 0xcfff)
     {
         mmu->wram[address - 0xc000] = value;
         return;
     }
 
+    if (address >= 0xd000 && address <= 0xdfff)
+    {
+        mmu->wram_bank[address - 0xd000] = value;
+        return;
+    }
+
     if (address >= 0xfe00 && address <= 0xfe9f)
     {
-        mmu->oam[address - 0xfe00] = value;
+        gb_ppu_sync(mmu->ppu, mmu->cpu->cycles);
+        gb_ppu_write_oam(mmu->ppu, address - 0xfe00, value);
         return;
     }
 
     if (address >= 0xff00 && address <= 0xff7f)
     {
-        mmu_write_io(mmu, address, value);
+        gb_mmu_write_io(mmu, address, value);
         return;
     }
 
@@ -107,6 +159,11 @@ void gb_mmu_write(struct GbMmu *mmu, const uint16_t address, const uint8_t value
 
 uint8_t gb_mmu_read(struct GbMmu *mmu, const uint16_t address)
 {
+    if (is_boot_rom_address(mmu, address))
+    {
+        return mmu->boot_rom[address];
+    }
+
 #if TESTS_ENABLED
     return mmu->memory[address];
 #else
@@ -118,24 +175,34 @@ uint8_t gb_mmu_read(struct GbMmu *mmu, const uint16_t address)
 
     if (address >= 0x8000 && address <= 0x9fff)
     {
+        gb_ppu_sync(mmu->ppu, mmu->cpu->cycles);
         return gb_ppu_read(mmu->ppu, address - 0x8000);
     }
 
-    // FIXME: Implement 0xa000-0xbfff - External RAM
+    if (address >= 0xa000 && address <= 0xbfff)
+    {
+        return gb_cartridge_read_ram(mmu->cartridge, address - 0xa000);
+    }
 
-    if (address >= 0xc000 && address <= 0xdfff)
+    if (address >= 0xc000 && address <= 0xcfff)
     {
         return mmu->wram[address - 0xc000];
     }
 
+    if (address >= 0xd000 && address <= 0xdfff)
+    {
+        return mmu->wram_bank[address - 0xd000];
+    }
+
     if (address >= 0xfe00 && address <= 0xfe9f)
     {
-        return mmu->oam[address - 0xfe00];
+        gb_ppu_sync(mmu->ppu, mmu->cpu->cycles);
+        return gb_ppu_read_oam(mmu->ppu, address - 0xfe00);
     }
 
     if (address >= 0xff00 && address <= 0xff7f)
     {
-        return mmu_read_io(mmu, address);
+        return gb_mmu_read_io(mmu, address);
     }
 
     if (address >= 0xff80 && address <= 0xfffe)
@@ -152,36 +219,199 @@ uint8_t gb_mmu_read(struct GbMmu *mmu, const uint16_t address)
 #endif
 }
 
-#if !TESTS_ENABLED
-static void mmu_write_io(struct GbMmu *mmu, const uint16_t address, const uint8_t value)
+void gb_mmu_set_cgb(struct GbMmu *mmu, const bool enabled)
+{
+    mmu->cgb = enabled;
+    mmu_set_wram_bank(mmu, 0x01);
+}
+
+void gb_mmu_switch_speed(struct GbMmu *mmu)
+{
+    struct GbCpu *cpu = mmu->cpu;
+    cpu->speed_switch_armed = false;
+    cpu->double_speed = !cpu->double_speed;
+
+    mmu_reset_div(mmu);
+    gb_timer_set_double_speed(mmu->timer, cpu->double_speed);
+
+    // The CPU pauses while the clock settles, like it stalls for a general purpose DMA
+    cpu->cycles += SPEED_SWITCH_CYCLES;
+}
+
+static void mmu_set_wram_bank(struct GbMmu *mmu, const uint8_t value)
+{
+    // Selecting bank 0 selects bank 1
+    mmu->wram_bank_index = value & 0x07;
+    mmu->wram_bank = &mmu->wram[(mmu->wram_bank_index == 0 ? 1 : mmu->wram_bank_index) * 0x1000];
+}
+
+// The PPU owns the CGB video registers, VRAM DMA and the palettes included
+static bool is_ppu_register(const uint16_t address)
+{
+    return (address >= 0xff40 && address <= 0xff4b) || address == 0xff4f || (address >= 0xff51 && address <= 0xff55)
+        || (address >= 0xff68 && address <= 0xff6b);
+}
+
+static void mmu_reset_div(struct GbMmu *mmu)
+{
+    // The frame sequencer is clocked by the system counter as well
+    gb_timer_sync(mmu->timer, mmu->cpu->cycles);
+    gb_apu_sync(mmu->apu, mmu->cpu->cycles);
+    gb_apu_reset_div(mmu->apu);
+    gb_timer_reset_div(mmu->timer);
+}
+
+// Returns false for the registers the DMG has as well
+static bool mmu_write_cgb_io(struct GbMmu *mmu, const uint16_t address, const uint8_t value)
 {
     switch (address)
     {
+    case 0xff4c:
+        // KEY0 is locked once the boot ROM selected the mode
+        if (mmu->boot_rom != NULL)
+        {
+            mmu->io[0x4c] = value;
+        }
+        return true;
+    case 0xff4d:
+        mmu->cpu->speed_switch_armed = GB_BIT_CHECK(value, 0);
+        return true;
+    case 0xff4f:
+        gb_ppu_cgb_set_vram_bank(mmu->ppu, value);
+        return true;
+    case 0xff51:
+    case 0xff52:
+    case 0xff53:
+    case 0xff54:
+    case 0xff55:
+        // A general purpose DMA halts the CPU until it is done
+        mmu->cpu->cycles += gb_ppu_cgb_write_dma(mmu->ppu, address, value);
+        return true;
+    case 0xff68:
+    case 0xff69:
+    case 0xff6a:
+    case 0xff6b:
+        gb_ppu_cgb_write_palette(mmu->ppu, address, value);
+        return true;
+    case 0xff6c:
+        mmu->io[0x6c] = (uint8_t) (value | 0xfe);
+        return true;
+    case 0xff70:
+        mmu_set_wram_bank(mmu, value);
+        return true;
+    case 0xff72:
+    case 0xff73:
+    case 0xff74:
+        mmu->io[address - 0xff00] = value;
+        return true;
+    case 0xff75:
+        mmu->io[0x75] = (uint8_t) (value | 0x8f);
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool mmu_read_cgb_io(struct GbMmu *mmu, const uint16_t address, uint8_t *value)
+{
+    switch (address)
+    {
+    case 0xff4d:
+        *value = (uint8_t) ((mmu->cpu->double_speed << 7) | mmu->cpu->speed_switch_armed | 0x7e);
+        return true;
+    case 0xff4f:
+        *value = gb_ppu_cgb_get_vram_bank(mmu->ppu);
+        return true;
+    case 0xff51:
+    case 0xff52:
+    case 0xff53:
+    case 0xff54:
+    case 0xff55:
+        *value = gb_ppu_cgb_read_dma(mmu->ppu, address);
+        return true;
+    case 0xff68:
+    case 0xff69:
+    case 0xff6a:
+    case 0xff6b:
+        *value = gb_ppu_cgb_read_palette(mmu->ppu, address);
+        return true;
+    case 0xff4c:
+        *value = mmu->boot_rom != NULL ? mmu->io[0x4c] : 0xff;
+        return true;
+    case 0xff70:
+        *value = (uint8_t) (mmu->wram_bank_index | 0xf8);
+        return true;
+    case 0xff6c:
+    case 0xff72:
+    case 0xff73:
+    case 0xff74:
+    case 0xff75:
+        *value = mmu->io[address - 0xff00];
+        return true;
+    default:
+        return false;
+    }
+}
+
+void gb_mmu_write_io(struct GbMmu *mmu, const uint16_t address, const uint8_t value)
+{
+    // Components that run behind the CPU have to catch up before their registers change
+    if (is_ppu_register(address))
+    {
+        gb_ppu_sync(mmu->ppu, mmu->cpu->cycles);
+    }
+    else if (address >= 0xff04 && address <= 0xff07)
+    {
+        gb_timer_sync(mmu->timer, mmu->cpu->cycles);
+    }
+    else if (address >= 0xff01 && address <= 0xff02)
+    {
+        gb_serial_sync(mmu->serial, mmu->cpu->cycles);
+    }
+    else if (address >= 0xff10 && address <= 0xff3f)
+    {
+        gb_apu_sync(mmu->apu, mmu->cpu->cycles);
+        gb_apu_write(mmu->apu, address, value);
+        return;
+    }
+
+    if (mmu->cgb && mmu_write_cgb_io(mmu, address, value))
+    {
+        return;
+    }
+
+    switch (address)
+    {
+    case 0xff00:
+        gb_joypad_sync(mmu->joypad, mmu->cpu->cycles);
+        gb_joypad_write(mmu->joypad, value);
+        break;
     case 0xff01:
-        printf("%c", value);
+        gb_serial_set_sb(mmu->serial, value);
         break;
     case 0xff02:
+        gb_serial_set_sc(mmu->serial, value);
         break;
     case 0xff04:
-        mmu->timer->div = 0xff;
+        mmu_reset_div(mmu);
         break;
     case 0xff05:
-        mmu->timer->tima = value;
+        gb_timer_set_tima(mmu->timer, value);
         break;
     case 0xff06:
-        mmu->timer->tma = value;
+        gb_timer_set_tma(mmu->timer, value);
         break;
     case 0xff07:
-        mmu->timer->tac = value;
+        gb_timer_set_tac(mmu->timer, value);
         break;
     case 0xff0f:
-        mmu->cpu->interrupt_flag = value;
+        mmu->cpu->interrupt_flag = value & 0x1f;
         break;
     case 0xff40:
-        mmu->ppu->lcd_control = value;
+        gb_ppu_set_lcd_control(mmu->ppu, value);
         break;
     case 0xff41:
-        mmu->ppu->lcd_status = value;
+        gb_ppu_set_lcd_status(mmu->ppu, value);
         break;
     case 0xff42:
         mmu->ppu->scy = value;
@@ -193,10 +423,10 @@ static void mmu_write_io(struct GbMmu *mmu, const uint16_t address, const uint8_
         mmu->ppu->ly = 0x00;
         break; // Write will cause to reset
     case 0xff45:
-        mmu->ppu->lyc = value;
+        gb_ppu_set_lyc(mmu->ppu, value);
         break;
     case 0xff46:
-        gb_log(GB_LOG_WARN, "Attempted to start DMA transfer\n");
+        mmu_oam_dma(mmu, value);
         break;
     case 0xff47:
         mmu->ppu->bgp = value;
@@ -214,28 +444,66 @@ static void mmu_write_io(struct GbMmu *mmu, const uint16_t address, const uint8_
         mmu->ppu->wx = value;
         break;
     default:
-        mmu->io[address - 0xff00] = value;
-        gb_log(GB_LOG_WARN, "Unhandled I/O-write at 0x%04x with 0x%02x\n", address, value);
+        // Nothing is mapped, the write goes nowhere
         break;
     }
 }
 
-static uint8_t mmu_read_io(struct GbMmu *mmu, const uint16_t address)
+static void mmu_oam_dma(struct GbMmu *mmu, const uint8_t source)
 {
+    // FIXME: The transfer is done at once instead of over 160 m-cycles
+    const uint16_t source_address = (uint16_t) (source << 8);
+    for (uint16_t i = 0; i < 0xa0; ++i)
+    {
+        gb_ppu_write_oam(mmu->ppu, i, gb_mmu_read(mmu, (uint16_t) (source_address + i)));
+    }
+}
+
+uint8_t gb_mmu_read_io(struct GbMmu *mmu, const uint16_t address)
+{
+    if (is_ppu_register(address))
+    {
+        gb_ppu_sync(mmu->ppu, mmu->cpu->cycles);
+    }
+    else if (address >= 0xff04 && address <= 0xff07)
+    {
+        gb_timer_sync(mmu->timer, mmu->cpu->cycles);
+    }
+    else if (address >= 0xff01 && address <= 0xff02)
+    {
+        gb_serial_sync(mmu->serial, mmu->cpu->cycles);
+    }
+    else if (address >= 0xff10 && address <= 0xff3f)
+    {
+        gb_apu_sync(mmu->apu, mmu->cpu->cycles);
+        return gb_apu_read(mmu->apu, address);
+    }
+
+    uint8_t value = 0;
+    if (mmu->cgb && mmu_read_cgb_io(mmu, address, &value))
+    {
+        return value;
+    }
+
     switch (address)
     {
     case 0xff00:
-        return 0xff;
+        gb_joypad_sync(mmu->joypad, mmu->cpu->cycles);
+        return gb_joypad_read(mmu->joypad);
+    case 0xff01:
+        return mmu->serial->sb;
+    case 0xff02:
+        return gb_serial_get_sc(mmu->serial);
     case 0xff04:
-        return mmu->timer->div;
+        return gb_timer_get_div(mmu->timer);
     case 0xff05:
         return mmu->timer->tima;
     case 0xff06:
         return mmu->timer->tma;
     case 0xff07:
-        return mmu->timer->tac;
+        return (uint8_t) (mmu->timer->tac | 0xf8);
     case 0xff0f:
-        return mmu->cpu->interrupt_flag;
+        return (uint8_t) (mmu->cpu->interrupt_flag | 0xe0);
     case 0xff40:
         return mmu->ppu->lcd_control;
     case 0xff41:
@@ -262,8 +530,7 @@ static uint8_t mmu_read_io(struct GbMmu *mmu, const uint16_t address)
     case 0xff4b:
         return mmu->ppu->wx;
     default:
-        gb_log(GB_LOG_WARN, "Unhandled I/O-Read at 0x%04x\n", address);
+        // Unused addresses read as 0xff, as does 0xff50 once the boot ROM is unmapped
         return mmu->io[address - 0xff00];
     }
 }
-#endif
@@ -7,28 +7,48 @@
 #include "gb/ppu.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "gb/cpu.h"
 #include "gb/definitions.h"
 #include "gb/mmu.h"
+#include "gb/ppu_cgb.h"
+#include "gb/ppu_compositor.h"
+#include "gb/ppu_deferred.h"
+#include "gb/ppu_fifo.h"
+#include "gb/ppu_frame_buffers.h"
+#include "gb/ppu_tile_map_cache.h"
+#include "gb/scheduler.h"
 #include "gb/utils/bits.h"
 
 #define PPU_MODE_OAM_SCAN_DOTS 80
-#define PPU_MODE_DRAWING_DOTS 289
+#define PPU_MODE_DRAWING_DOTS 172
 #define PPU_MODE_H_BLANK_DOTS 204
-#define PPU_MODE_V_BLANK_DOTS 4560
+#define PPU_LINE_DOTS 456
+#define PPU_LINES 154
+
+#define TILES_PER_LINE 32
+#define TILE_BYTES (2 * 8)
+
+// Mode bits of STAT, indexed by enum GbPpuMode
+static const uint8_t s_stat_modes[] = { 2, 3, 0, 1 };
+
+static void handle_oam_scan(struct GbPpu *ppu);
 
 struct GbPpu *gb_ppu_create(void)
 {
     struct GbPpu *ppu = malloc(sizeof(struct GbPpu));
     ppu->mmu = NULL;
     ppu->cpu = NULL;
+    ppu->scheduler = NULL;
     ppu->vram = calloc(1, sizeof(uint8_t) * 0x2000);
-    ppu->lcd_control = 0;
+    ppu->vram_bank = ppu->vram;
+    ppu->oam = calloc(1, sizeof(uint8_t) * 0xa0);
+    ppu->lcd_control = 0; // The LCD powers on disabled
     ppu->lcd_status = 0;
     ppu->scy = 0;
     ppu->scx = 0;
-    ppu->ly = 0x90; // FIXME: It is hardcoded to V-Blank
+    ppu->ly = 0;
     ppu->lyc = 0;
     ppu->bgp = 0;
     ppu->obp0 = 0;
@@ -36,124 +56,775 @@ struct GbPpu *gb_ppu_create(void)
     ppu->wy = 0;
     ppu->wx = 0;
     ppu->dots_counter = 0;
-    ppu->mode = GB_PPU_MODE_OAM_SCAN;
-    ppu->screen = calloc(1, sizeof(enum GbColor) * GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT);
+    ppu->mode = GB_PPU_MODE_HBLANK;
+    ppu->stat_line = false;
+    ppu->cycles = 0;
+    ppu->next_interrupt = 0;
+    ppu->renderer = GB_PPU_RENDERER_SCANLINE;
+    ppu->fifo = gb_ppu_fifo_create();
+    ppu->deferred = NULL;
+    ppu->compositor = gb_ppu_compositor_detect();
+    memset(&ppu->line, 0, sizeof(ppu->line));
+    ppu->tile_map_cache = NULL;
+    ppu->cgb = NULL;
+    ppu->render_policy = GB_PPU_RENDER_ALWAYS;
+    ppu->render_interval = 1;
+    ppu->frame_counter = 0;
+    ppu->frame_requested = false;
+    ppu->render_frame = true;
+    ppu->vblank_count = 0;
+    memset(ppu->line_shades, 0, sizeof(ppu->line_shades));
+    memset(ppu->dirty_lines, 0xff, sizeof(ppu->dirty_lines));
+    ppu->object_cache_dirty = true;
+    ppu->object_cache_height = 0;
+    ppu->line_object_count = 0;
+    ppu->window_triggered = false;
+    ppu->window_line = 0;
+    ppu->frame_buffers = gb_ppu_frame_buffers_create();
+    ppu->screen = gb_ppu_frame_buffers_get_back(ppu->frame_buffers);
+    ppu->frame_callback = NULL;
+    ppu->frame_callback_data = NULL;
 
     return ppu;
 }
 
 void gb_ppu_destroy(struct GbPpu *ppu)
 {
-    free(ppu->screen);
+    if (ppu->cgb)
+    {
+        gb_ppu_cgb_destroy(ppu->cgb);
+    }
+
+    if (ppu->tile_map_cache)
+    {
+        gb_ppu_tile_map_cache_destroy(ppu->tile_map_cache);
+    }
+
+    if (ppu->deferred)
+    {
+        gb_ppu_deferred_destroy(ppu->deferred);
+    }
+
+    gb_ppu_fifo_destroy(ppu->fifo);
+    gb_ppu_frame_buffers_destroy(ppu->frame_buffers);
+    free(ppu->oam);
     free(ppu->vram);
     free(ppu);
 }
 
-void gb_ppu_write(struct GbPpu *ppu, const uint16_t address, const uint8_t value) { ppu->vram[address] = value; }
+void gb_ppu_write(struct GbPpu *ppu, const uint16_t address, const uint8_t value)
+{
+    ppu->vram_bank[address] = value;
 
-uint8_t gb_ppu_read(struct GbPpu *ppu, const uint16_t address) { return ppu->vram[address]; }
+    if (ppu->tile_map_cache)
+    {
+        gb_ppu_tile_map_cache_invalidate(ppu->tile_map_cache, address);
+    }
 
-static void handle_oam_scan(struct GbPpu *ppu) { }
+    if (ppu->renderer == GB_PPU_RENDERER_DEFERRED)
+    {
+        gb_ppu_deferred_log_write(ppu->deferred, address, value, false);
+    }
+}
 
-static void handle_drawing(struct GbPpu *ppu) { }
+uint8_t gb_ppu_read(struct GbPpu *ppu, const uint16_t address) { return ppu->vram_bank[address]; }
 
-static void handle_hblank(struct GbPpu *ppu)
+void gb_ppu_write_oam(struct GbPpu *ppu, const uint16_t address, const uint8_t value)
+{
+    ppu->oam[address] = value;
+    ppu->object_cache_dirty = true;
+
+    if (ppu->renderer == GB_PPU_RENDERER_DEFERRED)
+    {
+        gb_ppu_deferred_log_write(ppu->deferred, address, value, true);
+    }
+}
+
+uint8_t gb_ppu_read_oam(struct GbPpu *ppu, const uint16_t address) { return ppu->oam[address]; }
+
+static uint16_t get_mode_dots(const enum GbPpuMode mode)
+{
+    switch (mode)
+    {
+    case GB_PPU_MODE_OAM_SCAN:
+        return PPU_MODE_OAM_SCAN_DOTS;
+    case GB_PPU_MODE_DRAWING:
+        return PPU_MODE_DRAWING_DOTS;
+    case GB_PPU_MODE_HBLANK:
+        return PPU_MODE_H_BLANK_DOTS;
+    default:
+        return PPU_LINE_DOTS;
+    }
+}
+
+static uint32_t get_line_dot(struct GbPpu *ppu)
+{
+    switch (ppu->mode)
+    {
+    case GB_PPU_MODE_DRAWING:
+        return PPU_MODE_OAM_SCAN_DOTS + ppu->dots_counter;
+    case GB_PPU_MODE_HBLANK:
+        return PPU_MODE_OAM_SCAN_DOTS + PPU_MODE_DRAWING_DOTS + ppu->dots_counter;
+    default:
+        return ppu->dots_counter;
+    }
+}
+
+static void find_next_interrupt(struct GbPpu *ppu)
+{
+    if (!GB_BIT_CHECK(ppu->lcd_control, 7))
+    {
+        ppu->next_interrupt = UINT64_MAX;
+        return;
+    }
+
+    // Enabled STAT sources can fire at the next mode change, which has no fixed time in the FIFO renderer. A running
+    // H-Blank DMA has to copy its blocks on time as well, before the CPU can change their source
+    const bool fifo = ppu->renderer == GB_PPU_RENDERER_FIFO;
+    if ((ppu->lcd_status & 0b01111000) != 0 || (ppu->cgb && ppu->cgb->dma_active))
+    {
+        ppu->next_interrupt = ppu->cycles + (fifo ? 1 : (uint64_t) (get_mode_dots(ppu->mode) - ppu->dots_counter));
+        return;
+    }
+
+    // Otherwise V-Blank is the only interrupt left
+    const uint32_t line_dot = fifo ? ppu->fifo->line_dot : get_line_dot(ppu);
+    const uint32_t lines = ppu->ly < GB_SCREEN_HEIGHT ? (uint32_t) (GB_SCREEN_HEIGHT - ppu->ly)
+                                                      : (uint32_t) (PPU_LINES - ppu->ly + GB_SCREEN_HEIGHT);
+    ppu->next_interrupt = ppu->cycles + lines * PPU_LINE_DOTS - line_dot;
+}
+
+void gb_ppu_update_next_interrupt(struct GbPpu *ppu)
 {
-    const bool hblank_interrupt = GB_BIT_CHECK(ppu->lcd_status, 3);
-    if (hblank_interrupt)
+    find_next_interrupt(ppu);
+    gb_scheduler_schedule(ppu->scheduler, GB_EVENT_PPU, ppu->next_interrupt);
+}
+
+void gb_ppu_update_stat(struct GbPpu *ppu)
+{
+    const bool coincidence = ppu->ly == ppu->lyc;
+    ppu->lcd_status = (uint8_t) ((ppu->lcd_status & 0b11111000) | (coincidence << 2) | s_stat_modes[ppu->mode]);
+
+    const bool stat_line = (ppu->mode == GB_PPU_MODE_HBLANK && GB_BIT_CHECK(ppu->lcd_status, 3))
+        || (ppu->mode == GB_PPU_MODE_VBLANK && GB_BIT_CHECK(ppu->lcd_status, 4))
+        || (ppu->mode == GB_PPU_MODE_OAM_SCAN && GB_BIT_CHECK(ppu->lcd_status, 5))
+        || (coincidence && GB_BIT_CHECK(ppu->lcd_status, 6));
+
+    if (stat_line && !ppu->stat_line)
     {
         gb_cpu_request_interrupt(ppu->cpu, GB_INTERRUPT_LCD);
     }
 
-    // Draw Scanline
+    ppu->stat_line = stat_line;
+}
 
-    // Draw Background
+// Draws the lines recorded so far, at V-Blank or before the deferred renderer stops seeing the rest of the frame
+static void flush_deferred(struct GbPpu *ppu)
+{
+    gb_ppu_deferred_render(ppu->deferred, ppu);
+
+    for (uint8_t line = 0; line < GB_SCREEN_HEIGHT; ++line)
+    {
+        if (ppu->deferred->lines[line].recorded)
+        {
+            gb_ppu_track_line(ppu, line);
+        }
+    }
+}
 
-    if (GB_BIT_CHECK(ppu->lcd_control, 0))
+// Neither renderer can pick up the other one mid-line, so switching renderers or enabling the LCD starts it over
+static void restart_line(struct GbPpu *ppu)
+{
+    if (ppu->renderer == GB_PPU_RENDERER_FIFO)
     {
-        const uint32_t tile_set_address = GB_BIT_CHECK(ppu->lcd_control, 4) ? 0x8000 : 0x8800;
-        const uint32_t tile_map_address = (!GB_BIT_CHECK(ppu->lcd_control, 3)) ? 0x9800 : 0x9c00;
+        gb_ppu_fifo_restart_line(ppu);
+        return;
+    }
+
+    ppu->dots_counter = 0;
+    if (ppu->ly >= GB_SCREEN_HEIGHT)
+    {
+        ppu->mode = GB_PPU_MODE_VBLANK;
+    }
+    else
+    {
+        ppu->mode = GB_PPU_MODE_OAM_SCAN;
+        handle_oam_scan(ppu);
+    }
+}
+
+void gb_ppu_set_lcd_control(struct GbPpu *ppu, const uint8_t value)
+{
+    const bool was_enabled = GB_BIT_CHECK(ppu->lcd_control, 7);
+    const bool enabled = GB_BIT_CHECK(value, 7);
+    ppu->lcd_control = value;
 
-        const uint32_t y = ppu->ly;
-        for (uint32_t x = 0; x < GB_SCREEN_WIDTH; ++x)
+    if (enabled && !was_enabled)
+    {
+        gb_ppu_start_frame(ppu);
+        ppu->window_triggered = ppu->ly == ppu->wy;
+        restart_line(ppu);
+        gb_ppu_update_stat(ppu);
+    }
+    else if (!enabled && was_enabled)
+    {
+        if (ppu->renderer == GB_PPU_RENDERER_DEFERRED)
         {
-            const uint32_t scrolled_x = x + ppu->scx;
-            const uint32_t scrolled_y = y + ppu->scy;
+            flush_deferred(ppu);
+        }
 
-            const uint32_t background_map_x = scrolled_x % 256;
-            const uint32_t background_map_y = scrolled_y % 256;
+        // A disabled LCD holds LY at 0 in H-Blank and restarts from the top of the frame once enabled again
+        ppu->ly = 0;
+        ppu->dots_counter = 0;
+        ppu->mode = GB_PPU_MODE_HBLANK;
+        ppu->window_triggered = false;
+        ppu->window_line = 0;
+        ppu->lcd_status &= 0b11111100;
+        ppu->stat_line = false;
+    }
 
-            const uint32_t tile_x = background_map_x / GB_TILE_SIZE;
-            const uint32_t tile_y = background_map_y / GB_TILE_SIZE;
+    gb_ppu_update_next_interrupt(ppu);
+}
 
-            const uint32_t tile_pixel_x = background_map_x % GB_TILE_SIZE;
-            const uint32_t tile_pixel_y = background_map_y % GB_TILE_SIZE;
+void gb_ppu_set_lcd_status(struct GbPpu *ppu, const uint8_t value)
+{
+    // The mode and coincidence bits are read-only
+    ppu->lcd_status = (uint8_t) ((value & 0b01111000) | (ppu->lcd_status & 0b00000111));
+    if (GB_BIT_CHECK(ppu->lcd_control, 7))
+    {
+        gb_ppu_update_stat(ppu);
+    }
 
-            // This number is from the tile map
-#define TILES_PER_LINE 32
-            const uint32_t tile_index = tile_y * TILES_PER_LINE + tile_x;
-            const uint32_t tile_id_address = tile_map_address + tile_index;
+    gb_ppu_update_next_interrupt(ppu);
+}
 
-            const uint8_t tile_id = gb_mmu_read(ppu->mmu, tile_id_address);
+void gb_ppu_set_lyc(struct GbPpu *ppu, const uint8_t value)
+{
+    ppu->lyc = value;
+    if (GB_BIT_CHECK(ppu->lcd_control, 7))
+    {
+        gb_ppu_update_stat(ppu);
+    }
 
-#define TILE_BYTES (2 * 8)
-            const uint32_t tile_data_memory_offset = GB_BIT_CHECK(ppu->lcd_control, 4)
-                ? (tile_id * TILE_BYTES)
-                : ((((int8_t) tile_id) + 128) * TILE_BYTES);
-            const uint32_t tile_data_line_offset = tile_pixel_y * 2;
+    gb_ppu_update_next_interrupt(ppu);
+}
+
+void gb_ppu_set_cgb(struct GbPpu *ppu, const bool enabled)
+{
+    if (enabled && !ppu->cgb)
+    {
+        gb_ppu_set_renderer(ppu, GB_PPU_RENDERER_SCANLINE);
+        ppu->cgb = gb_ppu_cgb_create();
+    }
+    else if (!enabled && ppu->cgb)
+    {
+        gb_ppu_cgb_destroy(ppu->cgb);
+        ppu->cgb = NULL;
+        ppu->vram_bank = ppu->vram;
+    }
 
-            const uint32_t tile_line_data_start_address
-                = tile_set_address + tile_data_memory_offset + tile_data_line_offset;
+    // Shades and colors can't be compared, so every line counts as changed
+    memset(ppu->dirty_lines, 0xff, sizeof(ppu->dirty_lines));
+}
 
-            const uint8_t pixels_1 = gb_mmu_read(ppu->mmu, tile_line_data_start_address);
-            const uint8_t pixels_2 = gb_mmu_read(ppu->mmu, tile_line_data_start_address + 1);
+void gb_ppu_set_renderer(struct GbPpu *ppu, const enum GbPpuRenderer renderer)
+{
+    if (ppu->renderer == renderer || (ppu->cgb && renderer != GB_PPU_RENDERER_SCANLINE))
+    {
+        return;
+    }
 
-            const uint8_t color
-                = (GB_BIT_VALUE(pixels_2, 7 - tile_pixel_x) << 1) | GB_BIT_VALUE(pixels_1, 7 - tile_pixel_x);
-            ppu->screen[y * GB_SCREEN_WIDTH + x] = (enum GbColor) color;
+    if (ppu->renderer == GB_PPU_RENDERER_DEFERRED)
+    {
+        flush_deferred(ppu);
+    }
+
+    ppu->renderer = renderer;
+    if (renderer == GB_PPU_RENDERER_DEFERRED)
+    {
+        if (!ppu->deferred)
+        {
+            ppu->deferred = gb_ppu_deferred_create(GB_PPU_DEFERRED_THREADS);
         }
+
+        gb_ppu_deferred_begin_frame(ppu->deferred, ppu);
     }
 
-    // Draw Window
-    if (GB_BIT_CHECK(ppu->lcd_control, 5))
+    if (GB_BIT_CHECK(ppu->lcd_control, 7))
     {
+        restart_line(ppu);
     }
+
+    gb_ppu_update_next_interrupt(ppu);
 }
 
-static void handle_vblank(struct GbPpu *ppu) { gb_cpu_request_interrupt(ppu->cpu, 0); }
+bool gb_ppu_set_compositor(struct GbPpu *ppu, const enum GbPpuCompositor compositor)
+{
+    if (!gb_ppu_compositor_is_supported(compositor))
+    {
+        return false;
+    }
+
+    ppu->compositor = compositor;
+    return true;
+}
+
+void gb_ppu_set_tile_map_cache(struct GbPpu *ppu, const bool enabled)
+{
+    if (enabled && !ppu->tile_map_cache)
+    {
+        ppu->tile_map_cache = gb_ppu_tile_map_cache_create();
+    }
+    else if (!enabled && ppu->tile_map_cache)
+    {
+        gb_ppu_tile_map_cache_destroy(ppu->tile_map_cache);
+        ppu->tile_map_cache = NULL;
+    }
+}
 
-void gb_ppu_tick(struct GbPpu *ppu, const uint8_t t_cycles)
+void gb_ppu_set_render_policy(struct GbPpu *ppu, const enum GbPpuRenderPolicy policy, const uint32_t interval)
 {
-    ppu->dots_counter += t_cycles;
+    ppu->render_policy = policy;
+    ppu->render_interval = interval == 0 ? 1 : interval;
+    ppu->frame_counter = 0;
+}
 
-    switch (ppu->mode)
+void gb_ppu_request_frame(struct GbPpu *ppu) { ppu->frame_requested = true; }
+
+void gb_ppu_start_frame(struct GbPpu *ppu)
+{
+    switch (ppu->render_policy)
     {
-    case GB_PPU_MODE_OAM_SCAN:
-        if (ppu->dots_counter >= PPU_MODE_OAM_SCAN_DOTS)
+    case GB_PPU_RENDER_EVERY_NTH:
+        ppu->render_frame = ppu->frame_counter % ppu->render_interval == 0;
+        break;
+    case GB_PPU_RENDER_ON_REQUEST:
+        ppu->render_frame = ppu->frame_requested;
+        ppu->frame_requested = false;
+        break;
+    case GB_PPU_RENDER_NEVER:
+        ppu->render_frame = false;
+        break;
+    default:
+        ppu->render_frame = true;
+        break;
+    }
+
+    ppu->frame_counter += 1;
+
+    if (ppu->renderer == GB_PPU_RENDERER_DEFERRED)
+    {
+        gb_ppu_deferred_begin_frame(ppu->deferred, ppu);
+    }
+}
+
+void gb_ppu_track_line(struct GbPpu *ppu, const uint8_t line)
+{
+    if (ppu->cgb)
+    {
+        if (gb_ppu_cgb_track_line(ppu, line))
         {
-            ppu->dots_counter -= PPU_MODE_OAM_SCAN_DOTS;
-            ppu->mode = GB_PPU_MODE_DRAWING;
+            ppu->dirty_lines[line / 64] |= GB_BIT(line % 64);
+        }
 
-            handle_drawing(ppu);
+        return;
+    }
+
+    const uint16_t *pixels = &ppu->screen[line * GB_SCREEN_WIDTH];
+
+    uint8_t shades[GB_SCREEN_WIDTH / 4];
+    for (uint32_t i = 0; i < GB_SCREEN_WIDTH / 4; ++i)
+    {
+        const uint16_t *group = &pixels[i * 4];
+        shades[i] = (uint8_t) (group[0] | (group[1] << 2) | (group[2] << 4) | (group[3] << 6));
+    }
+
+    if (memcmp(ppu->line_shades[line], shades, sizeof(shades)) != 0)
+    {
+        memcpy(ppu->line_shades[line], shades, sizeof(shades));
+        ppu->dirty_lines[line / 64] |= GB_BIT(line % 64);
+    }
+}
+
+void gb_ppu_finish_frame(struct GbPpu *ppu)
+{
+    ppu->vblank_count += 1;
+
+    // Skipped frames left the back buffer alone, so there is nothing new to show
+    if (!ppu->render_frame)
+    {
+        return;
+    }
+
+    ppu->screen = gb_ppu_frame_buffers_present(ppu->frame_buffers, ppu->screen, ppu->dirty_lines);
+    memset(ppu->dirty_lines, 0, sizeof(ppu->dirty_lines));
+
+    if (ppu->frame_callback)
+    {
+        ppu->frame_callback(ppu->frame_callback_data);
+    }
+}
+
+void gb_ppu_set_frame_callback(struct GbPpu *ppu, void (*callback)(void *user_data), void *user_data)
+{
+    ppu->frame_callback = callback;
+    ppu->frame_callback_data = user_data;
+}
+
+const uint16_t *gb_ppu_take_frame(struct GbPpu *ppu, uint64_t lines[GB_PPU_DIRTY_WORDS])
+{
+    return gb_ppu_frame_buffers_take(ppu->frame_buffers, lines);
+}
+
+static uint8_t get_object_height(struct GbPpu *ppu) { return GB_BIT_CHECK(ppu->lcd_control, 2) ? 16 : 8; }
+
+static void rebuild_object_cache(struct GbPpu *ppu)
+{
+    const uint8_t height = get_object_height(ppu);
+
+    memset(ppu->object_cache_counts, 0, sizeof(ppu->object_cache_counts));
+
+    // Objects are visited in OAM order, so every bucket ends up with the first 10 objects on its line
+    for (uint8_t object = 0; object < GB_PPU_OBJECT_COUNT; ++object)
+    {
+        const int32_t top = (int32_t) ppu->oam[object * 4] - 16;
+        const int32_t first_line = top < 0 ? 0 : top;
+        const int32_t last_line = top + height > GB_SCREEN_HEIGHT ? GB_SCREEN_HEIGHT : top + height;
+
+        for (int32_t line = first_line; line < last_line; ++line)
+        {
+            uint8_t *count = &ppu->object_cache_counts[line];
+            if (*count < GB_PPU_OBJECTS_PER_LINE)
+            {
+                ppu->object_cache[line][*count] = object;
+                *count += 1;
+            }
         }
-        break;
-    case GB_PPU_MODE_DRAWING:
-        if (ppu->dots_counter >= PPU_MODE_DRAWING_DOTS)
+    }
+
+    ppu->object_cache_height = height;
+    ppu->object_cache_dirty = false;
+}
+
+static void handle_oam_scan(struct GbPpu *ppu)
+{
+    ppu->line_object_count = 0;
+
+    if (ppu->ly >= GB_SCREEN_HEIGHT)
+    {
+        return;
+    }
+
+    // Once LY matched WY the window stays triggered for the rest of the frame
+    if (ppu->ly == ppu->wy)
+    {
+        ppu->window_triggered = true;
+    }
+
+    if (!ppu->render_frame)
+    {
+        return;
+    }
+
+    if (ppu->renderer == GB_PPU_RENDERER_DEFERRED)
+    {
+        gb_ppu_deferred_record_scan(ppu->deferred, ppu);
+        return;
+    }
+
+    gb_ppu_select_line_objects(ppu);
+}
+
+void gb_ppu_select_line_objects(struct GbPpu *ppu)
+{
+    if (ppu->object_cache_dirty || ppu->object_cache_height != get_object_height(ppu))
+    {
+        rebuild_object_cache(ppu);
+    }
+
+    // Sort by X so that objects further left win, the stable insertion keeps OAM order on ties. The CGB only goes by
+    // OAM order, which the cache already has
+    const uint8_t count = ppu->object_cache_counts[ppu->ly];
+    if (ppu->cgb)
+    {
+        memcpy(ppu->line_objects, ppu->object_cache[ppu->ly], count);
+        ppu->line_object_count = count;
+        return;
+    }
+
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        const uint8_t object = ppu->object_cache[ppu->ly][i];
+        const uint8_t x = ppu->oam[object * 4 + 1];
+
+        uint8_t position = i;
+        while (position > 0 && ppu->oam[ppu->line_objects[position - 1] * 4 + 1] > x)
         {
-            ppu->dots_counter -= PPU_MODE_DRAWING_DOTS;
-            ppu->mode = GB_PPU_MODE_HBLANK;
+            ppu->line_objects[position] = ppu->line_objects[position - 1];
+            position -= 1;
+        }
 
-            handle_hblank(ppu);
+        ppu->line_objects[position] = object;
+    }
+
+    ppu->line_object_count = count;
+}
+
+static void handle_drawing(struct GbPpu *ppu) { (void) ppu; }
+
+// Decodes `count` pixels of a tile map row starting at `map_x`, wrapping around the 256 pixel wide map
+static void fetch_tile_row(
+    struct GbPpu *ppu,
+    const uint32_t tile_map_address,
+    const uint8_t map_x,
+    const uint8_t map_y,
+    const uint32_t count,
+    uint8_t *output)
+{
+    if (ppu->tile_map_cache)
+    {
+        gb_ppu_tile_map_cache_fetch_row(ppu, tile_map_address, map_x, map_y, count, output);
+        return;
+    }
+
+    const bool unsigned_tiles = GB_BIT_CHECK(ppu->lcd_control, 4);
+    const uint32_t map_row_address = tile_map_address + (map_y / GB_TILE_SIZE) * TILES_PER_LINE;
+    const uint32_t tile_data_line_offset = (map_y % GB_TILE_SIZE) * 2;
+
+    // Whole tiles are decoded into a tile aligned row, the first `skip` pixels are scrolled out
+    const uint32_t skip = map_x % GB_TILE_SIZE;
+    const uint32_t tile_count = (skip + count + GB_TILE_SIZE - 1) / GB_TILE_SIZE;
+
+    uint8_t row[GB_SCREEN_WIDTH + 2 * GB_TILE_SIZE];
+    for (uint32_t tile = 0; tile < tile_count; ++tile)
+    {
+        const uint32_t tile_x = (map_x / GB_TILE_SIZE + tile) % TILES_PER_LINE;
+        const uint8_t tile_id = ppu->vram[map_row_address + tile_x];
+
+        const uint32_t tile_data_memory_offset = unsigned_tiles
+            ? (uint32_t) (tile_id * TILE_BYTES)
+            : (uint32_t) (0x0800 + (((int8_t) tile_id) + 128) * TILE_BYTES);
+        const uint32_t tile_line_data_start_address = tile_data_memory_offset + tile_data_line_offset;
+
+        const uint8_t pixels_1 = ppu->vram[tile_line_data_start_address];
+        const uint8_t pixels_2 = ppu->vram[tile_line_data_start_address + 1];
+
+        uint8_t *pixels = &row[tile * GB_TILE_SIZE];
+        for (uint32_t pixel = 0; pixel < GB_TILE_SIZE; ++pixel)
+        {
+            const uint32_t bit = 7 - pixel;
+            pixels[pixel] = (uint8_t) ((GB_BIT_VALUE(pixels_2, bit) << 1) | GB_BIT_VALUE(pixels_1, bit));
         }
-        break;
-    case GB_PPU_MODE_HBLANK:
-        if (ppu->dots_counter >= PPU_MODE_H_BLANK_DOTS)
+    }
+
+    memcpy(output, &row[skip], count);
+}
+
+static void render_background(struct GbPpu *ppu)
+{
+    const uint32_t tile_map_address = (!GB_BIT_CHECK(ppu->lcd_control, 3)) ? 0x1800 : 0x1c00;
+    const uint8_t map_x = ppu->scx;
+    const uint8_t map_y = (uint8_t) (ppu->ly + ppu->scy);
+
+    fetch_tile_row(ppu, tile_map_address, map_x, map_y, GB_SCREEN_WIDTH, ppu->line.bg);
+}
+
+static bool is_window_visible(struct GbPpu *ppu)
+{
+    return GB_BIT_CHECK(ppu->lcd_control, 5) && ppu->window_triggered && ppu->wx <= 166;
+}
+
+static void render_window(struct GbPpu *ppu)
+{
+    const uint32_t tile_map_address = (!GB_BIT_CHECK(ppu->lcd_control, 6)) ? 0x1800 : 0x1c00;
+
+    // WX values below 7 move the left edge of the window off screen
+    const int32_t window_x = (int32_t) ppu->wx - 7;
+    const uint32_t first_x = window_x < 0 ? 0 : (uint32_t) window_x;
+    const uint8_t map_x = window_x < 0 ? (uint8_t) -window_x : 0;
+
+    fetch_tile_row(
+        ppu, tile_map_address, map_x, ppu->window_line, GB_SCREEN_WIDTH - first_x, &ppu->line.bg[first_x]);
+}
+
+static void render_objects(struct GbPpu *ppu)
+{
+    const uint8_t height = get_object_height(ppu);
+
+    // Objects are drawn in priority order, so a pixel is only taken if no earlier object is opaque there
+    for (uint8_t i = 0; i < ppu->line_object_count; ++i)
+    {
+        const uint8_t *object = &ppu->oam[ppu->line_objects[i] * 4];
+        const int32_t object_y = (int32_t) object[0] - 16;
+        const int32_t object_x = (int32_t) object[1] - 8;
+        const uint8_t attributes = object[3];
+
+        uint8_t tile_id = object[2];
+        uint8_t row = (uint8_t) (ppu->ly - object_y);
+        if (GB_BIT_CHECK(attributes, 6))
+        {
+            row = (uint8_t) (height - 1 - row);
+        }
+
+        // 8x16 objects ignore bit 0 of the tile index and continue into the next tile
+        if (height == 16)
+        {
+            tile_id = (uint8_t) ((tile_id & 0xfe) + row / GB_TILE_SIZE);
+            row %= GB_TILE_SIZE;
+        }
+
+        const uint32_t tile_line_address = (uint32_t) (tile_id * TILE_BYTES + row * 2);
+        const uint8_t pixels_1 = ppu->vram[tile_line_address];
+        const uint8_t pixels_2 = ppu->vram[tile_line_address + 1];
+
+        uint8_t flags = 0;
+        if (GB_BIT_CHECK(attributes, 4))
+        {
+            flags |= GB_OBJ_PIXEL_PALETTE;
+        }
+
+        if (GB_BIT_CHECK(attributes, 7))
+        {
+            flags |= GB_OBJ_PIXEL_BG_PRIORITY;
+        }
+
+        const bool x_flip = GB_BIT_CHECK(attributes, 5);
+        for (int32_t pixel = 0; pixel < GB_TILE_SIZE; ++pixel)
+        {
+            const int32_t x = object_x + pixel;
+            if (x < 0 || x >= GB_SCREEN_WIDTH || (ppu->line.obj[x] & GB_OBJ_PIXEL_COLOR_MASK) != 0)
+            {
+                continue;
+            }
+
+            const uint32_t bit = x_flip ? (uint32_t) pixel : (uint32_t) (7 - pixel);
+            const uint8_t color = (uint8_t) ((GB_BIT_VALUE(pixels_2, bit) << 1) | GB_BIT_VALUE(pixels_1, bit));
+            if (color != 0)
+            {
+                ppu->line.obj[x] = color | flags;
+            }
+        }
+    }
+}
+
+void gb_ppu_draw_line(struct GbPpu *ppu)
+{
+    if (ppu->cgb)
+    {
+        gb_ppu_cgb_draw_line(ppu);
+        return;
+    }
+
+    // Draw Background
+    const bool background_enabled = GB_BIT_CHECK(ppu->lcd_control, 0);
+    if (background_enabled)
+    {
+        render_background(ppu);
+    }
+    else
+    {
+        memset(ppu->line.bg, 0, sizeof(ppu->line.bg));
+    }
+
+    // Draw Window
+    if (background_enabled && is_window_visible(ppu))
+    {
+        render_window(ppu);
+    }
+
+    // Draw Objects
+    memset(ppu->line.obj, 0, sizeof(ppu->line.obj));
+    if (GB_BIT_CHECK(ppu->lcd_control, 1))
+    {
+        render_objects(ppu);
+    }
+
+    // With the background disabled the line is blank, which BGP = 0 maps to white
+    gb_ppu_compose_line(
+        ppu->compositor,
+        &ppu->line,
+        background_enabled ? ppu->bgp : 0x00,
+        ppu->obp0,
+        ppu->obp1,
+        &ppu->screen[ppu->ly * GB_SCREEN_WIDTH]);
+}
+
+static void handle_hblank(struct GbPpu *ppu)
+{
+    if (ppu->ly >= GB_SCREEN_HEIGHT)
+    {
+        return;
+    }
+
+    // Skipped frames only keep the window line counter going
+    if (ppu->render_frame)
+    {
+        if (ppu->renderer == GB_PPU_RENDERER_DEFERRED)
+        {
+            gb_ppu_deferred_record_line(ppu->deferred, ppu);
+        }
+        else
         {
-            ppu->dots_counter -= PPU_MODE_H_BLANK_DOTS;
+            gb_ppu_draw_line(ppu);
+            gb_ppu_track_line(ppu, ppu->ly);
+        }
+    }
 
+    // The line counter only advances on lines that showed the window
+    if (is_window_visible(ppu))
+    {
+        ppu->window_line += 1;
+    }
+
+    // The line was drawn during mode 3, so the block only shows up from the next line on
+    if (ppu->cgb && ppu->cgb->dma_active)
+    {
+        gb_ppu_cgb_copy_dma_block(ppu);
+    }
+}
+
+static void handle_vblank(struct GbPpu *ppu)
+{
+    if (ppu->renderer == GB_PPU_RENDERER_DEFERRED)
+    {
+        flush_deferred(ppu);
+    }
+
+    ppu->window_triggered = false;
+    ppu->window_line = 0;
+
+    gb_ppu_finish_frame(ppu);
+    gb_cpu_request_interrupt(ppu->cpu, GB_INTERRUPT_VBLANK);
+}
+
+static void advance_scanline(struct GbPpu *ppu, uint64_t dots)
+{
+    while (dots != 0)
+    {
+        const uint16_t remaining_dots = get_mode_dots(ppu->mode) - ppu->dots_counter;
+        if (dots < remaining_dots)
+        {
+            ppu->dots_counter += (uint16_t) dots;
+            return;
+        }
+
+        dots -= remaining_dots;
+        ppu->dots_counter = 0;
+
+        switch (ppu->mode)
+        {
+        case GB_PPU_MODE_OAM_SCAN:
+            ppu->mode = GB_PPU_MODE_DRAWING;
+            handle_drawing(ppu);
+            break;
+        case GB_PPU_MODE_DRAWING:
+            ppu->mode = GB_PPU_MODE_HBLANK;
+            handle_hblank(ppu);
+            break;
+        case GB_PPU_MODE_HBLANK:
             ppu->ly += 1;
 
-            if (ppu->ly >= 0x90)
+            if (ppu->ly >= GB_SCREEN_HEIGHT)
             {
                 ppu->mode = GB_PPU_MODE_VBLANK;
                 handle_vblank(ppu);
@@ -163,23 +834,52 @@ void gb_ppu_tick(struct GbPpu *ppu, const uint8_t t_cycles)
                 ppu->mode = GB_PPU_MODE_OAM_SCAN;
                 handle_oam_scan(ppu);
             }
-        }
-        break;
-    case GB_PPU_MODE_VBLANK:
-        if (ppu->dots_counter >= PPU_MODE_V_BLANK_DOTS)
-        {
-            ppu->dots_counter -= PPU_MODE_V_BLANK_DOTS;
+            break;
+        case GB_PPU_MODE_VBLANK:
             ppu->ly += 1;
 
-            if (ppu->ly >= 0x9a)
+            if (ppu->ly >= PPU_LINES)
             {
                 ppu->mode = GB_PPU_MODE_OAM_SCAN;
                 ppu->ly = 0;
+                gb_ppu_start_frame(ppu);
                 handle_oam_scan(ppu);
             }
+            break;
+        default:
+            break;
         }
+
+        gb_ppu_update_stat(ppu);
+    }
+}
+
+void gb_ppu_sync(struct GbPpu *ppu, const uint64_t cycles)
+{
+    if (cycles <= ppu->cycles)
+    {
+        return;
+    }
+
+    const uint64_t dots = cycles - ppu->cycles;
+    ppu->cycles = cycles;
+
+    if (!GB_BIT_CHECK(ppu->lcd_control, 7))
+    {
+        return;
+    }
+
+    switch (ppu->renderer)
+    {
+    case GB_PPU_RENDERER_FIFO:
+        gb_ppu_fifo_advance(ppu, dots);
         break;
     default:
+        advance_scanline(ppu, dots);
         break;
     }
+
+    gb_ppu_update_next_interrupt(ppu);
 }
+
+void gb_ppu_tick(struct GbPpu *ppu, const uint8_t t_cycles) { gb_ppu_sync(ppu, ppu->cycles + t_cycles); }
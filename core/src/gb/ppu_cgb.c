@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/ppu_cgb.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gb/cpu.h"
+#include "gb/mmu.h"
+#include "gb/ppu.h"
+#include "gb/utils/bits.h"
+
+#define TILES_PER_LINE 32
+#define TILE_BYTES (2 * 8)
+#define PALETTE_COLORS (GB_PPU_CGB_PALETTE_BYTES / 2)
+
+struct GbPpuCgb *gb_ppu_cgb_create(void)
+{
+    struct GbPpuCgb *cgb = calloc(1, sizeof(struct GbPpuCgb));
+
+    // The boot ROM leaves every color white
+    memset(cgb->bg_palettes, 0xff, sizeof(cgb->bg_palettes));
+    memset(cgb->obj_palettes, 0xff, sizeof(cgb->obj_palettes));
+
+    return cgb;
+}
+
+void gb_ppu_cgb_destroy(struct GbPpuCgb *cgb) { free(cgb); }
+
+void gb_ppu_cgb_set_vram_bank(struct GbPpu *ppu, const uint8_t value)
+{
+    struct GbPpuCgb *cgb = ppu->cgb;
+    cgb->vram_bank = value & 0x01;
+    ppu->vram_bank = cgb->vram_bank != 0 ? cgb->vram : ppu->vram;
+}
+
+uint8_t gb_ppu_cgb_get_vram_bank(struct GbPpu *ppu) { return (uint8_t) (ppu->cgb->vram_bank | 0xfe); }
+
+static void write_palette_data(uint8_t *palettes, uint8_t *index, const uint8_t value)
+{
+    palettes[*index & 0x3f] = value;
+    if (GB_BIT_CHECK(*index, 7))
+    {
+        *index = (uint8_t) ((*index & 0x80) | ((*index + 1) & 0x3f));
+    }
+}
+
+void gb_ppu_cgb_write_palette(struct GbPpu *ppu, const uint16_t address, const uint8_t value)
+{
+    struct GbPpuCgb *cgb = ppu->cgb;
+    switch (address)
+    {
+    case 0xff68:
+        cgb->bg_palette_index = value & 0xbf;
+        break;
+    case 0xff69:
+        write_palette_data(cgb->bg_palettes, &cgb->bg_palette_index, value);
+        break;
+    case 0xff6a:
+        cgb->obj_palette_index = value & 0xbf;
+        break;
+    default:
+        write_palette_data(cgb->obj_palettes, &cgb->obj_palette_index, value);
+        break;
+    }
+}
+
+uint8_t gb_ppu_cgb_read_palette(struct GbPpu *ppu, const uint16_t address)
+{
+    const struct GbPpuCgb *cgb = ppu->cgb;
+    switch (address)
+    {
+    case 0xff68:
+        return (uint8_t) (cgb->bg_palette_index | 0x40);
+    case 0xff69:
+        return cgb->bg_palettes[cgb->bg_palette_index & 0x3f];
+    case 0xff6a:
+        return (uint8_t) (cgb->obj_palette_index | 0x40);
+    default:
+        return cgb->obj_palettes[cgb->obj_palette_index & 0x3f];
+    }
+}
+
+static void copy_dma_block(struct GbPpu *ppu)
+{
+    struct GbPpuCgb *cgb = ppu->cgb;
+
+    // The whole block is copied at once, into whichever bank the CPU sees
+    for (uint16_t i = 0; i < GB_PPU_CGB_DMA_BLOCK_SIZE; ++i)
+    {
+        const uint8_t value = gb_mmu_read(ppu->mmu, (uint16_t) (cgb->dma_source + i));
+        gb_ppu_write(ppu, (uint16_t) ((cgb->dma_destination + i) & 0x1fff), value);
+    }
+
+    cgb->dma_source = (uint16_t) (cgb->dma_source + GB_PPU_CGB_DMA_BLOCK_SIZE);
+    cgb->dma_destination = (uint16_t) ((cgb->dma_destination + GB_PPU_CGB_DMA_BLOCK_SIZE) & 0x1fff);
+    cgb->dma_blocks -= 1;
+}
+
+uint32_t gb_ppu_cgb_write_dma(struct GbPpu *ppu, const uint16_t address, const uint8_t value)
+{
+    struct GbPpuCgb *cgb = ppu->cgb;
+    switch (address)
+    {
+    case 0xff51:
+        cgb->dma_source = (uint16_t) ((cgb->dma_source & 0x00ff) | (value << 8));
+        return 0;
+    case 0xff52:
+        cgb->dma_source = (uint16_t) ((cgb->dma_source & 0xff00) | (value & 0xf0));
+        return 0;
+    case 0xff53:
+        cgb->dma_destination = (uint16_t) ((cgb->dma_destination & 0x00ff) | ((value & 0x1f) << 8));
+        return 0;
+    case 0xff54:
+        cgb->dma_destination = (uint16_t) ((cgb->dma_destination & 0x1f00) | (value & 0xf0));
+        return 0;
+    default:
+        break;
+    }
+
+    // Clearing bit 7 while an H-Blank DMA runs stops it, the blocks it has left stay readable
+    if (cgb->dma_active && !GB_BIT_CHECK(value, 7))
+    {
+        cgb->dma_active = false;
+        gb_ppu_update_next_interrupt(ppu);
+        return 0;
+    }
+
+    cgb->dma_blocks = (uint8_t) ((value & 0x7f) + 1);
+    if (GB_BIT_CHECK(value, 7))
+    {
+        cgb->dma_active = true;
+        gb_ppu_update_next_interrupt(ppu);
+        return 0;
+    }
+
+    const uint32_t blocks = cgb->dma_blocks;
+    while (cgb->dma_blocks != 0)
+    {
+        copy_dma_block(ppu);
+    }
+
+    return blocks * GB_PPU_CGB_DMA_BLOCK_CYCLES;
+}
+
+uint8_t gb_ppu_cgb_read_dma(struct GbPpu *ppu, const uint16_t address)
+{
+    if (address != 0xff55)
+    {
+        return 0xff;
+    }
+
+    // A finished DMA has 0 blocks left, which reads as 0xff
+    const struct GbPpuCgb *cgb = ppu->cgb;
+    return (uint8_t) ((cgb->dma_active ? 0x00 : 0x80) | ((cgb->dma_blocks - 1) & 0x7f));
+}
+
+void gb_ppu_cgb_copy_dma_block(struct GbPpu *ppu)
+{
+    // The CPU stalls for the block like it does for every block of a general purpose DMA
+    copy_dma_block(ppu);
+    ppu->cpu->cycles += GB_PPU_CGB_DMA_BLOCK_CYCLES;
+    if (ppu->cgb->dma_blocks == 0)
+    {
+        ppu->cgb->dma_active = false;
+    }
+}
+
+// Decodes `count` pixels of a tile map row with the palette and priority of every tile, like the DMG version in ppu.c
+static void fetch_tile_row(
+    struct GbPpu *ppu,
+    const uint32_t tile_map_address,
+    const uint8_t map_x,
+    const uint8_t map_y,
+    const uint32_t count,
+    uint8_t *output)
+{
+    const struct GbPpuCgb *cgb = ppu->cgb;
+    const bool unsigned_tiles = GB_BIT_CHECK(ppu->lcd_control, 4);
+    const uint32_t map_row_address = tile_map_address + (map_y / GB_TILE_SIZE) * TILES_PER_LINE;
+
+    const uint32_t skip = map_x % GB_TILE_SIZE;
+    const uint32_t tile_count = (skip + count + GB_TILE_SIZE - 1) / GB_TILE_SIZE;
+
+    uint8_t row[GB_SCREEN_WIDTH + 2 * GB_TILE_SIZE];
+    for (uint32_t tile = 0; tile < tile_count; ++tile)
+    {
+        // Bank 1 holds the attributes of the tile at the same position in the map
+        const uint32_t map_address = map_row_address + (map_x / GB_TILE_SIZE + tile) % TILES_PER_LINE;
+        const uint8_t tile_id = ppu->vram[map_address];
+        const uint8_t attributes = cgb->vram[map_address];
+
+        const uint32_t tile_data_memory_offset = unsigned_tiles
+            ? (uint32_t) (tile_id * TILE_BYTES)
+            : (uint32_t) (0x0800 + (((int8_t) tile_id) + 128) * TILE_BYTES);
+        const uint32_t tile_line = GB_BIT_CHECK(attributes, 6) ? 7 - map_y % GB_TILE_SIZE : map_y % GB_TILE_SIZE;
+        const uint8_t *bank = GB_BIT_CHECK(attributes, 3) ? cgb->vram : ppu->vram;
+
+        const uint8_t pixels_1 = bank[tile_data_memory_offset + tile_line * 2];
+        const uint8_t pixels_2 = bank[tile_data_memory_offset + tile_line * 2 + 1];
+
+        const uint8_t flags
+            = (uint8_t) (((attributes & 0x07) << GB_BG_PIXEL_PALETTE_SHIFT) | (attributes & GB_BG_PIXEL_PRIORITY));
+        const bool x_flip = GB_BIT_CHECK(attributes, 5);
+
+        uint8_t *pixels = &row[tile * GB_TILE_SIZE];
+        for (uint32_t pixel = 0; pixel < GB_TILE_SIZE; ++pixel)
+        {
+            const uint32_t bit = x_flip ? pixel : 7 - pixel;
+            pixels[pixel] = (uint8_t) ((GB_BIT_VALUE(pixels_2, bit) << 1) | GB_BIT_VALUE(pixels_1, bit) | flags);
+        }
+    }
+
+    memcpy(output, &row[skip], count);
+}
+
+static bool is_window_visible(struct GbPpu *ppu)
+{
+    return GB_BIT_CHECK(ppu->lcd_control, 5) && ppu->window_triggered && ppu->wx <= 166;
+}
+
+static void render_window(struct GbPpu *ppu)
+{
+    const uint32_t tile_map_address = (!GB_BIT_CHECK(ppu->lcd_control, 6)) ? 0x1800 : 0x1c00;
+    const int32_t window_x = (int32_t) ppu->wx - 7;
+    const uint32_t first_x = window_x < 0 ? 0 : (uint32_t) window_x;
+    const uint8_t map_x = window_x < 0 ? (uint8_t) -window_x : 0;
+
+    fetch_tile_row(
+        ppu, tile_map_address, map_x, ppu->window_line, GB_SCREEN_WIDTH - first_x, &ppu->line.bg[first_x]);
+}
+
+static void render_objects(struct GbPpu *ppu)
+{
+    const struct GbPpuCgb *cgb = ppu->cgb;
+    const uint8_t height = GB_BIT_CHECK(ppu->lcd_control, 2) ? 16 : 8;
+
+    for (uint8_t i = 0; i < ppu->line_object_count; ++i)
+    {
+        const uint8_t *object = &ppu->oam[ppu->line_objects[i] * 4];
+        const int32_t object_y = (int32_t) object[0] - 16;
+        const int32_t object_x = (int32_t) object[1] - 8;
+        const uint8_t attributes = object[3];
+
+        uint8_t tile_id = object[2];
+        uint8_t row = (uint8_t) (ppu->ly - object_y);
+        if (GB_BIT_CHECK(attributes, 6))
+        {
+            row = (uint8_t) (height - 1 - row);
+        }
+
+        if (height == 16)
+        {
+            tile_id = (uint8_t) ((tile_id & 0xfe) + row / GB_TILE_SIZE);
+            row %= GB_TILE_SIZE;
+        }
+
+        const uint8_t *bank = GB_BIT_CHECK(attributes, 3) ? cgb->vram : ppu->vram;
+        const uint32_t tile_line_address = (uint32_t) (tile_id * TILE_BYTES + row * 2);
+        const uint8_t pixels_1 = bank[tile_line_address];
+        const uint8_t pixels_2 = bank[tile_line_address + 1];
+
+        uint8_t flags = (uint8_t) ((attributes & 0x07) << GB_OBJ_PIXEL_CGB_PALETTE_SHIFT);
+        if (GB_BIT_CHECK(attributes, 7))
+        {
+            flags |= GB_OBJ_PIXEL_BG_PRIORITY;
+        }
+
+        const bool x_flip = GB_BIT_CHECK(attributes, 5);
+        for (int32_t pixel = 0; pixel < GB_TILE_SIZE; ++pixel)
+        {
+            const int32_t x = object_x + pixel;
+            if (x < 0 || x >= GB_SCREEN_WIDTH || (ppu->line.obj[x] & GB_OBJ_PIXEL_COLOR_MASK) != 0)
+            {
+                continue;
+            }
+
+            const uint32_t bit = x_flip ? (uint32_t) pixel : (uint32_t) (7 - pixel);
+            const uint8_t color = (uint8_t) ((GB_BIT_VALUE(pixels_2, bit) << 1) | GB_BIT_VALUE(pixels_1, bit));
+            if (color != 0)
+            {
+                ppu->line.obj[x] = color | flags;
+            }
+        }
+    }
+}
+
+static void decode_palettes(const uint8_t *palettes, uint16_t colors[PALETTE_COLORS])
+{
+    for (uint32_t i = 0; i < PALETTE_COLORS; ++i)
+    {
+        colors[i] = (uint16_t) ((palettes[i * 2] | (palettes[i * 2 + 1] << 8)) & 0x7fff);
+    }
+}
+
+static void compose_line(struct GbPpu *ppu)
+{
+    uint16_t bg_colors[PALETTE_COLORS];
+    uint16_t obj_colors[PALETTE_COLORS];
+    decode_palettes(ppu->cgb->bg_palettes, bg_colors);
+    decode_palettes(ppu->cgb->obj_palettes, obj_colors);
+
+    // LCDC bit 0 is the master priority, without it objects are drawn over everything
+    const bool bg_priority = GB_BIT_CHECK(ppu->lcd_control, 0);
+
+    uint16_t *output = &ppu->screen[ppu->ly * GB_SCREEN_WIDTH];
+    for (uint32_t x = 0; x < GB_SCREEN_WIDTH; ++x)
+    {
+        const uint8_t bg = ppu->line.bg[x];
+        const uint8_t obj = ppu->line.obj[x];
+        const uint8_t bg_color = bg & GB_BG_PIXEL_COLOR_MASK;
+
+        const bool bg_over_obj = bg_priority && bg_color != 0
+            && ((bg & GB_BG_PIXEL_PRIORITY) != 0 || (obj & GB_OBJ_PIXEL_BG_PRIORITY) != 0);
+        const uint16_t color = (obj & GB_OBJ_PIXEL_COLOR_MASK) != 0 && !bg_over_obj
+            ? obj_colors[((obj >> GB_OBJ_PIXEL_CGB_PALETTE_SHIFT) & 0x07) * 4 + (obj & GB_OBJ_PIXEL_COLOR_MASK)]
+            : bg_colors[((bg >> GB_BG_PIXEL_PALETTE_SHIFT) & 0x07) * 4 + bg_color];
+        output[x] = color;
+    }
+}
+
+void gb_ppu_cgb_draw_line(struct GbPpu *ppu)
+{
+    // The background can't be turned off on the CGB, LCDC bit 0 only takes away its priority
+    const uint32_t tile_map_address = (!GB_BIT_CHECK(ppu->lcd_control, 3)) ? 0x1800 : 0x1c00;
+    fetch_tile_row(ppu, tile_map_address, ppu->scx, (uint8_t) (ppu->ly + ppu->scy), GB_SCREEN_WIDTH, ppu->line.bg);
+
+    if (is_window_visible(ppu))
+    {
+        render_window(ppu);
+    }
+
+    memset(ppu->line.obj, 0, sizeof(ppu->line.obj));
+    if (GB_BIT_CHECK(ppu->lcd_control, 1))
+    {
+        render_objects(ppu);
+    }
+
+    compose_line(ppu);
+}
+
+bool gb_ppu_cgb_track_line(struct GbPpu *ppu, const uint8_t line)
+{
+    const uint16_t *pixels = &ppu->screen[line * GB_SCREEN_WIDTH];
+    if (memcmp(ppu->cgb->line_colors[line], pixels, sizeof(ppu->cgb->line_colors[line])) == 0)
+    {
+        return false;
+    }
+
+    memcpy(ppu->cgb->line_colors[line], pixels, sizeof(ppu->cgb->line_colors[line]));
+    return true;
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/ppu_compositor.h"
+
+#include <assert.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#    define GB_COMPOSITOR_X86 1
+#    include <immintrin.h>
+#    if defined(_MSC_VER) && !defined(__clang__)
+#        include <intrin.h>
+#    endif
+#else
+#    define GB_COMPOSITOR_X86 0
+#endif
+
+#if GB_COMPOSITOR_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#    define GB_COMPOSITOR_SSE2 1
+#else
+#    define GB_COMPOSITOR_SSE2 0
+#endif
+
+#if GB_COMPOSITOR_X86
+#    define GB_COMPOSITOR_AVX2 1
+#    if defined(__GNUC__) || defined(__clang__)
+#        define GB_TARGET_AVX2 __attribute__((target("avx2")))
+#    else
+#        define GB_TARGET_AVX2
+#    endif
+#else
+#    define GB_COMPOSITOR_AVX2 0
+#endif
+
+static_assert(GB_SCREEN_WIDTH % 32 == 0, "The SIMD compositors expect whole vectors per line");
+
+// Entries 0-3 are BGP, 4-7 are OBP0 and 8-11 are OBP1, matching `obj & 0b111` + 4
+static void build_palette_lut(const uint8_t bgp, const uint8_t obp0, const uint8_t obp1, uint8_t lut[16])
+{
+    const uint8_t palettes[3] = { bgp, obp0, obp1 };
+    for (uint32_t i = 0; i < 12; ++i)
+    {
+        lut[i] = (palettes[i / 4] >> ((i % 4) * 2)) & 0b11;
+    }
+
+    for (uint32_t i = 12; i < 16; ++i)
+    {
+        lut[i] = 0;
+    }
+}
+
+static void compose_line_scalar(const struct GbPpuLine *line, const uint8_t lut[16], uint16_t *output)
+{
+    for (uint32_t x = 0; x < GB_SCREEN_WIDTH; ++x)
+    {
+        const uint8_t bg = line->bg[x];
+        const uint8_t obj = line->obj[x];
+
+        const bool obj_transparent = (obj & GB_OBJ_PIXEL_COLOR_MASK) == 0;
+        const bool obj_behind_bg = (obj & GB_OBJ_PIXEL_BG_PRIORITY) != 0 && bg != 0;
+        const uint8_t index = (obj_transparent || obj_behind_bg) ? bg : (uint8_t) ((obj & 0b0111) + 4);
+
+        output[x] = lut[index];
+    }
+}
+
+#if GB_COMPOSITOR_SSE2
+static void compose_line_sse2(const struct GbPpuLine *line, const uint8_t lut[16], uint16_t *output)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i color_mask = _mm_set1_epi8(GB_OBJ_PIXEL_COLOR_MASK);
+    const __m128i priority_mask = _mm_set1_epi8(GB_OBJ_PIXEL_BG_PRIORITY);
+    const __m128i palette_mask = _mm_set1_epi8(GB_OBJ_PIXEL_PALETTE);
+    const __m128i shade_mask = _mm_set1_epi8(0b11);
+
+    // SSE2 has no byte shuffle, so the shade is selected from the per-pixel palette instead of a table lookup
+    const __m128i bgp = _mm_set1_epi8((char) (lut[0] | (lut[1] << 2) | (lut[2] << 4) | (lut[3] << 6)));
+    const __m128i obp0 = _mm_set1_epi8((char) (lut[4] | (lut[5] << 2) | (lut[6] << 4) | (lut[7] << 6)));
+    const __m128i obp1 = _mm_set1_epi8((char) (lut[8] | (lut[9] << 2) | (lut[10] << 4) | (lut[11] << 6)));
+
+    for (uint32_t x = 0; x < GB_SCREEN_WIDTH; x += 16)
+    {
+        const __m128i bg = _mm_loadu_si128((const __m128i *) &line->bg[x]);
+        const __m128i obj = _mm_loadu_si128((const __m128i *) &line->obj[x]);
+
+        const __m128i obj_color = _mm_and_si128(obj, color_mask);
+        const __m128i obj_transparent = _mm_cmpeq_epi8(obj_color, zero);
+        const __m128i obj_behind_bg = _mm_andnot_si128(
+            _mm_cmpeq_epi8(bg, zero), _mm_cmpeq_epi8(_mm_and_si128(obj, priority_mask), priority_mask));
+        const __m128i use_bg = _mm_or_si128(obj_transparent, obj_behind_bg);
+
+        const __m128i use_obp1 = _mm_cmpeq_epi8(_mm_and_si128(obj, palette_mask), palette_mask);
+        const __m128i obj_palette = _mm_or_si128(_mm_and_si128(use_obp1, obp1), _mm_andnot_si128(use_obp1, obp0));
+
+        const __m128i palette = _mm_or_si128(_mm_and_si128(use_bg, bgp), _mm_andnot_si128(use_bg, obj_palette));
+        const __m128i color = _mm_or_si128(_mm_and_si128(use_bg, bg), _mm_andnot_si128(use_bg, obj_color));
+
+        // 16-bit shifts leak bits of the neighbouring byte into the top bits, which the shade mask drops
+        const __m128i shade_0 = _mm_and_si128(palette, shade_mask);
+        const __m128i shade_1 = _mm_and_si128(_mm_srli_epi16(palette, 2), shade_mask);
+        const __m128i shade_2 = _mm_and_si128(_mm_srli_epi16(palette, 4), shade_mask);
+        const __m128i shade_3 = _mm_and_si128(_mm_srli_epi16(palette, 6), shade_mask);
+
+        __m128i shade = _mm_and_si128(_mm_cmpeq_epi8(color, zero), shade_0);
+        shade = _mm_or_si128(shade, _mm_and_si128(_mm_cmpeq_epi8(color, _mm_set1_epi8(1)), shade_1));
+        shade = _mm_or_si128(shade, _mm_and_si128(_mm_cmpeq_epi8(color, _mm_set1_epi8(2)), shade_2));
+        shade = _mm_or_si128(shade, _mm_and_si128(_mm_cmpeq_epi8(color, _mm_set1_epi8(3)), shade_3));
+
+        _mm_storeu_si128((__m128i *) &output[x + 0], _mm_unpacklo_epi8(shade, zero));
+        _mm_storeu_si128((__m128i *) &output[x + 8], _mm_unpackhi_epi8(shade, zero));
+    }
+}
+#endif
+
+#if GB_COMPOSITOR_AVX2
+GB_TARGET_AVX2 static void compose_line_avx2(const struct GbPpuLine *line, const uint8_t lut[16], uint16_t *output)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i color_mask = _mm256_set1_epi8(GB_OBJ_PIXEL_COLOR_MASK);
+    const __m256i priority_mask = _mm256_set1_epi8(GB_OBJ_PIXEL_BG_PRIORITY);
+    const __m256i index_mask = _mm256_set1_epi8(0b0111);
+    const __m256i obj_offset = _mm256_set1_epi8(4);
+    const __m256i palette_lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) lut));
+
+    for (uint32_t x = 0; x < GB_SCREEN_WIDTH; x += 32)
+    {
+        const __m256i bg = _mm256_loadu_si256((const __m256i *) &line->bg[x]);
+        const __m256i obj = _mm256_loadu_si256((const __m256i *) &line->obj[x]);
+
+        const __m256i obj_transparent = _mm256_cmpeq_epi8(_mm256_and_si256(obj, color_mask), zero);
+        const __m256i obj_behind_bg = _mm256_andnot_si256(
+            _mm256_cmpeq_epi8(bg, zero), _mm256_cmpeq_epi8(_mm256_and_si256(obj, priority_mask), priority_mask));
+        const __m256i use_bg = _mm256_or_si256(obj_transparent, obj_behind_bg);
+
+        const __m256i obj_index = _mm256_add_epi8(_mm256_and_si256(obj, index_mask), obj_offset);
+        const __m256i index = _mm256_blendv_epi8(obj_index, bg, use_bg);
+        const __m256i shade = _mm256_shuffle_epi8(palette_lut, index);
+
+        _mm256_storeu_si256((__m256i *) &output[x + 0], _mm256_cvtepu8_epi16(_mm256_castsi256_si128(shade)));
+        _mm256_storeu_si256((__m256i *) &output[x + 16], _mm256_cvtepu8_epi16(_mm256_extracti128_si256(shade, 1)));
+    }
+}
+#endif
+
+static bool cpu_supports_avx2(void)
+{
+#if GB_COMPOSITOR_AVX2
+#    if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#    elif defined(_MSC_VER)
+    int info[4] = { 0 };
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+
+    // The OS has to save the YMM registers on context switches
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0b110) != 0b110)
+    {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#    else
+    return false;
+#    endif
+#else
+    return false;
+#endif
+}
+
+bool gb_ppu_compositor_is_supported(const enum GbPpuCompositor compositor)
+{
+    switch (compositor)
+    {
+    case GB_PPU_COMPOSITOR_SCALAR:
+        return true;
+    case GB_PPU_COMPOSITOR_SSE2:
+        return GB_COMPOSITOR_SSE2;
+    case GB_PPU_COMPOSITOR_AVX2:
+        return cpu_supports_avx2();
+    default:
+        return false;
+    }
+}
+
+enum GbPpuCompositor gb_ppu_compositor_detect(void)
+{
+    if (gb_ppu_compositor_is_supported(GB_PPU_COMPOSITOR_AVX2))
+    {
+        return GB_PPU_COMPOSITOR_AVX2;
+    }
+
+    if (gb_ppu_compositor_is_supported(GB_PPU_COMPOSITOR_SSE2))
+    {
+        return GB_PPU_COMPOSITOR_SSE2;
+    }
+
+    return GB_PPU_COMPOSITOR_SCALAR;
+}
+
+void gb_ppu_compose_line(
+    const enum GbPpuCompositor compositor,
+    const struct GbPpuLine *line,
+    const uint8_t bgp,
+    const uint8_t obp0,
+    const uint8_t obp1,
+    uint16_t *output)
+{
+    uint8_t lut[16];
+    build_palette_lut(bgp, obp0, obp1, lut);
+
+    switch (compositor)
+    {
+#if GB_COMPOSITOR_AVX2
+    case GB_PPU_COMPOSITOR_AVX2:
+        compose_line_avx2(line, lut, output);
+        break;
+#endif
+#if GB_COMPOSITOR_SSE2
+    case GB_PPU_COMPOSITOR_SSE2:
+        compose_line_sse2(line, lut, output);
+        break;
+#endif
+    default:
+        compose_line_scalar(line, lut, output);
+        break;
+    }
+}
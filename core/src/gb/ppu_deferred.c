@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/ppu_deferred.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gb/definitions.h"
+#include "gb/utils/log.h"
+
+static void apply_writes(struct GbPpuDeferredWorker *worker, uint32_t *applied, const uint32_t count)
+{
+    const struct GbPpuDeferred *deferred = worker->deferred;
+    for (; *applied < count; *applied += 1)
+    {
+        const struct GbPpuWrite *write = &deferred->writes[*applied];
+        if (write->oam)
+        {
+            worker->oam[write->address] = write->value;
+            worker->ppu.object_cache_dirty = true;
+        }
+        else
+        {
+            worker->vram[write->address] = write->value;
+        }
+    }
+}
+
+static void render_band(struct GbPpuDeferredWorker *worker)
+{
+    const struct GbPpuDeferred *deferred = worker->deferred;
+    struct GbPpu *ppu = &worker->ppu;
+
+    // The copy only shares the screen, every line writes its own row of it
+    *ppu = *deferred->source;
+    ppu->vram = worker->vram;
+    ppu->oam = worker->oam;
+    ppu->tile_map_cache = NULL;
+    ppu->object_cache_dirty = true;
+
+    memcpy(worker->vram, deferred->vram, sizeof(worker->vram));
+    memcpy(worker->oam, deferred->oam, sizeof(worker->oam));
+
+    uint32_t applied = 0;
+    for (uint8_t line = worker->first_line; line < worker->last_line; ++line)
+    {
+        const struct GbPpuLineState *state = &deferred->lines[line];
+        if (!state->recorded)
+        {
+            continue;
+        }
+
+        ppu->ly = line;
+
+        apply_writes(worker, &applied, state->scan_writes);
+        ppu->lcd_control = state->scan_lcd_control;
+        gb_ppu_select_line_objects(ppu);
+
+        apply_writes(worker, &applied, state->draw_writes);
+        ppu->lcd_control = state->lcd_control;
+        ppu->scy = state->scy;
+        ppu->scx = state->scx;
+        ppu->bgp = state->bgp;
+        ppu->obp0 = state->obp0;
+        ppu->obp1 = state->obp1;
+        ppu->wx = state->wx;
+        ppu->window_triggered = state->window_triggered;
+        ppu->window_line = state->window_line;
+        gb_ppu_draw_line(ppu);
+    }
+}
+
+static void run_worker(void *argument)
+{
+    struct GbPpuDeferredWorker *worker = argument;
+    struct GbPpuDeferred *deferred = worker->deferred;
+
+    uint32_t generation = 0;
+    for (;;)
+    {
+        gb_mutex_lock(&deferred->mutex);
+        while (deferred->generation == generation && !deferred->quit)
+        {
+            gb_condition_wait(&deferred->start, &deferred->mutex);
+        }
+
+        if (deferred->quit)
+        {
+            gb_mutex_unlock(&deferred->mutex);
+            return;
+        }
+
+        generation = deferred->generation;
+        gb_mutex_unlock(&deferred->mutex);
+
+        render_band(worker);
+
+        gb_mutex_lock(&deferred->mutex);
+        deferred->pending -= 1;
+        if (deferred->pending == 0)
+        {
+            gb_condition_signal(&deferred->done);
+        }
+        gb_mutex_unlock(&deferred->mutex);
+    }
+}
+
+struct GbPpuDeferred *gb_ppu_deferred_create(const uint32_t thread_count)
+{
+    struct GbPpuDeferred *deferred = calloc(1, sizeof(struct GbPpuDeferred));
+    deferred->recording = false;
+    deferred->writes = NULL;
+    deferred->write_count = 0;
+    deferred->write_capacity = 0;
+    deferred->source = NULL;
+    deferred->generation = 0;
+    deferred->pending = 0;
+    deferred->quit = false;
+    gb_mutex_init(&deferred->mutex);
+    gb_condition_init(&deferred->start);
+    gb_condition_init(&deferred->done);
+
+    const uint32_t worker_count = thread_count == 0 ? 1 : thread_count;
+    deferred->workers = calloc(worker_count, sizeof(struct GbPpuDeferredWorker));
+    deferred->worker_count = 1;
+    deferred->workers[0].deferred = deferred;
+
+    for (uint32_t i = 1; i < worker_count; ++i)
+    {
+        struct GbPpuDeferredWorker *worker = &deferred->workers[i];
+        worker->deferred = deferred;
+        if (!gb_thread_create(&worker->thread, run_worker, worker))
+        {
+            gb_log(GB_LOG_WARN, "Failed to create render thread, continuing with %u\n", deferred->worker_count);
+            break;
+        }
+
+        deferred->worker_count += 1;
+    }
+
+    // Bands of equal size, the last one takes the remainder
+    const uint32_t band_lines = GB_SCREEN_HEIGHT / deferred->worker_count;
+    for (uint32_t i = 0; i < deferred->worker_count; ++i)
+    {
+        struct GbPpuDeferredWorker *worker = &deferred->workers[i];
+        worker->first_line = (uint8_t) (i * band_lines);
+        worker->last_line = (uint8_t) (i + 1 == deferred->worker_count ? GB_SCREEN_HEIGHT : (i + 1) * band_lines);
+    }
+
+    return deferred;
+}
+
+void gb_ppu_deferred_destroy(struct GbPpuDeferred *deferred)
+{
+    gb_mutex_lock(&deferred->mutex);
+    deferred->quit = true;
+    gb_condition_broadcast(&deferred->start);
+    gb_mutex_unlock(&deferred->mutex);
+
+    for (uint32_t i = 1; i < deferred->worker_count; ++i)
+    {
+        gb_thread_join(&deferred->workers[i].thread);
+    }
+
+    gb_condition_destroy(&deferred->done);
+    gb_condition_destroy(&deferred->start);
+    gb_mutex_destroy(&deferred->mutex);
+    free(deferred->workers);
+    free(deferred->writes);
+    free(deferred);
+}
+
+void gb_ppu_deferred_begin_frame(struct GbPpuDeferred *deferred, const struct GbPpu *ppu)
+{
+    memcpy(deferred->vram, ppu->vram, sizeof(deferred->vram));
+    memcpy(deferred->oam, ppu->oam, sizeof(deferred->oam));
+    deferred->write_count = 0;
+
+    for (uint32_t line = 0; line < GB_SCREEN_HEIGHT; ++line)
+    {
+        deferred->lines[line].recorded = false;
+    }
+
+    deferred->recording = true;
+}
+
+void gb_ppu_deferred_log_write(
+    struct GbPpuDeferred *deferred,
+    const uint16_t address,
+    const uint8_t value,
+    const bool oam)
+{
+    if (!deferred->recording)
+    {
+        return;
+    }
+
+    if (deferred->write_count == deferred->write_capacity)
+    {
+        deferred->write_capacity = deferred->write_capacity == 0 ? 1024 : deferred->write_capacity * 2;
+        deferred->writes = realloc(deferred->writes, sizeof(struct GbPpuWrite) * deferred->write_capacity);
+    }
+
+    deferred->writes[deferred->write_count] = (struct GbPpuWrite) {
+        .address = address,
+        .value = value,
+        .oam = oam,
+    };
+    deferred->write_count += 1;
+}
+
+void gb_ppu_deferred_record_scan(struct GbPpuDeferred *deferred, const struct GbPpu *ppu)
+{
+    if (!deferred->recording)
+    {
+        return;
+    }
+
+    struct GbPpuLineState *state = &deferred->lines[ppu->ly];
+    state->scan_writes = deferred->write_count;
+    state->scan_lcd_control = ppu->lcd_control;
+}
+
+void gb_ppu_deferred_record_line(struct GbPpuDeferred *deferred, const struct GbPpu *ppu)
+{
+    if (!deferred->recording)
+    {
+        return;
+    }
+
+    struct GbPpuLineState *state = &deferred->lines[ppu->ly];
+    state->recorded = true;
+    state->draw_writes = deferred->write_count;
+    state->lcd_control = ppu->lcd_control;
+    state->scy = ppu->scy;
+    state->scx = ppu->scx;
+    state->bgp = ppu->bgp;
+    state->obp0 = ppu->obp0;
+    state->obp1 = ppu->obp1;
+    state->wx = ppu->wx;
+    state->window_triggered = ppu->window_triggered;
+    state->window_line = ppu->window_line;
+}
+
+void gb_ppu_deferred_render(struct GbPpuDeferred *deferred, const struct GbPpu *ppu)
+{
+    if (!deferred->recording)
+    {
+        return;
+    }
+
+    deferred->source = ppu;
+
+    gb_mutex_lock(&deferred->mutex);
+    deferred->generation += 1;
+    deferred->pending = deferred->worker_count - 1;
+    gb_condition_broadcast(&deferred->start);
+    gb_mutex_unlock(&deferred->mutex);
+
+    render_band(&deferred->workers[0]);
+
+    gb_mutex_lock(&deferred->mutex);
+    while (deferred->pending != 0)
+    {
+        gb_condition_wait(&deferred->done, &deferred->mutex);
+    }
+    gb_mutex_unlock(&deferred->mutex);
+
+    deferred->recording = false;
+}
@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/ppu_fifo.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gb/cpu.h"
+#include "gb/definitions.h"
+#include "gb/utils/bits.h"
+
+#define FIFO_LINE_DOTS 456
+#define FIFO_OAM_SCAN_DOTS 80
+#define FIFO_LINES 154
+
+#define FIFO_FETCH_DOTS 6 // Tile index, data low and data high take 2 dots each
+#define FIFO_FIRST_FETCH_DOTS 6 // The first tile of a line is fetched twice, the first result is thrown away
+
+#define TILES_PER_LINE 32
+#define TILE_BYTES (2 * 8)
+
+struct GbPpuFifo *gb_ppu_fifo_create(void)
+{
+    struct GbPpuFifo *fifo = calloc(1, sizeof(struct GbPpuFifo));
+    fifo->object_fetch = -1;
+
+    return fifo;
+}
+
+void gb_ppu_fifo_destroy(struct GbPpuFifo *fifo) { free(fifo); }
+
+void gb_ppu_fifo_restart_line(struct GbPpu *ppu)
+{
+    struct GbPpuFifo *fifo = ppu->fifo;
+    fifo->line_dot = 0;
+    fifo->object_count = 0;
+    fifo->object_fetch = -1;
+    fifo->window_drawn = false;
+
+    ppu->mode = ppu->ly < GB_SCREEN_HEIGHT ? GB_PPU_MODE_OAM_SCAN : GB_PPU_MODE_VBLANK;
+}
+
+static uint8_t get_object_height(struct GbPpu *ppu) { return GB_BIT_CHECK(ppu->lcd_control, 2) ? 16 : 8; }
+
+// One OAM entry is checked every 2 dots
+static void scan_object(struct GbPpu *ppu, struct GbPpuFifo *fifo)
+{
+    if (fifo->line_dot % 2 != 0 || fifo->object_count == GB_PPU_OBJECTS_PER_LINE)
+    {
+        return;
+    }
+
+    const uint8_t object = (uint8_t) (fifo->line_dot / 2);
+    const int32_t top = (int32_t) ppu->oam[object * 4] - 16;
+    if (ppu->ly >= top && ppu->ly < top + get_object_height(ppu))
+    {
+        fifo->objects[fifo->object_count] = object;
+        fifo->object_count += 1;
+    }
+}
+
+static void start_drawing(struct GbPpu *ppu, struct GbPpuFifo *fifo)
+{
+    // Objects are fetched in the order the LCD reaches them, the stable sort keeps OAM order on ties
+    for (uint8_t i = 1; i < fifo->object_count; ++i)
+    {
+        const uint8_t object = fifo->objects[i];
+        const uint8_t x = ppu->oam[object * 4 + 1];
+
+        uint8_t position = i;
+        while (position > 0 && ppu->oam[fifo->objects[position - 1] * 4 + 1] > x)
+        {
+            fifo->objects[position] = fifo->objects[position - 1];
+            position -= 1;
+        }
+
+        fifo->objects[position] = object;
+    }
+
+    fifo->objects_fetched = 0;
+    fifo->object_fetch = -1;
+    fifo->bg_head = 0;
+    fifo->bg_count = 0;
+    memset(fifo->obj_pixels, 0, sizeof(fifo->obj_pixels));
+    fifo->fetcher_dots = 0;
+    fifo->fetcher_x = 0;
+    fifo->fetching_window = false;
+    fifo->window_drawn = false;
+    fifo->stall_dots = FIFO_FIRST_FETCH_DOTS;
+    fifo->discard = ppu->scx % GB_TILE_SIZE;
+    fifo->lcd_x = 0;
+
+    ppu->mode = GB_PPU_MODE_DRAWING;
+}
+
+static uint8_t get_fetcher_map_y(struct GbPpu *ppu, struct GbPpuFifo *fifo)
+{
+    return fifo->fetching_window ? ppu->window_line : (uint8_t) (ppu->ly + ppu->scy);
+}
+
+static uint8_t fetch_tile_data(struct GbPpu *ppu, struct GbPpuFifo *fifo, const uint32_t offset)
+{
+    const uint8_t map_y = get_fetcher_map_y(ppu, fifo);
+    const uint32_t tile_data_memory_offset = GB_BIT_CHECK(ppu->lcd_control, 4)
+        ? (uint32_t) (fifo->tile_id * TILE_BYTES)
+        : (uint32_t) (0x0800 + (((int8_t) fifo->tile_id) + 128) * TILE_BYTES);
+
+    return ppu->vram[tile_data_memory_offset + (map_y % GB_TILE_SIZE) * 2 + offset];
+}
+
+// Registers are read at the step that uses them, so mid-line writes land where the hardware would show them
+static void advance_fetcher(struct GbPpu *ppu, struct GbPpuFifo *fifo, const bool allow_push)
+{
+    if (fifo->fetcher_dots < FIFO_FETCH_DOTS)
+    {
+        fifo->fetcher_dots += 1;
+        switch (fifo->fetcher_dots)
+        {
+        case 2:
+        {
+            const bool high_map = GB_BIT_CHECK(ppu->lcd_control, fifo->fetching_window ? 6 : 3);
+            const uint32_t tile_map_address = high_map ? 0x1c00 : 0x1800;
+            const uint32_t tile_x = fifo->fetching_window
+                ? fifo->fetcher_x % TILES_PER_LINE
+                : (ppu->scx / GB_TILE_SIZE + fifo->fetcher_x) % TILES_PER_LINE;
+            const uint32_t tile_y = get_fetcher_map_y(ppu, fifo) / GB_TILE_SIZE;
+
+            fifo->tile_id = ppu->vram[tile_map_address + tile_y * TILES_PER_LINE + tile_x];
+            break;
+        }
+        case 4:
+            fifo->tile_low = fetch_tile_data(ppu, fifo, 0);
+            break;
+        case 6:
+            fifo->tile_high = fetch_tile_data(ppu, fifo, 1);
+            break;
+        default:
+            break;
+        }
+
+        return;
+    }
+
+    // The fetched row waits until the FIFO ran empty
+    if (!allow_push || fifo->bg_count != 0)
+    {
+        return;
+    }
+
+    for (uint32_t pixel = 0; pixel < GB_TILE_SIZE; ++pixel)
+    {
+        const uint32_t bit = 7 - pixel;
+        fifo->bg_pixels[pixel] =
+            (uint8_t) ((GB_BIT_VALUE(fifo->tile_high, bit) << 1) | GB_BIT_VALUE(fifo->tile_low, bit));
+    }
+
+    fifo->bg_head = 0;
+    fifo->bg_count = GB_TILE_SIZE;
+    fifo->fetcher_dots = 0;
+    fifo->fetcher_x += 1;
+}
+
+static void merge_object(struct GbPpu *ppu, struct GbPpuFifo *fifo, const uint8_t object_index)
+{
+    const uint8_t height = get_object_height(ppu);
+    const uint8_t *object = &ppu->oam[object_index * 4];
+    const int32_t object_y = (int32_t) object[0] - 16;
+    const int32_t object_x = (int32_t) object[1] - 8;
+    const uint8_t attributes = object[3];
+
+    uint8_t tile_id = object[2];
+    uint8_t row = (uint8_t) (ppu->ly - object_y);
+    if (GB_BIT_CHECK(attributes, 6))
+    {
+        row = (uint8_t) (height - 1 - row);
+    }
+
+    if (height == 16)
+    {
+        tile_id = (uint8_t) ((tile_id & 0xfe) + row / GB_TILE_SIZE);
+        row %= GB_TILE_SIZE;
+    }
+
+    const uint32_t tile_line_address = (uint32_t) (tile_id * TILE_BYTES + row * 2);
+    const uint8_t pixels_1 = ppu->vram[tile_line_address];
+    const uint8_t pixels_2 = ppu->vram[tile_line_address + 1];
+
+    uint8_t flags = 0;
+    if (GB_BIT_CHECK(attributes, 4))
+    {
+        flags |= GB_OBJ_PIXEL_PALETTE;
+    }
+
+    if (GB_BIT_CHECK(attributes, 7))
+    {
+        flags |= GB_OBJ_PIXEL_BG_PRIORITY;
+    }
+
+    // Objects hanging over the left edge lose the pixels that were already shifted out
+    const int32_t skip = (int32_t) fifo->lcd_x - object_x;
+    const bool x_flip = GB_BIT_CHECK(attributes, 5);
+    for (int32_t pixel = skip < 0 ? 0 : skip; pixel < GB_TILE_SIZE; ++pixel)
+    {
+        uint8_t *slot = &fifo->obj_pixels[pixel - skip];
+        if ((*slot & GB_OBJ_PIXEL_COLOR_MASK) != 0)
+        {
+            continue;
+        }
+
+        const uint32_t bit = x_flip ? (uint32_t) pixel : (uint32_t) (7 - pixel);
+        const uint8_t color = (uint8_t) ((GB_BIT_VALUE(pixels_2, bit) << 1) | GB_BIT_VALUE(pixels_1, bit));
+        if (color != 0)
+        {
+            *slot = color | flags;
+        }
+    }
+}
+
+static int8_t find_object_hit(struct GbPpu *ppu, struct GbPpuFifo *fifo)
+{
+    if (!GB_BIT_CHECK(ppu->lcd_control, 1) || fifo->discard != 0)
+    {
+        return -1;
+    }
+
+    for (uint8_t i = 0; i < fifo->object_count; ++i)
+    {
+        if ((fifo->objects_fetched & GB_BIT(i)) == 0 && ppu->oam[fifo->objects[i] * 4 + 1] <= fifo->lcd_x + 8)
+        {
+            return (int8_t) i;
+        }
+    }
+
+    return -1;
+}
+
+static void start_window(struct GbPpu *ppu, struct GbPpuFifo *fifo)
+{
+    fifo->bg_count = 0;
+    fifo->fetcher_dots = 0;
+    fifo->fetcher_x = 0;
+    fifo->fetching_window = true;
+    fifo->window_drawn = true;
+
+    // WX values below 7 move the left edge of the window off screen
+    fifo->discard = ppu->wx < 7 ? (uint8_t) (7 - ppu->wx) : 0;
+}
+
+static uint8_t apply_palette(const uint8_t palette, const uint8_t color) { return (palette >> (color * 2)) & 0b11; }
+
+static void shift_out_pixel(struct GbPpu *ppu, struct GbPpuFifo *fifo)
+{
+    const uint8_t bg = fifo->bg_pixels[fifo->bg_head];
+    fifo->bg_head += 1;
+    fifo->bg_count -= 1;
+
+    const uint8_t obj = fifo->obj_pixels[0];
+    memmove(&fifo->obj_pixels[0], &fifo->obj_pixels[1], sizeof(fifo->obj_pixels) - 1);
+    fifo->obj_pixels[sizeof(fifo->obj_pixels) - 1] = 0;
+
+    if (fifo->discard != 0)
+    {
+        fifo->discard -= 1;
+        return;
+    }
+
+    // Skipped frames still run the fetchers, they decide how long mode 3 takes
+    if (!ppu->render_frame)
+    {
+        fifo->lcd_x += 1;
+        return;
+    }
+
+    // With the background disabled the BG/Window layer is blank white
+    const bool background_enabled = GB_BIT_CHECK(ppu->lcd_control, 0);
+    const uint8_t bg_color = background_enabled ? bg : 0;
+
+    const bool obj_transparent = (obj & GB_OBJ_PIXEL_COLOR_MASK) == 0;
+    const bool obj_behind_bg = (obj & GB_OBJ_PIXEL_BG_PRIORITY) != 0 && bg_color != 0;
+
+    uint8_t shade = background_enabled ? apply_palette(ppu->bgp, bg_color) : 0;
+    if (GB_BIT_CHECK(ppu->lcd_control, 1) && !obj_transparent && !obj_behind_bg)
+    {
+        const uint8_t palette = (obj & GB_OBJ_PIXEL_PALETTE) != 0 ? ppu->obp1 : ppu->obp0;
+        shade = apply_palette(palette, obj & GB_OBJ_PIXEL_COLOR_MASK);
+    }
+
+    ppu->screen[ppu->ly * GB_SCREEN_WIDTH + fifo->lcd_x] = shade;
+    fifo->lcd_x += 1;
+}
+
+static void step_drawing(struct GbPpu *ppu, struct GbPpuFifo *fifo)
+{
+    if (fifo->stall_dots != 0)
+    {
+        fifo->stall_dots -= 1;
+        return;
+    }
+
+    // The object fetcher borrows the VRAM bus, both the BG fetcher and the LCD wait for it
+    if (fifo->object_fetch >= 0)
+    {
+        fifo->object_fetch_dots += 1;
+        if (fifo->object_fetch_dots == FIFO_FETCH_DOTS)
+        {
+            merge_object(ppu, fifo, fifo->objects[fifo->object_fetch]);
+            fifo->objects_fetched |= (uint16_t) GB_BIT(fifo->object_fetch);
+            fifo->object_fetch = -1;
+        }
+
+        return;
+    }
+
+    if (!fifo->fetching_window && GB_BIT_CHECK(ppu->lcd_control, 5) && ppu->window_triggered
+        && fifo->lcd_x + 7 >= ppu->wx)
+    {
+        start_window(ppu, fifo);
+    }
+
+    // An object stops the LCD until the BG fetcher reached its last step, which costs 6 to 11 dots in total
+    const int8_t object_hit = find_object_hit(ppu, fifo);
+    if (object_hit >= 0)
+    {
+        if (fifo->fetcher_dots < FIFO_FETCH_DOTS - 1)
+        {
+            advance_fetcher(ppu, fifo, false);
+            return;
+        }
+
+        fifo->object_fetch = object_hit;
+        fifo->object_fetch_dots = 1;
+        return;
+    }
+
+    advance_fetcher(ppu, fifo, true);
+
+    if (fifo->bg_count != 0)
+    {
+        shift_out_pixel(ppu, fifo);
+    }
+}
+
+static void finish_line(struct GbPpu *ppu, struct GbPpuFifo *fifo)
+{
+    if (fifo->window_drawn)
+    {
+        fifo->window_drawn = false;
+        ppu->window_line += 1;
+    }
+
+    fifo->line_dot = 0;
+    fifo->object_count = 0;
+    ppu->ly += 1;
+
+    if (ppu->ly == GB_SCREEN_HEIGHT)
+    {
+        ppu->mode = GB_PPU_MODE_VBLANK;
+        ppu->window_triggered = false;
+        ppu->window_line = 0;
+
+        gb_ppu_finish_frame(ppu);
+        gb_cpu_request_interrupt(ppu->cpu, GB_INTERRUPT_VBLANK);
+        return;
+    }
+
+    if (ppu->ly >= FIFO_LINES)
+    {
+        ppu->ly = 0;
+        gb_ppu_start_frame(ppu);
+    }
+
+    if (ppu->ly < GB_SCREEN_HEIGHT)
+    {
+        ppu->mode = GB_PPU_MODE_OAM_SCAN;
+
+        // Once LY matched WY the window stays triggered for the rest of the frame
+        if (ppu->ly == ppu->wy)
+        {
+            ppu->window_triggered = true;
+        }
+    }
+}
+
+static void step_dot(struct GbPpu *ppu, struct GbPpuFifo *fifo)
+{
+    switch (ppu->mode)
+    {
+    case GB_PPU_MODE_OAM_SCAN:
+        scan_object(ppu, fifo);
+        break;
+    case GB_PPU_MODE_DRAWING:
+        step_drawing(ppu, fifo);
+        if (fifo->lcd_x == GB_SCREEN_WIDTH)
+        {
+            if (ppu->render_frame)
+            {
+                gb_ppu_track_line(ppu, ppu->ly);
+            }
+
+            ppu->mode = GB_PPU_MODE_HBLANK;
+        }
+        break;
+    default:
+        break;
+    }
+
+    fifo->line_dot += 1;
+    if (fifo->line_dot == FIFO_OAM_SCAN_DOTS && ppu->mode == GB_PPU_MODE_OAM_SCAN)
+    {
+        start_drawing(ppu, fifo);
+    }
+    else if (fifo->line_dot == FIFO_LINE_DOTS)
+    {
+        finish_line(ppu, fifo);
+    }
+
+    gb_ppu_update_stat(ppu);
+}
+
+void gb_ppu_fifo_advance(struct GbPpu *ppu, const uint64_t dots)
+{
+    for (uint64_t dot = 0; dot < dots; ++dot)
+    {
+        step_dot(ppu, ppu->fifo);
+    }
+}
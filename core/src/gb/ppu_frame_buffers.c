@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/ppu_frame_buffers.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gb/definitions.h"
+
+struct GbPpuFrameBuffers *gb_ppu_frame_buffers_create(void)
+{
+    struct GbPpuFrameBuffers *frame_buffers = malloc(sizeof(struct GbPpuFrameBuffers));
+    gb_mutex_init(&frame_buffers->mutex);
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        frame_buffers->buffers[i] = calloc(1, sizeof(uint16_t) * GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT);
+    }
+
+    frame_buffers->ready = frame_buffers->buffers[1];
+    frame_buffers->front = frame_buffers->buffers[2];
+    frame_buffers->fresh = false;
+    memset(frame_buffers->dirty_lines, 0, sizeof(frame_buffers->dirty_lines));
+
+    return frame_buffers;
+}
+
+void gb_ppu_frame_buffers_destroy(struct GbPpuFrameBuffers *frame_buffers)
+{
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        free(frame_buffers->buffers[i]);
+    }
+
+    gb_mutex_destroy(&frame_buffers->mutex);
+    free(frame_buffers);
+}
+
+uint16_t *gb_ppu_frame_buffers_get_back(struct GbPpuFrameBuffers *frame_buffers)
+{
+    return frame_buffers->buffers[0];
+}
+
+uint16_t *gb_ppu_frame_buffers_present(
+    struct GbPpuFrameBuffers *frame_buffers,
+    uint16_t *back,
+    const uint64_t dirty_lines[GB_PPU_DIRTY_WORDS])
+{
+    gb_mutex_lock(&frame_buffers->mutex);
+
+    // A frame the frontend missed is replaced, its changed lines carry over to the new one
+    uint16_t *next = frame_buffers->ready;
+    frame_buffers->ready = back;
+    frame_buffers->fresh = true;
+    for (uint32_t i = 0; i < GB_PPU_DIRTY_WORDS; ++i)
+    {
+        frame_buffers->dirty_lines[i] |= dirty_lines[i];
+    }
+
+    gb_mutex_unlock(&frame_buffers->mutex);
+    return next;
+}
+
+const uint16_t *gb_ppu_frame_buffers_take(
+    struct GbPpuFrameBuffers *frame_buffers,
+    uint64_t dirty_lines[GB_PPU_DIRTY_WORDS])
+{
+    gb_mutex_lock(&frame_buffers->mutex);
+    if (!frame_buffers->fresh)
+    {
+        gb_mutex_unlock(&frame_buffers->mutex);
+        return NULL;
+    }
+
+    uint16_t *front = frame_buffers->ready;
+    frame_buffers->ready = frame_buffers->front;
+    frame_buffers->front = front;
+    frame_buffers->fresh = false;
+    memcpy(dirty_lines, frame_buffers->dirty_lines, sizeof(frame_buffers->dirty_lines));
+    memset(frame_buffers->dirty_lines, 0, sizeof(frame_buffers->dirty_lines));
+
+    gb_mutex_unlock(&frame_buffers->mutex);
+    return front;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/ppu_tile_map_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gb/definitions.h"
+#include "gb/utils/bits.h"
+
+#define TILE_BYTES (2 * 8)
+#define TILE_MAP_ADDRESS 0x1800
+#define TILE_MAP_BYTES (GB_TILE_MAP_TILES * GB_TILE_MAP_TILES)
+
+#define INVALID_TILE 0xffff
+
+struct GbPpuTileMapCache *gb_ppu_tile_map_cache_create(void)
+{
+    struct GbPpuTileMapCache *cache = calloc(1, sizeof(struct GbPpuTileMapCache));
+    memset(cache->cell_tiles, 0xff, sizeof(cache->cell_tiles));
+
+    // Every row starts out behind, so the first fetch draws it
+    cache->generation = 1;
+
+    return cache;
+}
+
+void gb_ppu_tile_map_cache_destroy(struct GbPpuTileMapCache *cache) { free(cache); }
+
+void gb_ppu_tile_map_cache_invalidate(struct GbPpuTileMapCache *cache, const uint16_t address)
+{
+    // Map entry writes are picked up by comparing the tile index of each cell
+    cache->generation += 1;
+    if (address < TILE_MAP_ADDRESS)
+    {
+        cache->tile_versions[address / TILE_BYTES] += 1;
+    }
+}
+
+static void draw_cell(
+    struct GbPpu *ppu,
+    struct GbPpuTileMapCache *cache,
+    const uint32_t map,
+    const uint32_t cell_x,
+    const uint32_t cell_y,
+    const uint16_t tile)
+{
+    const uint8_t *tile_data = &ppu->vram[tile * TILE_BYTES];
+    for (uint32_t row = 0; row < GB_TILE_SIZE; ++row)
+    {
+        const uint8_t pixels_1 = tile_data[row * 2];
+        const uint8_t pixels_2 = tile_data[row * 2 + 1];
+
+        uint8_t *pixels = &cache->pixels[map][cell_y * GB_TILE_SIZE + row][cell_x * GB_TILE_SIZE];
+        for (uint32_t pixel = 0; pixel < GB_TILE_SIZE; ++pixel)
+        {
+            const uint32_t bit = 7 - pixel;
+            pixels[pixel] = (uint8_t) ((GB_BIT_VALUE(pixels_2, bit) << 1) | GB_BIT_VALUE(pixels_1, bit));
+        }
+    }
+
+    cache->cell_tiles[map][cell_y][cell_x] = tile;
+    cache->cell_versions[map][cell_y][cell_x] = cache->tile_versions[tile];
+}
+
+static void validate_row(struct GbPpu *ppu, struct GbPpuTileMapCache *cache, const uint32_t map, const uint32_t cell_y)
+{
+    const bool unsigned_tiles = GB_BIT_CHECK(ppu->lcd_control, 4);
+    const uint8_t *tile_ids = &ppu->vram[TILE_MAP_ADDRESS + map * TILE_MAP_BYTES + cell_y * GB_TILE_MAP_TILES];
+
+    for (uint32_t cell_x = 0; cell_x < GB_TILE_MAP_TILES; ++cell_x)
+    {
+        // Indices into the 384 tiles of tile data, the signed addressing mode covers tiles 128-383
+        const uint8_t tile_id = tile_ids[cell_x];
+        const uint16_t tile = unsigned_tiles ? tile_id : (uint16_t) (256 + (int8_t) tile_id);
+
+        if (cache->cell_tiles[map][cell_y][cell_x] != tile
+            || cache->cell_versions[map][cell_y][cell_x] != cache->tile_versions[tile])
+        {
+            draw_cell(ppu, cache, map, cell_x, cell_y, tile);
+        }
+    }
+
+    cache->row_generations[map][cell_y] = cache->generation;
+}
+
+void gb_ppu_tile_map_cache_fetch_row(
+    struct GbPpu *ppu,
+    const uint32_t tile_map_address,
+    const uint8_t map_x,
+    const uint8_t map_y,
+    const uint32_t count,
+    uint8_t *output)
+{
+    struct GbPpuTileMapCache *cache = ppu->tile_map_cache;
+    const uint32_t map = (tile_map_address - TILE_MAP_ADDRESS) / TILE_MAP_BYTES;
+    const uint32_t cell_y = map_y / GB_TILE_SIZE;
+
+    // Switching the addressing mode changes the tile of every cell
+    const bool unsigned_tiles = GB_BIT_CHECK(ppu->lcd_control, 4);
+    if (cache->unsigned_tiles != unsigned_tiles)
+    {
+        cache->unsigned_tiles = unsigned_tiles;
+        cache->generation += 1;
+    }
+
+    if (cache->row_generations[map][cell_y] != cache->generation)
+    {
+        validate_row(ppu, cache, map, cell_y);
+    }
+
+    const uint8_t *row = cache->pixels[map][map_y];
+    const uint32_t remaining = (uint32_t) (GB_TILE_MAP_SIZE - map_x);
+    const uint32_t first_count = remaining < count ? remaining : count;
+    memcpy(output, &row[map_x], first_count);
+    memcpy(&output[first_count], row, count - first_count);
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/rom_cache.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gb/utils/log.h"
+#include "gb/utils/mapped_file.h"
+#include "gb/utils/thread.h"
+
+#define ROM_BANK_SIZE 0x4000
+
+static struct GbMutex s_mutex = GB_MUTEX_INITIALIZER;
+static struct GbRom *s_roms = NULL;
+
+static uint64_t hash_data(const uint8_t *data, const size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
+
+static struct GbRom *find_by_path(const char *path)
+{
+    for (struct GbRom *rom = s_roms; rom != NULL; rom = rom->next)
+    {
+        if (strcmp(rom->path, path) == 0)
+        {
+            return rom;
+        }
+    }
+
+    return NULL;
+}
+
+static struct GbRom *find_by_contents(const uint8_t *data, const size_t size, const uint64_t hash)
+{
+    for (struct GbRom *rom = s_roms; rom != NULL; rom = rom->next)
+    {
+        if (rom->hash == hash && rom->file_size == size && memcmp(rom->data, data, size) == 0)
+        {
+            return rom;
+        }
+    }
+
+    return NULL;
+}
+
+static struct GbRom *load_rom(const char *path)
+{
+    struct GbMappedFile *file = gb_mapped_file_create_read_only(path);
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    // Another path to the same game shares the pages that are already mapped
+    const uint64_t hash = hash_data(file->data, file->size);
+    struct GbRom *existing = find_by_contents(file->data, file->size, hash);
+    if (existing != NULL)
+    {
+        gb_mapped_file_destroy(file);
+        return existing;
+    }
+
+    struct GbRom *rom = malloc(sizeof(struct GbRom));
+    rom->path = malloc(strlen(path) + 1);
+    strcpy(rom->path, path);
+    rom->hash = hash;
+    rom->file_size = file->size;
+    rom->size = gb_rom_padded_size(file->size);
+    rom->references = 0;
+
+    if (rom->size == file->size)
+    {
+        rom->data = file->data;
+        rom->file = file;
+        rom->copy = NULL;
+    }
+    else
+    {
+        // Odd sizes are rare enough that a private, padded copy is fine
+        rom->copy = malloc(rom->size);
+        memcpy(rom->copy, file->data, file->size);
+        memset(&rom->copy[file->size], 0xff, rom->size - file->size);
+        gb_mapped_file_destroy(file);
+
+        rom->data = rom->copy;
+        rom->file = NULL;
+    }
+
+    rom->next = s_roms;
+    s_roms = rom;
+    return rom;
+}
+
+size_t gb_rom_padded_size(const size_t size)
+{
+    size_t padded_size = 2 * ROM_BANK_SIZE;
+    while (padded_size < size)
+    {
+        padded_size *= 2;
+    }
+
+    return padded_size;
+}
+
+const struct GbRom *gb_rom_cache_acquire(const char *path)
+{
+    gb_mutex_lock(&s_mutex);
+
+    struct GbRom *rom = find_by_path(path);
+    if (rom == NULL)
+    {
+        rom = load_rom(path);
+    }
+
+    if (rom != NULL)
+    {
+        rom->references += 1;
+    }
+
+    gb_mutex_unlock(&s_mutex);
+    return rom;
+}
+
+void gb_rom_cache_release(const struct GbRom *released)
+{
+    gb_mutex_lock(&s_mutex);
+
+    struct GbRom **link = &s_roms;
+    while (*link != released)
+    {
+        link = &(*link)->next;
+    }
+
+    struct GbRom *rom = *link;
+    rom->references -= 1;
+    if (rom->references == 0)
+    {
+        *link = rom->next;
+
+        if (rom->file != NULL)
+        {
+            gb_mapped_file_destroy(rom->file);
+        }
+
+        free(rom->copy);
+        free(rom->path);
+        free(rom);
+    }
+
+    gb_mutex_unlock(&s_mutex);
+}
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/rom_library.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gb/utils/atomic.h"
+#include "gb/utils/log.h"
+#include "gb/utils/mapped_file.h"
+#include "gb/utils/thread.h"
+
+#define INDEX_MAGIC 0x58494247 // "GBIX"
+#define INDEX_VERSION 1
+#define INDEX_MAX_PATH_LENGTH 4096 // Longer paths only come from a corrupt index
+
+struct Scan
+{
+    struct GbRomLibrary *library;
+    size_t *pending; // Entries that need their header read
+    size_t pending_count;
+    struct GbAtomic next;
+};
+
+static bool has_rom_extension(const char *path)
+{
+    const char *extension = strrchr(path, '.');
+    if (extension == NULL)
+    {
+        return false;
+    }
+
+    char lower[5] = { 0 };
+    for (size_t i = 0; i < sizeof(lower) - 1 && extension[i] != '\0'; ++i)
+    {
+        const char character = extension[i];
+        lower[i] = character >= 'A' && character <= 'Z' ? (char) (character - 'A' + 'a') : character;
+    }
+
+    return strcmp(lower, ".gb") == 0 || strcmp(lower, ".gbc") == 0;
+}
+
+static void add_entry(const char *path, void *user_data)
+{
+    struct GbRomLibrary *library = user_data;
+
+    struct GbFileInfo file;
+    if (!has_rom_extension(path) || !gb_file_get_info(path, &file))
+    {
+        return;
+    }
+
+    if (library->count == library->capacity)
+    {
+        library->capacity = library->capacity == 0 ? 64 : library->capacity * 2;
+        library->entries = realloc(library->entries, sizeof(struct GbRomLibraryEntry) * library->capacity);
+    }
+
+    struct GbRomLibraryEntry *entry = &library->entries[library->count];
+    memset(entry, 0, sizeof(struct GbRomLibraryEntry));
+    entry->path = malloc(strlen(path) + 1);
+    strcpy(entry->path, path);
+    entry->file = file;
+    library->count += 1;
+}
+
+static int compare_entries(const void *a, const void *b)
+{
+    const struct GbRomLibraryEntry *entry_a = a;
+    const struct GbRomLibraryEntry *entry_b = b;
+    return strcmp(entry_a->path, entry_b->path);
+}
+
+static struct GbRomLibraryEntry *find_entry(struct GbRomLibrary *library, const char *path)
+{
+    const struct GbRomLibraryEntry key = { .path = (char *) path };
+    return bsearch(&key, library->entries, library->count, sizeof(struct GbRomLibraryEntry), compare_entries);
+}
+
+// Marks every entry that is unchanged since the index was written as done by clearing `pending`, returns true if the
+// index lists exactly these entries
+static bool read_index(struct GbRomLibrary *library, const char *index, bool *pending)
+{
+    FILE *file = fopen(index, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t count = 0;
+    if (fread(&magic, sizeof(magic), 1, file) != 1 || fread(&version, sizeof(version), 1, file) != 1
+        || fread(&count, sizeof(count), 1, file) != 1 || magic != INDEX_MAGIC || version != INDEX_VERSION)
+    {
+        gb_log(GB_LOG_WARN, "Ignoring unreadable rom index %s\n", index);
+        fclose(file);
+        return false;
+    }
+
+    uint64_t matched = 0;
+    char path[INDEX_MAX_PATH_LENGTH + 1];
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        uint32_t path_length = 0;
+        if (fread(&path_length, sizeof(path_length), 1, file) != 1)
+        {
+            break;
+        }
+
+        if (path_length > INDEX_MAX_PATH_LENGTH)
+        {
+            gb_log(GB_LOG_WARN, "Ignoring unreadable rom index %s\n", index);
+            break;
+        }
+
+        struct GbFileInfo info;
+        uint8_t header_bytes[GB_CARTRIDGE_HEADER_SIZE];
+        if (fread(path, 1, path_length, file) != path_length || fread(&info.size, sizeof(info.size), 1, file) != 1
+            || fread(&info.modified, sizeof(info.modified), 1, file) != 1
+            || fread(header_bytes, 1, sizeof(header_bytes), file) != sizeof(header_bytes))
+        {
+            break;
+        }
+
+        path[path_length] = '\0';
+
+        struct GbRomLibraryEntry *entry = find_entry(library, path);
+        if (entry != NULL && entry->file.size == info.size && entry->file.modified == info.modified)
+        {
+            memcpy(entry->header_bytes, header_bytes, sizeof(header_bytes));
+            pending[entry - library->entries] = false;
+            matched += 1;
+        }
+    }
+
+    fclose(file);
+    return matched == count && count == library->count;
+}
+
+static void write_index(const struct GbRomLibrary *library, const char *index)
+{
+    FILE *file = fopen(index, "wb");
+    if (file == NULL)
+    {
+        gb_log(GB_LOG_WARN, "Failed to write rom index %s\n", index);
+        return;
+    }
+
+    const uint32_t magic = INDEX_MAGIC;
+    const uint32_t version = INDEX_VERSION;
+    const uint64_t count = library->count;
+    fwrite(&magic, sizeof(magic), 1, file);
+    fwrite(&version, sizeof(version), 1, file);
+    fwrite(&count, sizeof(count), 1, file);
+
+    for (size_t i = 0; i < library->count; ++i)
+    {
+        const struct GbRomLibraryEntry *entry = &library->entries[i];
+        const uint32_t path_length = (uint32_t) strlen(entry->path);
+        fwrite(&path_length, sizeof(path_length), 1, file);
+        fwrite(entry->path, 1, path_length, file);
+        fwrite(&entry->file.size, sizeof(entry->file.size), 1, file);
+        fwrite(&entry->file.modified, sizeof(entry->file.modified), 1, file);
+        fwrite(entry->header_bytes, 1, sizeof(entry->header_bytes), file);
+    }
+
+    fclose(file);
+}
+
+static void read_header(struct GbRomLibraryEntry *entry)
+{
+    // Too short files keep a zeroed header, which fails validation
+    if (entry->file.size < GB_CARTRIDGE_HEADER_ADDRESS + GB_CARTRIDGE_HEADER_SIZE)
+    {
+        return;
+    }
+
+    // Mapping the file only faults in the page with the header
+    struct GbMappedFile *file = gb_mapped_file_create_read_only(entry->path);
+    if (file == NULL)
+    {
+        return;
+    }
+
+    if (file->size >= GB_CARTRIDGE_HEADER_ADDRESS + GB_CARTRIDGE_HEADER_SIZE)
+    {
+        memcpy(entry->header_bytes, &file->data[GB_CARTRIDGE_HEADER_ADDRESS], GB_CARTRIDGE_HEADER_SIZE);
+    }
+
+    gb_mapped_file_destroy(file);
+}
+
+static void run_scan(void *argument)
+{
+    struct Scan *scan = argument;
+    for (;;)
+    {
+        const size_t next = gb_atomic_fetch_add(&scan->next, 1);
+        if (next >= scan->pending_count)
+        {
+            return;
+        }
+
+        read_header(&scan->library->entries[scan->pending[next]]);
+    }
+}
+
+static void scan_headers(struct GbRomLibrary *library, size_t *pending, const size_t pending_count, uint32_t threads)
+{
+    struct Scan scan = {
+        .library = library,
+        .pending = pending,
+        .pending_count = pending_count,
+    };
+    gb_atomic_init(&scan.next, 0);
+
+    if (threads > pending_count)
+    {
+        threads = (uint32_t) pending_count;
+    }
+
+    // The calling thread scans as well
+    struct GbThread *workers = threads > 1 ? malloc(sizeof(struct GbThread) * (threads - 1)) : NULL;
+    uint32_t worker_count = 0;
+    for (uint32_t i = 1; i < threads; ++i)
+    {
+        if (!gb_thread_create(&workers[worker_count], run_scan, &scan))
+        {
+            break;
+        }
+
+        worker_count += 1;
+    }
+
+    run_scan(&scan);
+
+    for (uint32_t i = 0; i < worker_count; ++i)
+    {
+        gb_thread_join(&workers[i]);
+    }
+
+    free(workers);
+}
+
+struct GbRomLibrary *gb_rom_library_create(const char *directory, const char *index, const uint32_t thread_count)
+{
+    struct GbRomLibrary *library = malloc(sizeof(struct GbRomLibrary));
+    library->entries = NULL;
+    library->count = 0;
+    library->capacity = 0;
+    library->scanned_count = 0;
+
+    if (!gb_directory_walk(directory, add_entry, library))
+    {
+        gb_log(GB_LOG_ERROR, "Failed to open rom directory %s\n", directory);
+        gb_rom_library_destroy(library);
+        return NULL;
+    }
+
+    qsort(library->entries, library->count, sizeof(struct GbRomLibraryEntry), compare_entries);
+
+    bool *pending = malloc(sizeof(bool) * (library->count + 1));
+    for (size_t i = 0; i < library->count; ++i)
+    {
+        pending[i] = true;
+    }
+
+    const bool index_current = index != NULL && read_index(library, index, pending);
+
+    size_t *pending_entries = malloc(sizeof(size_t) * (library->count + 1));
+    for (size_t i = 0; i < library->count; ++i)
+    {
+        if (pending[i])
+        {
+            pending_entries[library->scanned_count] = i;
+            library->scanned_count += 1;
+        }
+    }
+
+    scan_headers(library, pending_entries, library->scanned_count, thread_count == 0 ? 1 : thread_count);
+
+    for (size_t i = 0; i < library->count; ++i)
+    {
+        struct GbRomLibraryEntry *entry = &library->entries[i];
+        gb_cartridge_header_parse(&entry->header, entry->header_bytes);
+        entry->status = gb_cartridge_header_validate(&entry->header, entry->file.size);
+    }
+
+    if (index != NULL && !index_current)
+    {
+        write_index(library, index);
+    }
+
+    free(pending_entries);
+    free(pending);
+    return library;
+}
+
+void gb_rom_library_destroy(struct GbRomLibrary *library)
+{
+    for (size_t i = 0; i < library->count; ++i)
+    {
+        free(library->entries[i].path);
+    }
+
+    free(library->entries);
+    free(library);
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/rtc.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gb/utils/bits.h"
+
+#define CYCLES_PER_SECOND 4194304
+
+#define HALT_BIT 6
+#define CARRY_BIT 7
+
+static const uint8_t s_register_masks[GB_RTC_REGISTER_COUNT] = {
+    [GB_RTC_SECONDS] = 0x3f,
+    [GB_RTC_MINUTES] = 0x3f,
+    [GB_RTC_HOURS] = 0x1f,
+    [GB_RTC_DAY_LOW] = 0xff,
+    [GB_RTC_DAY_HIGH] = 0xc1,
+};
+
+static void advance_seconds(struct GbRtc *rtc, const uint64_t count)
+{
+    uint8_t *registers = rtc->registers;
+
+    const uint64_t seconds = registers[GB_RTC_SECONDS] + count;
+    const uint64_t minutes = registers[GB_RTC_MINUTES] + seconds / 60;
+    const uint64_t hours = registers[GB_RTC_HOURS] + minutes / 60;
+    uint64_t days = (uint64_t) (((registers[GB_RTC_DAY_HIGH] & 0x01) << 8) | registers[GB_RTC_DAY_LOW]) + hours / 24;
+
+    uint8_t day_high = registers[GB_RTC_DAY_HIGH] & 0b11000000;
+    if (days > 0x1ff)
+    {
+        day_high |= 1 << CARRY_BIT;
+        days &= 0x1ff;
+    }
+
+    registers[GB_RTC_SECONDS] = (uint8_t) (seconds % 60);
+    registers[GB_RTC_MINUTES] = (uint8_t) (minutes % 60);
+    registers[GB_RTC_HOURS] = (uint8_t) (hours % 24);
+    registers[GB_RTC_DAY_LOW] = (uint8_t) days;
+    registers[GB_RTC_DAY_HIGH] = (uint8_t) (day_high | (days >> 8));
+}
+
+struct GbRtc *gb_rtc_create(void)
+{
+    struct GbRtc *rtc = calloc(1, sizeof(struct GbRtc));
+    rtc->clock = GB_RTC_CLOCK_GUEST;
+    rtc->latch_value = 0xff;
+    return rtc;
+}
+
+void gb_rtc_destroy(struct GbRtc *rtc) { free(rtc); }
+
+void gb_rtc_set_clock(struct GbRtc *rtc, const enum GbRtcClock clock, const uint64_t cycles)
+{
+    gb_rtc_update(rtc, cycles);
+    rtc->clock = clock;
+
+    // Catches up from the time stamp of the save, which the guest clock never moves
+    if (clock == GB_RTC_CLOCK_WALL)
+    {
+        if (rtc->wall_time == 0)
+        {
+            rtc->wall_time = (int64_t) time(NULL);
+        }
+
+        gb_rtc_update(rtc, cycles);
+    }
+}
+
+void gb_rtc_update(struct GbRtc *rtc, const uint64_t cycles)
+{
+    const bool halted = GB_BIT_CHECK(rtc->registers[GB_RTC_DAY_HIGH], HALT_BIT);
+
+    if (rtc->clock == GB_RTC_CLOCK_WALL)
+    {
+        const int64_t now = (int64_t) time(NULL);
+        if (!halted && now > rtc->wall_time)
+        {
+            advance_seconds(rtc, (uint64_t) (now - rtc->wall_time));
+        }
+
+        rtc->wall_time = now;
+        rtc->cycles = cycles;
+        return;
+    }
+
+    // The started second carries over, so latching often doesn't slow the clock down
+    const uint64_t seconds = (cycles - rtc->cycles) / CYCLES_PER_SECOND;
+    if (halted)
+    {
+        rtc->cycles = cycles;
+        return;
+    }
+
+    advance_seconds(rtc, seconds);
+    rtc->cycles += seconds * CYCLES_PER_SECOND;
+}
+
+void gb_rtc_write_latch(struct GbRtc *rtc, const uint64_t cycles, const uint8_t value)
+{
+    if (rtc->latch_value == 0x00 && value == 0x01)
+    {
+        gb_rtc_update(rtc, cycles);
+        memcpy(rtc->latched, rtc->registers, sizeof(rtc->latched));
+    }
+
+    rtc->latch_value = value;
+}
+
+void gb_rtc_write(struct GbRtc *rtc, const uint64_t cycles, const enum GbRtcRegister reg, const uint8_t value)
+{
+    gb_rtc_update(rtc, cycles);
+    rtc->registers[reg] = value & s_register_masks[reg];
+
+    // Writing the seconds restarts the current second
+    if (reg == GB_RTC_SECONDS)
+    {
+        rtc->cycles = cycles;
+    }
+}
+
+static void write_u32(uint8_t *data, const uint32_t value)
+{
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        data[i] = (uint8_t) (value >> (i * 8));
+    }
+}
+
+void gb_rtc_save(const struct GbRtc *rtc, uint8_t data[GB_RTC_SAVE_SIZE])
+{
+    // Five counters and five latched registers as 32-bit little endian, then the host time as 64-bit
+    for (uint32_t i = 0; i < GB_RTC_REGISTER_COUNT; ++i)
+    {
+        write_u32(&data[i * 4], rtc->registers[i]);
+        write_u32(&data[(GB_RTC_REGISTER_COUNT + i) * 4], rtc->latched[i]);
+    }
+
+    // The guest clock leaves the time stamp alone, it has no idea what time it is
+    if (rtc->clock == GB_RTC_CLOCK_WALL)
+    {
+        const uint64_t wall_time = (uint64_t) rtc->wall_time;
+        write_u32(&data[40], (uint32_t) wall_time);
+        write_u32(&data[44], (uint32_t) (wall_time >> 32));
+    }
+}
+
+void gb_rtc_load(struct GbRtc *rtc, const uint8_t data[GB_RTC_SAVE_SIZE], const uint64_t cycles)
+{
+    for (uint32_t i = 0; i < GB_RTC_REGISTER_COUNT; ++i)
+    {
+        rtc->registers[i] = data[i * 4] & s_register_masks[i];
+        rtc->latched[i] = data[(GB_RTC_REGISTER_COUNT + i) * 4] & s_register_masks[i];
+    }
+
+    rtc->cycles = cycles;
+
+    uint64_t wall_time = 0;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        wall_time |= (uint64_t) data[40 + i] << (i * 8);
+    }
+
+    rtc->wall_time = (int64_t) wall_time;
+    gb_rtc_set_clock(rtc, rtc->clock, cycles);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/scheduler.h"
+
+#include <stdlib.h>
+
+#define INVALID_POSITION UINT32_MAX
+
+struct GbScheduler *gb_scheduler_create(void)
+{
+    struct GbScheduler *scheduler = malloc(sizeof(struct GbScheduler));
+    scheduler->count = 0;
+    for (uint32_t i = 0; i < GB_EVENT_COUNT; ++i)
+    {
+        scheduler->positions[i] = INVALID_POSITION;
+    }
+
+    return scheduler;
+}
+
+void gb_scheduler_destroy(struct GbScheduler *scheduler) { free(scheduler); }
+
+static void swap_entries(struct GbScheduler *scheduler, const uint32_t a, const uint32_t b)
+{
+    const struct GbSchedulerEntry entry = scheduler->heap[a];
+    scheduler->heap[a] = scheduler->heap[b];
+    scheduler->heap[b] = entry;
+
+    scheduler->positions[scheduler->heap[a].event] = a;
+    scheduler->positions[scheduler->heap[b].event] = b;
+}
+
+static void sift_up(struct GbScheduler *scheduler, uint32_t index)
+{
+    while (index > 0)
+    {
+        const uint32_t parent = (index - 1) / 2;
+        if (scheduler->heap[parent].deadline <= scheduler->heap[index].deadline)
+        {
+            return;
+        }
+
+        swap_entries(scheduler, parent, index);
+        index = parent;
+    }
+}
+
+static void sift_down(struct GbScheduler *scheduler, uint32_t index)
+{
+    for (;;)
+    {
+        const uint32_t left = index * 2 + 1;
+        const uint32_t right = left + 1;
+
+        uint32_t smallest = index;
+        if (left < scheduler->count && scheduler->heap[left].deadline < scheduler->heap[smallest].deadline)
+        {
+            smallest = left;
+        }
+
+        if (right < scheduler->count && scheduler->heap[right].deadline < scheduler->heap[smallest].deadline)
+        {
+            smallest = right;
+        }
+
+        if (smallest == index)
+        {
+            return;
+        }
+
+        swap_entries(scheduler, smallest, index);
+        index = smallest;
+    }
+}
+
+void gb_scheduler_schedule(struct GbScheduler *scheduler, const enum GbEvent event, const uint64_t deadline)
+{
+    if (deadline == UINT64_MAX)
+    {
+        gb_scheduler_cancel(scheduler, event);
+        return;
+    }
+
+    uint32_t index = scheduler->positions[event];
+    if (index == INVALID_POSITION)
+    {
+        index = scheduler->count;
+        scheduler->count += 1;
+        scheduler->heap[index].event = event;
+        scheduler->positions[event] = index;
+    }
+
+    scheduler->heap[index].deadline = deadline;
+    sift_up(scheduler, index);
+    sift_down(scheduler, scheduler->positions[event]);
+}
+
+void gb_scheduler_cancel(struct GbScheduler *scheduler, const enum GbEvent event)
+{
+    const uint32_t index = scheduler->positions[event];
+    if (index == INVALID_POSITION)
+    {
+        return;
+    }
+
+    // The last entry fills the gap and moves to wherever its deadline belongs
+    scheduler->count -= 1;
+    scheduler->positions[event] = INVALID_POSITION;
+    if (index == scheduler->count)
+    {
+        return;
+    }
+
+    const enum GbEvent moved = scheduler->heap[scheduler->count].event;
+    scheduler->heap[index] = scheduler->heap[scheduler->count];
+    scheduler->positions[moved] = index;
+    sift_up(scheduler, index);
+    sift_down(scheduler, scheduler->positions[moved]);
+}
+
+uint64_t gb_scheduler_get_next_deadline(struct GbScheduler *scheduler)
+{
+    return scheduler->count == 0 ? UINT64_MAX : scheduler->heap[0].deadline;
+}
+
+bool gb_scheduler_pop(struct GbScheduler *scheduler, const uint64_t cycles, enum GbEvent *event)
+{
+    if (scheduler->count == 0 || scheduler->heap[0].deadline > cycles)
+    {
+        return false;
+    }
+
+    *event = scheduler->heap[0].event;
+    gb_scheduler_cancel(scheduler, *event);
+    return true;
+}
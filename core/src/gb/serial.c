@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/serial.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gb/cpu.h"
+#include "gb/scheduler.h"
+#include "gb/utils/bits.h"
+
+// The oldest byte still in the ring buffer that the host hasn't taken
+static uint64_t get_output_start(const struct GbSerial *serial)
+{
+    const uint64_t oldest = serial->output_head > GB_SERIAL_OUTPUT_SIZE ? serial->output_head - GB_SERIAL_OUTPUT_SIZE
+                                                                        : 0;
+    return serial->output_tail > oldest ? serial->output_tail : oldest;
+}
+
+static uint8_t get_output(const struct GbSerial *serial, const uint64_t index)
+{
+    return serial->output[index & (GB_SERIAL_OUTPUT_SIZE - 1)];
+}
+
+struct GbSerial *gb_serial_create(void)
+{
+    struct GbSerial *serial = malloc(sizeof(struct GbSerial));
+    serial->cpu = NULL;
+    serial->scheduler = NULL;
+    serial->sb = 0x00;
+    serial->sc = 0x00;
+    serial->transfer_end = UINT64_MAX;
+    serial->linked = false;
+    serial->cgb = false;
+    serial->output_head = 0;
+    serial->output_tail = 0;
+
+    return serial;
+}
+
+void gb_serial_destroy(struct GbSerial *serial) { free(serial); }
+
+void gb_serial_set_sb(struct GbSerial *serial, const uint8_t value) { serial->sb = value; }
+
+void gb_serial_set_sc(struct GbSerial *serial, const uint8_t value)
+{
+    serial->sc = value & (serial->cgb ? 0x83 : 0x81);
+
+    // FIXME: The bits are clocked by the system counter, so the first one can come sooner than a full bit time
+    serial->transfer_end = UINT64_MAX;
+    if (GB_BIT_CHECK(serial->sc, 7))
+    {
+        serial->output[serial->output_head & (GB_SERIAL_OUTPUT_SIZE - 1)] = serial->sb;
+        serial->output_head += 1;
+
+        if (GB_BIT_CHECK(serial->sc, 0))
+        {
+            uint64_t transfer_cycles = GB_SERIAL_TRANSFER_CYCLES;
+            if (GB_BIT_CHECK(serial->sc, 1))
+            {
+                transfer_cycles /= 32;
+            }
+
+            if (serial->cpu->double_speed)
+            {
+                transfer_cycles /= 2;
+            }
+
+            serial->transfer_end = serial->cpu->cycles + transfer_cycles;
+        }
+    }
+
+    gb_scheduler_schedule(serial->scheduler, GB_EVENT_SERIAL, serial->linked ? UINT64_MAX : serial->transfer_end);
+}
+
+uint8_t gb_serial_get_sc(struct GbSerial *serial) { return (uint8_t) (serial->sc | (serial->cgb ? 0x7c : 0x7e)); }
+
+void gb_serial_sync(struct GbSerial *serial, const uint64_t cycles)
+{
+    if (serial->linked || cycles < serial->transfer_end)
+    {
+        return;
+    }
+
+    gb_serial_receive(serial, 0xff);
+}
+
+void gb_serial_set_linked(struct GbSerial *serial, const bool linked)
+{
+    serial->linked = linked;
+    gb_scheduler_schedule(serial->scheduler, GB_EVENT_SERIAL, linked ? UINT64_MAX : serial->transfer_end);
+}
+
+void gb_serial_receive(struct GbSerial *serial, const uint8_t value)
+{
+    // The partner clocks the bits in whether a transfer was started or not
+    serial->sb = value;
+    if (!GB_BIT_CHECK(serial->sc, 7))
+    {
+        return;
+    }
+
+    serial->sc = (uint8_t) (serial->sc & ~0x80);
+    serial->transfer_end = UINT64_MAX;
+    gb_cpu_request_interrupt(serial->cpu, GB_INTERRUPT_SERIAL);
+}
+
+size_t gb_serial_take_output(struct GbSerial *serial, uint8_t *buffer, const size_t size)
+{
+    uint64_t index = get_output_start(serial);
+    size_t count = 0;
+    for (; index < serial->output_head && count < size; ++index, ++count)
+    {
+        buffer[count] = get_output(serial, index);
+    }
+
+    serial->output_tail = index;
+    return count;
+}
+
+bool gb_serial_find_output(const struct GbSerial *serial, const char *text)
+{
+    const uint64_t length = strlen(text);
+    const uint64_t start = get_output_start(serial);
+    if (length == 0)
+    {
+        return true;
+    }
+
+    for (uint64_t index = start; index + length <= serial->output_head; ++index)
+    {
+        uint64_t matched = 0;
+        while (matched < length && get_output(serial, index + matched) == (uint8_t) text[matched])
+        {
+            matched += 1;
+        }
+
+        if (matched == length)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
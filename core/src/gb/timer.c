@@ -11,19 +11,18 @@
 
 #include "gb/cpu.h"
 #include "gb/definitions.h"
+#include "gb/scheduler.h"
 #include "gb/utils/bits.h"
 
-// This defines how many M-Cycles correspond to T-Cycles
-#define GB_DIVIDER_HZ 16384.0
-#define GB_DIVIDER_CYCLES (GB_MASTER_CLOCK_HZ / GB_DIVIDER_HZ)
-
 struct GbTimer *gb_timer_create(void)
 {
     struct GbTimer *timer = malloc(sizeof(struct GbTimer));
     timer->cpu = NULL;
-    timer->div_counter = 0;
-    timer->counter = 0;
-    timer->div = 0;
+    timer->scheduler = NULL;
+    timer->cycles = 0;
+    timer->next_interrupt = UINT64_MAX;
+    timer->div_base = 0;
+    timer->speed_shift = 0;
     timer->tima = 0;
     timer->tma = 0;
     timer->tac = 0;
@@ -35,52 +34,135 @@ void gb_timer_destroy(struct GbTimer *timer) { free(timer); }
 
 static bool is_enabled(struct GbTimer *timer) { return GB_BIT_CHECK(timer->tac, 2); }
 
-static uint32_t get_frequency(struct GbTimer *timer)
+// TIMA is stepped by the falling edge of a system counter bit, which happens once per period
+static uint64_t get_period(struct GbTimer *timer)
 {
     const uint8_t clock = timer->tac & 0b11;
     switch (clock)
     {
     case 0b00:
-        return 4096;
+        return 1024; // 4096 Hz
     case 0b01:
-        return 262144;
+        return 16; // 262144 Hz
     case 0b10:
-        return 65536;
-    case 0b11:
-        return 16384;
+        return 64; // 65536 Hz
     default:
-        return 0;
+        return 256; // 16384 Hz
     }
 }
 
-void gb_timer_tick(struct GbTimer *timer, const uint8_t t_cycles)
+static uint64_t get_system_counter(struct GbTimer *timer)
+{
+    return (timer->cycles - timer->div_base) << timer->speed_shift;
+}
+
+// The bit TIMA watches, masked by the enable bit
+static bool get_timer_signal(struct GbTimer *timer)
 {
-    // DIV is incremented at a rate of 16384Hz which is equal to 256 t-cycles or 64 m-cycles
-    timer->div_counter += t_cycles;
-    if (timer->div_counter >= (uint16_t) GB_DIVIDER_CYCLES)
+    return is_enabled(timer) && (get_system_counter(timer) & (get_period(timer) / 2)) != 0;
+}
+
+static void update_next_interrupt(struct GbTimer *timer)
+{
+    if (!is_enabled(timer))
     {
-        timer->div += 1;
-        timer->div_counter -= (uint16_t) GB_DIVIDER_CYCLES;
+        timer->next_interrupt = UINT64_MAX;
+    }
+    else
+    {
+        // TIMA overflows on the (256 - TIMA)-th falling edge from now
+        const uint64_t period = get_period(timer);
+        const uint64_t edges = get_system_counter(timer) / period;
+        timer->next_interrupt = timer->div_base + (((edges + 256 - timer->tima) * period) >> timer->speed_shift);
     }
 
-    if (!is_enabled(timer))
+    gb_scheduler_schedule(timer->scheduler, GB_EVENT_TIMER, timer->next_interrupt);
+}
+
+static void step_tima(struct GbTimer *timer, const uint64_t steps)
+{
+    if (steps < (uint64_t) (256 - timer->tima))
     {
+        timer->tima = (uint8_t) (timer->tima + steps);
         return;
     }
 
-    timer->counter += t_cycles;
+    // Every overflow reloads TMA, so after the first one TIMA wraps around every 256 - TMA steps
+    const uint64_t remaining = steps - (uint64_t) (256 - timer->tima);
+    timer->tima = (uint8_t) (timer->tma + remaining % (uint64_t) (256 - timer->tma));
+    gb_cpu_request_interrupt(timer->cpu, GB_INTERRUPT_TIMER);
+}
+
+uint8_t gb_timer_get_div(struct GbTimer *timer) { return (uint8_t) (get_system_counter(timer) >> 8); }
+
+void gb_timer_reset_div(struct GbTimer *timer)
+{
+    // Clearing the system counter is a falling edge if the watched bit was set
+    if (get_timer_signal(timer))
+    {
+        step_tima(timer, 1);
+    }
+
+    timer->div_base = timer->cycles;
+    update_next_interrupt(timer);
+}
+
+void gb_timer_set_system_counter(struct GbTimer *timer, const uint16_t counter)
+{
+    // Only the distance to the current cycle matters, so the base may wrap around below 0
+    timer->div_base = timer->cycles - ((uint64_t) counter >> timer->speed_shift);
+    update_next_interrupt(timer);
+}
+
+void gb_timer_set_tima(struct GbTimer *timer, const uint8_t value)
+{
+    timer->tima = value;
+    update_next_interrupt(timer);
+}
+
+void gb_timer_set_tma(struct GbTimer *timer, const uint8_t value) { timer->tma = value; }
+
+void gb_timer_set_tac(struct GbTimer *timer, const uint8_t value)
+{
+    // Disabling the timer or selecting a cleared bit looks like a falling edge as well
+    const bool signal = get_timer_signal(timer);
+    timer->tac = value;
+    if (signal && !get_timer_signal(timer))
+    {
+        step_tima(timer, 1);
+    }
+
+    update_next_interrupt(timer);
+}
+
+void gb_timer_set_double_speed(struct GbTimer *timer, const bool enabled)
+{
+    // The reset sees the old speed, which only matters for the falling edge it can cause
+    gb_timer_reset_div(timer);
+    timer->speed_shift = enabled ? 1 : 0;
+    update_next_interrupt(timer);
+}
 
-    const uint16_t frequency = (uint16_t) (GB_MASTER_CLOCK_HZ / get_frequency(timer));
-    while (timer->counter >= frequency)
+void gb_timer_sync(struct GbTimer *timer, const uint64_t cycles)
+{
+    if (cycles <= timer->cycles)
     {
-        timer->tima += 1;
-        timer->counter -= frequency;
+        return;
+    }
 
-        // If TIMA overflows
-        if (timer->tima == 0)
+    if (is_enabled(timer))
+    {
+        const uint64_t period = get_period(timer);
+        const uint64_t counter = (cycles - timer->div_base) << timer->speed_shift;
+        const uint64_t edges = counter / period - get_system_counter(timer) / period;
+        if (edges != 0)
         {
-            timer->tima = timer->tma;
-            gb_cpu_request_interrupt(timer->cpu, GB_INTERRUPT_TIMER);
+            step_tima(timer, edges);
         }
     }
+
+    timer->cycles = cycles;
+    update_next_interrupt(timer);
 }
+
+void gb_timer_tick(struct GbTimer *timer, const uint8_t t_cycles) { gb_timer_sync(timer, timer->cycles + t_cycles); }
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/utils/atomic.h"
+
+#if defined(_WIN32)
+#    include <windows.h>
+#endif
+
+#if defined(_WIN32)
+
+void gb_atomic_init(struct GbAtomic *atomic, const size_t value) { atomic->value = (void *) value; }
+
+// The interlocked functions are full barriers, stronger than the acquire and release they stand in for
+size_t gb_atomic_load(struct GbAtomic *atomic)
+{
+    return (size_t) InterlockedCompareExchangePointer(&atomic->value, NULL, NULL);
+}
+
+void gb_atomic_store(struct GbAtomic *atomic, const size_t value)
+{
+    InterlockedExchangePointer(&atomic->value, (void *) value);
+}
+
+size_t gb_atomic_fetch_add(struct GbAtomic *atomic, const size_t value)
+{
+#    if defined(_WIN64)
+    return (size_t) InterlockedExchangeAdd64((volatile LONG64 *) &atomic->value, (LONG64) value);
+#    else
+    return (size_t) InterlockedExchangeAdd((volatile LONG *) &atomic->value, (LONG) value);
+#    endif
+}
+
+#else
+
+void gb_atomic_init(struct GbAtomic *atomic, const size_t value) { atomic_init(&atomic->value, value); }
+
+size_t gb_atomic_load(struct GbAtomic *atomic) { return atomic_load_explicit(&atomic->value, memory_order_acquire); }
+
+void gb_atomic_store(struct GbAtomic *atomic, const size_t value)
+{
+    atomic_store_explicit(&atomic->value, value, memory_order_release);
+}
+
+size_t gb_atomic_fetch_add(struct GbAtomic *atomic, const size_t value)
+{
+    return atomic_fetch_add_explicit(&atomic->value, value, memory_order_acq_rel);
+}
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#if !defined(_WIN32)
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "gb/utils/filesystem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#    include <windows.h>
+#else
+#    include <dirent.h>
+#    include <sys/stat.h>
+#endif
+
+static char *join_path(const char *directory, const char *name)
+{
+    const size_t length = strlen(directory) + 1 + strlen(name) + 1;
+    char *path = malloc(length);
+    snprintf(path, length, "%s/%s", directory, name);
+    return path;
+}
+
+#if defined(_WIN32)
+
+static int64_t to_nanoseconds(const FILETIME time)
+{
+    // FILETIME counts 100 nanosecond intervals
+    return (int64_t) ((((uint64_t) time.dwHighDateTime << 32) | time.dwLowDateTime) * 100);
+}
+
+bool gb_file_get_info(const char *path, struct GbFileInfo *info)
+{
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data))
+    {
+        return false;
+    }
+
+    info->size = ((uint64_t) data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    info->modified = to_nanoseconds(data.ftLastWriteTime);
+    return true;
+}
+
+bool gb_directory_walk(
+    const char *directory,
+    void (*callback)(const char *path, void *user_data),
+    void *user_data)
+{
+    char *pattern = join_path(directory, "*");
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA(pattern, &data);
+    free(pattern);
+    if (find == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    do
+    {
+        if (strcmp(data.cFileName, ".") == 0 || strcmp(data.cFileName, "..") == 0)
+        {
+            continue;
+        }
+
+        char *path = join_path(directory, data.cFileName);
+        if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+        {
+            if ((data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0)
+            {
+                gb_directory_walk(path, callback, user_data);
+            }
+        }
+        else
+        {
+            callback(path, user_data);
+        }
+
+        free(path);
+    } while (FindNextFileA(find, &data));
+
+    FindClose(find);
+    return true;
+}
+
+#else
+
+bool gb_file_get_info(const char *path, struct GbFileInfo *info)
+{
+    struct stat status;
+    if (stat(path, &status) != 0)
+    {
+        return false;
+    }
+
+    info->size = (uint64_t) status.st_size;
+#    if defined(__APPLE__)
+    const struct timespec modified = status.st_mtimespec;
+#    else
+    const struct timespec modified = status.st_mtim;
+#    endif
+    info->modified = (int64_t) modified.tv_sec * 1000000000 + modified.tv_nsec;
+    return true;
+}
+
+bool gb_directory_walk(
+    const char *directory,
+    void (*callback)(const char *path, void *user_data),
+    void *user_data)
+{
+    DIR *handle = opendir(directory);
+    if (handle == NULL)
+    {
+        return false;
+    }
+
+    const struct dirent *entry = NULL;
+    while ((entry = readdir(handle)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+        {
+            continue;
+        }
+
+        char *path = join_path(directory, entry->d_name);
+
+        // Links to directories aren't followed as they could lead back up the tree, links to files are
+        struct stat status;
+        if (lstat(path, &status) == 0)
+        {
+            if (S_ISDIR(status.st_mode))
+            {
+                gb_directory_walk(path, callback, user_data);
+            }
+            else if (S_ISLNK(status.st_mode) && stat(path, &status) == 0 && S_ISREG(status.st_mode))
+            {
+                callback(path, user_data);
+            }
+            else if (S_ISREG(status.st_mode))
+            {
+                callback(path, user_data);
+            }
+        }
+
+        free(path);
+    }
+
+    closedir(handle);
+    return true;
+}
+
+#endif
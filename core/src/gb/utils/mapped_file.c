@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#if !defined(_WIN32)
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "gb/utils/mapped_file.h"
+
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include "gb/utils/log.h"
+
+#if defined(_WIN32)
+
+static struct GbMappedFile *map_file(const char *path, const size_t size, const bool writable)
+{
+    HANDLE file = CreateFileA(
+        path,
+        writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        writable ? OPEN_ALWAYS : OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to open %s\n", path);
+        return NULL;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || (!writable && file_size.QuadPart == 0))
+    {
+        gb_log(GB_LOG_ERROR, "Failed to get size of %s\n", path);
+        CloseHandle(file);
+        return NULL;
+    }
+
+    // A writable mapping larger than the file extends it
+    const size_t mapped_size = writable ? size : (size_t) file_size.QuadPart;
+    const uint64_t mapping_size = writable && (uint64_t) file_size.QuadPart < size ? size : 0;
+    HANDLE mapping = CreateFileMappingA(
+        file,
+        NULL,
+        writable ? PAGE_READWRITE : PAGE_READONLY,
+        (DWORD) (mapping_size >> 32),
+        (DWORD) mapping_size,
+        NULL);
+    if (mapping == NULL)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to map %s\n", path);
+        CloseHandle(file);
+        return NULL;
+    }
+
+    void *data = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, mapped_size);
+    if (data == NULL)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to map %s\n", path);
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return NULL;
+    }
+
+    struct GbMappedFile *mapped_file = malloc(sizeof(struct GbMappedFile));
+    mapped_file->data = data;
+    mapped_file->size = mapped_size;
+    mapped_file->writable = writable;
+    mapped_file->file = file;
+    mapped_file->mapping = mapping;
+    return mapped_file;
+}
+
+void gb_mapped_file_destroy(struct GbMappedFile *mapped_file)
+{
+    if (mapped_file->writable)
+    {
+        gb_mapped_file_flush(mapped_file, true);
+    }
+
+    UnmapViewOfFile(mapped_file->data);
+    CloseHandle(mapped_file->mapping);
+    CloseHandle(mapped_file->file);
+    free(mapped_file);
+}
+
+void gb_mapped_file_flush(struct GbMappedFile *mapped_file, const bool wait)
+{
+    FlushViewOfFile(mapped_file->data, 0);
+    if (wait)
+    {
+        FlushFileBuffers(mapped_file->file);
+    }
+}
+
+#else
+
+static struct GbMappedFile *map_file(const char *path, const size_t size, const bool writable)
+{
+    const int descriptor = writable ? open(path, O_RDWR | O_CREAT, 0644) : open(path, O_RDONLY);
+    if (descriptor < 0)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to open %s\n", path);
+        return NULL;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || (!writable && status.st_size == 0))
+    {
+        gb_log(GB_LOG_ERROR, "Failed to get size of %s\n", path);
+        close(descriptor);
+        return NULL;
+    }
+
+    if (writable && (size_t) status.st_size < size && ftruncate(descriptor, (off_t) size) != 0)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to resize %s\n", path);
+        close(descriptor);
+        return NULL;
+    }
+
+    const size_t mapped_size = writable ? size : (size_t) status.st_size;
+    void *data = mmap(
+        NULL,
+        mapped_size,
+        writable ? PROT_READ | PROT_WRITE : PROT_READ,
+        MAP_SHARED,
+        descriptor,
+        0);
+    if (data == MAP_FAILED)
+    {
+        gb_log(GB_LOG_ERROR, "Failed to map %s\n", path);
+        close(descriptor);
+        return NULL;
+    }
+
+    struct GbMappedFile *mapped_file = malloc(sizeof(struct GbMappedFile));
+    mapped_file->data = data;
+    mapped_file->size = mapped_size;
+    mapped_file->writable = writable;
+    mapped_file->descriptor = descriptor;
+    return mapped_file;
+}
+
+void gb_mapped_file_destroy(struct GbMappedFile *mapped_file)
+{
+    if (mapped_file->writable)
+    {
+        gb_mapped_file_flush(mapped_file, true);
+    }
+
+    munmap(mapped_file->data, mapped_file->size);
+    close(mapped_file->descriptor);
+    free(mapped_file);
+}
+
+void gb_mapped_file_flush(struct GbMappedFile *mapped_file, const bool wait)
+{
+    msync(mapped_file->data, mapped_file->size, wait ? MS_SYNC : MS_ASYNC);
+}
+
+#endif
+
+struct GbMappedFile *gb_mapped_file_create(const char *path, const size_t size) { return map_file(path, size, true); }
+
+struct GbMappedFile *gb_mapped_file_create_read_only(const char *path) { return map_file(path, 0, false); }
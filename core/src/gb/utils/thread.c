@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gb/utils/thread.h"
+
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#    include <windows.h>
+#endif
+
+// Threads start through a trampoline, as neither backend takes a function without a return value
+struct ThreadStart
+{
+    void (*function)(void *argument);
+    void *argument;
+};
+
+static struct ThreadStart *create_start(void (*function)(void *argument), void *argument)
+{
+    struct ThreadStart *start = malloc(sizeof(struct ThreadStart));
+    start->function = function;
+    start->argument = argument;
+    return start;
+}
+
+static void run_start(struct ThreadStart *start)
+{
+    void (*function)(void *argument) = start->function;
+    void *argument = start->argument;
+    free(start);
+    function(argument);
+}
+
+#if defined(_WIN32)
+
+static DWORD WINAPI run_thread(LPVOID start)
+{
+    run_start(start);
+    return 0;
+}
+
+bool gb_thread_create(struct GbThread *thread, void (*function)(void *argument), void *argument)
+{
+    struct ThreadStart *start = create_start(function, argument);
+    thread->handle = CreateThread(NULL, 0, run_thread, start, 0, NULL);
+    if (thread->handle == NULL)
+    {
+        free(start);
+        return false;
+    }
+
+    return true;
+}
+
+void gb_thread_join(struct GbThread *thread)
+{
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+}
+
+void gb_mutex_init(struct GbMutex *mutex) { InitializeSRWLock((PSRWLOCK) &mutex->lock); }
+
+void gb_mutex_destroy(struct GbMutex *mutex) { (void) mutex; }
+
+void gb_mutex_lock(struct GbMutex *mutex) { AcquireSRWLockExclusive((PSRWLOCK) &mutex->lock); }
+
+void gb_mutex_unlock(struct GbMutex *mutex) { ReleaseSRWLockExclusive((PSRWLOCK) &mutex->lock); }
+
+void gb_condition_init(struct GbCondition *condition)
+{
+    InitializeConditionVariable((PCONDITION_VARIABLE) &condition->condition);
+}
+
+void gb_condition_destroy(struct GbCondition *condition) { (void) condition; }
+
+void gb_condition_wait(struct GbCondition *condition, struct GbMutex *mutex)
+{
+    SleepConditionVariableSRW((PCONDITION_VARIABLE) &condition->condition, (PSRWLOCK) &mutex->lock, INFINITE, 0);
+}
+
+void gb_condition_signal(struct GbCondition *condition)
+{
+    WakeConditionVariable((PCONDITION_VARIABLE) &condition->condition);
+}
+
+void gb_condition_broadcast(struct GbCondition *condition)
+{
+    WakeAllConditionVariable((PCONDITION_VARIABLE) &condition->condition);
+}
+
+#else
+
+static void *run_thread(void *start)
+{
+    run_start(start);
+    return NULL;
+}
+
+bool gb_thread_create(struct GbThread *thread, void (*function)(void *argument), void *argument)
+{
+    struct ThreadStart *start = create_start(function, argument);
+    if (pthread_create(&thread->handle, NULL, run_thread, start) != 0)
+    {
+        free(start);
+        return false;
+    }
+
+    return true;
+}
+
+void gb_thread_join(struct GbThread *thread) { pthread_join(thread->handle, NULL); }
+
+void gb_mutex_init(struct GbMutex *mutex) { pthread_mutex_init(&mutex->lock, NULL); }
+
+void gb_mutex_destroy(struct GbMutex *mutex) { pthread_mutex_destroy(&mutex->lock); }
+
+void gb_mutex_lock(struct GbMutex *mutex) { pthread_mutex_lock(&mutex->lock); }
+
+void gb_mutex_unlock(struct GbMutex *mutex) { pthread_mutex_unlock(&mutex->lock); }
+
+void gb_condition_init(struct GbCondition *condition) { pthread_cond_init(&condition->condition, NULL); }
+
+void gb_condition_destroy(struct GbCondition *condition) { pthread_cond_destroy(&condition->condition); }
+
+void gb_condition_wait(struct GbCondition *condition, struct GbMutex *mutex)
+{
+    pthread_cond_wait(&condition->condition, &mutex->lock);
+}
+
+void gb_condition_signal(struct GbCondition *condition) { pthread_cond_signal(&condition->condition); }
+
+void gb_condition_broadcast(struct GbCondition *condition) { pthread_cond_broadcast(&condition->condition); }
+
+#endif
@@ -7,14 +7,17 @@
 #pragma once
 
 #include <SDL3/SDL.h>
+#include <gb/definitions.h>
 
 struct Gb;
+struct GbAudioOutput;
 
 struct Emulator
 {
     // SDL Objects
     SDL_Window *window;
     SDL_Renderer *renderer;
+    SDL_AudioStream *audio_stream;
 
     // Textures
     SDL_Texture *game_screen_texture;
@@ -22,8 +25,16 @@ struct Emulator
     SDL_Texture *tile_maps_texture;
     SDL_Texture *oam_texture;
 
+    // Staging buffer for the changed rows of the game screen
+    uint32_t game_screen_pixels[GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT];
+
     // GameBoy
     struct Gb *gb;
+    uint32_t frames_since_save_flush;
+    uint8_t buttons; // GbButton bits of the keys held down
+
+    // Resamples the APU output for the audio thread
+    struct GbAudioOutput *audio_output;
 
     // Others
     bool should_close;
@@ -9,12 +9,16 @@
 #define CIMGUI_DEFINE_ENUMS_AND_STRUCTS
 #include <cimgui.h>
 #include <cimgui_impl.h>
+#include <gb/apu.h>
+#include <gb/audio_output.h>
 #include <gb/cpu.h>
 #include <gb/definitions.h>
 #include <gb/gb.h>
+#include <gb/joypad.h>
 #include <gb/mmu.h>
 #include <gb/ppu.h>
 #include <gb/utils/bits.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 #define TILE_DATA_WIDTH 24
@@ -26,14 +30,26 @@
 #define OAM_WIDTH 10
 #define OAM_HEIGHT 4
 
+// About five seconds
+#define SAVE_FLUSH_FRAMES 300
+
+// About 85 ms of audio, dynamic rate control keeps it half full
+#define AUDIO_SAMPLE_RATE 48000
+#define AUDIO_QUEUE_FRAMES 4096
+
 static SDL_Texture *emulator_create_texture(struct Emulator *, uint32_t width, uint32_t height);
 
 static void setup_imgui_style(void);
 
 static void emulator_poll_events(struct Emulator *);
+static uint8_t get_key_button(SDL_Keycode);
+static void emulator_handle_key(struct Emulator *, SDL_Keycode, bool pressed);
 static void emulator_update(struct Emulator *);
+static void SDLCALL audio_callback(void *user_data, SDL_AudioStream *stream, int additional_amount, int total_amount);
 static void emulator_render_textures(struct Emulator *);
 
+static uint32_t get_screen_color(uint16_t);
+static uint32_t get_cgb_screen_color(uint16_t);
 static void emulator_render_game_screen_texture(struct Emulator *);
 
 static void
@@ -53,7 +69,7 @@ static void emulator_show_oam(struct Emulator *);
 
 struct Emulator *emulator_create(void)
 {
-    SDL_Init(SDL_INIT_VIDEO);
+    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO);
 
     struct Emulator *emulator = malloc(sizeof(struct Emulator));
     emulator->window = SDL_CreateWindow("GameBoy", 1280, 720, SDL_WINDOW_RESIZABLE);
@@ -65,8 +81,19 @@ struct Emulator *emulator_create(void)
         = emulator_create_texture(emulator, TILE_MAPS_WIDTH * GB_TILE_SIZE, TILE_MAPS_HEIGHT * GB_TILE_SIZE);
     emulator->oam_texture = emulator_create_texture(emulator, OAM_WIDTH * GB_TILE_SIZE, OAM_HEIGHT * GB_TILE_SIZE);
     emulator->gb = NULL;
+    emulator->frames_since_save_flush = 0;
+    emulator->buttons = 0;
     emulator->should_close = false;
 
+    emulator->audio_output = gb_audio_output_create(GB_APU_SAMPLE_RATE, AUDIO_SAMPLE_RATE, AUDIO_QUEUE_FRAMES);
+    const SDL_AudioSpec audio_spec = { .format = SDL_AUDIO_S16, .channels = 2, .freq = AUDIO_SAMPLE_RATE };
+    emulator->audio_stream
+        = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &audio_spec, audio_callback, emulator);
+    if (emulator->audio_stream)
+    {
+        SDL_ResumeAudioStreamDevice(emulator->audio_stream);
+    }
+
     igCreateContext(NULL);
     ImGui_ImplSDL3_InitForSDLRenderer(emulator->window, emulator->renderer);
     ImGui_ImplSDLRenderer3_Init(emulator->renderer);
@@ -87,6 +114,14 @@ void emulator_destroy(struct Emulator *emulator)
         gb_destroy(emulator->gb);
     }
 
+    // Stops the audio thread before the queue it reads from goes away
+    if (emulator->audio_stream)
+    {
+        SDL_DestroyAudioStream(emulator->audio_stream);
+    }
+
+    gb_audio_output_destroy(emulator->audio_output);
+
     SDL_DestroyTexture(emulator->oam_texture);
     SDL_DestroyTexture(emulator->tile_maps_texture);
     SDL_DestroyTexture(emulator->tile_data_texture);
@@ -267,17 +302,108 @@ void emulator_poll_events(struct Emulator *emulator)
         case SDL_EVENT_QUIT:
             emulator->should_close = true;
             break;
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+            emulator_handle_key(emulator, event.key.key, event.type == SDL_EVENT_KEY_DOWN);
+            break;
         default:
             break;
         }
     }
 }
 
+uint8_t get_key_button(const SDL_Keycode key)
+{
+    switch (key)
+    {
+    case SDLK_RIGHT:
+        return GB_BUTTON_RIGHT;
+    case SDLK_LEFT:
+        return GB_BUTTON_LEFT;
+    case SDLK_UP:
+        return GB_BUTTON_UP;
+    case SDLK_DOWN:
+        return GB_BUTTON_DOWN;
+    case SDLK_X:
+        return GB_BUTTON_A;
+    case SDLK_Z:
+        return GB_BUTTON_B;
+    case SDLK_BACKSPACE:
+        return GB_BUTTON_SELECT;
+    case SDLK_RETURN:
+        return GB_BUTTON_START;
+    default:
+        return 0;
+    }
+}
+
+void emulator_handle_key(struct Emulator *emulator, const SDL_Keycode key, const bool pressed)
+{
+    const uint8_t button = get_key_button(key);
+    if (button == 0)
+    {
+        return;
+    }
+
+    emulator->buttons = pressed ? (uint8_t) (emulator->buttons | button) : (uint8_t) (emulator->buttons & ~button);
+
+    // Events are handled between frames, so the change applies right away
+    if (emulator->gb)
+    {
+        gb_set_input(emulator->gb, emulator->buttons, emulator->gb->cpu->cycles);
+    }
+}
+
 void emulator_update(struct Emulator *emulator)
 {
     if (emulator->gb)
     {
-        gb_run_frame(emulator->gb);
+        // Stopping at V-Blank shows every frame right after it was finished
+        gb_run_until_vblank(emulator->gb);
+
+        // Test ROMs print their results over the serial port
+        uint8_t serial_output[256];
+        size_t serial_count = gb_take_serial_output(emulator->gb, serial_output, sizeof(serial_output));
+        if (serial_count != 0)
+        {
+            fwrite(serial_output, 1, serial_count, stdout);
+            fflush(stdout);
+        }
+
+        int16_t samples[1024 * 2];
+        size_t frames = 0;
+        while ((frames = gb_take_audio_samples(emulator->gb, samples, 1024)) != 0)
+        {
+            gb_audio_output_write(emulator->audio_output, samples, frames);
+        }
+
+        emulator->frames_since_save_flush += 1;
+        if (emulator->frames_since_save_flush == SAVE_FLUSH_FRAMES)
+        {
+            gb_flush_save(emulator->gb);
+            emulator->frames_since_save_flush = 0;
+        }
+    }
+}
+
+// Runs on the audio thread
+void SDLCALL audio_callback(void *user_data, SDL_AudioStream *stream, const int additional_amount, int total_amount)
+{
+    (void) total_amount;
+
+    struct Emulator *emulator = user_data;
+    int16_t samples[512 * 2];
+    size_t remaining = (size_t) additional_amount / (sizeof(int16_t) * 2);
+    while (remaining != 0)
+    {
+        const size_t frames = gb_audio_output_read(emulator->audio_output, samples, remaining < 512 ? remaining : 512);
+        if (frames == 0)
+        {
+            break;
+        }
+
+        SDL_PutAudioStreamData(stream, samples, (int) (frames * sizeof(int16_t) * 2));
+        remaining -= frames;
     }
 }
 
@@ -294,40 +420,69 @@ void emulator_render_textures(struct Emulator *emulator)
     emulator_render_oam_texture(emulator);
 }
 
+uint32_t get_screen_color(const uint16_t shade)
+{
+    switch (shade)
+    {
+    case GB_COLOR_WHITE:
+        return 0xff000000;
+    case GB_COLOR_LIGHT_GRAY:
+        return 0xff555555;
+    case GB_COLOR_DARK_GRAY:
+        return 0xffaaaaaa;
+    case GB_COLOR_BLACK:
+        return 0xffffffff;
+    default:
+        return 0xff000000;
+    }
+}
+
+// CGB mode stores 15-bit colors in the screen
+uint32_t get_cgb_screen_color(const uint16_t color)
+{
+    const uint32_t red = color & 0x1fu;
+    const uint32_t green = (color >> 5) & 0x1fu;
+    const uint32_t blue = (color >> 10) & 0x1fu;
+    return 0xff000000 | (red << 19) | ((red >> 2) << 16) | (green << 11) | ((green >> 2) << 8) | (blue << 3)
+        | (blue >> 2);
+}
+
 void emulator_render_game_screen_texture(struct Emulator *emulator)
 {
-    int pitch = 0;
-    void *pixels_ptr = NULL;
-    SDL_LockTexture(emulator->game_screen_texture, NULL, &pixels_ptr, &pitch);
+    // Only finished frames are shown, static ones such as menus and pause screens don't upload anything
+    uint64_t dirty_lines[GB_PPU_DIRTY_WORDS];
+    const uint16_t *screen = gb_ppu_take_frame(emulator->gb->ppu, dirty_lines);
+    if (!screen)
+    {
+        return;
+    }
 
-    uint32_t *pixels = pixels_ptr;
-    for (uint32_t i = 0; i < GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT; ++i)
+    // Every run of changed rows is converted and uploaded on its own
+    uint32_t y = 0;
+    while (y < GB_SCREEN_HEIGHT)
     {
-        const enum GbColor color_enum = emulator->gb->ppu->screen[i];
+        if (!GB_BIT_CHECK(dirty_lines[y / 64], y % 64))
+        {
+            y += 1;
+            continue;
+        }
 
-        uint32_t color = 0xff000000;
-        switch (color_enum)
+        const uint32_t first_y = y;
+        while (y < GB_SCREEN_HEIGHT && GB_BIT_CHECK(dirty_lines[y / 64], y % 64))
         {
-        case GB_COLOR_WHITE:
-            color = 0xff000000;
-            break;
-        case GB_COLOR_LIGHT_GRAY:
-            color = 0xff555555;
-            break;
-        case GB_COLOR_DARK_GRAY:
-            color = 0xffaaaaaa;
-            break;
-        case GB_COLOR_BLACK:
-            color = 0xffffffff;
-            break;
-        default:
-            break;
+            y += 1;
         }
 
-        pixels[i] = color;
-    }
+        uint32_t *pixels = &emulator->game_screen_pixels[first_y * GB_SCREEN_WIDTH];
+        uint32_t (*convert)(uint16_t) = emulator->gb->cgb ? get_cgb_screen_color : get_screen_color;
+        for (uint32_t i = 0; i < (y - first_y) * GB_SCREEN_WIDTH; ++i)
+        {
+            pixels[i] = convert(screen[first_y * GB_SCREEN_WIDTH + i]);
+        }
 
-    SDL_UnlockTexture(emulator->game_screen_texture);
+        const SDL_Rect rect = { 0, (int) first_y, GB_SCREEN_WIDTH, (int) (y - first_y) };
+        SDL_UpdateTexture(emulator->game_screen_texture, &rect, pixels, (int) (GB_SCREEN_WIDTH * sizeof(uint32_t)));
+    }
 }
 
 void render_tile(
@@ -441,7 +596,7 @@ void emulator_render_oam_texture(struct Emulator *emulator)
         const uint32_t x = i % OAM_WIDTH;
         const uint32_t y = i / OAM_WIDTH;
 
-        const uint32_t tile_index = emulator->gb->mmu->oam[(i * 4) + 0x02];
+        const uint32_t tile_index = emulator->gb->ppu->oam[(i * 4) + 0x02];
         const uint32_t start = tile_index * 16;
         render_tile(x, y, emulator->gb->ppu->vram, start, OAM_WIDTH, pixels);
     }
@@ -466,6 +621,10 @@ static void file_callback(void *user_data, const char *const *file_list, const i
     }
 
     emulator->gb = gb_create(file_list[0]);
+    if (emulator->gb)
+    {
+        gb_set_rtc_clock(emulator->gb, GB_RTC_CLOCK_WALL);
+    }
 }
 
 void emulator_render_imgui(struct Emulator *emulator)
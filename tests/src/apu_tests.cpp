@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <gb/apu.h>
+#include <gb/cpu.h>
+#include <gb/gb.h>
+#include <gb/timer.h>
+
+TEST_CASE("APU registers read back with their unused bits set")
+{
+    Gb *gb = gb_create(nullptr);
+    GbApu *apu = gb->apu;
+
+    REQUIRE(gb_apu_read(apu, 0xff26) == 0xf1);
+    REQUIRE(gb_apu_read(apu, 0xff13) == 0xff);
+    REQUIRE(gb_apu_read(apu, 0xff15) == 0xff);
+
+    // Turning the APU off clears the registers and ignores writes, but keeps the wave RAM
+    gb_apu_write(apu, 0xff30, 0x12);
+    gb_apu_write(apu, 0xff26, 0x00);
+    REQUIRE(gb_apu_read(apu, 0xff26) == 0x70);
+    REQUIRE(gb_apu_read(apu, 0xff11) == 0x3f);
+    gb_apu_write(apu, 0xff12, 0xf0);
+    REQUIRE(gb_apu_read(apu, 0xff12) == 0x00);
+    REQUIRE(gb_apu_read(apu, 0xff30) == 0x12);
+
+    gb_apu_write(apu, 0xff26, 0x80);
+    gb_apu_write(apu, 0xff12, 0xf0);
+    REQUIRE(gb_apu_read(apu, 0xff12) == 0xf0);
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("APU length counters stop channels on the frame sequencer")
+{
+    Gb *gb = gb_create(nullptr);
+    GbApu *apu = gb->apu;
+
+    // Power cycling restarts the frame sequencer at its first step, and resetting DIV lines it up with cycle 0
+    gb_timer_reset_div(gb->timer);
+    gb_apu_write(apu, 0xff26, 0x00);
+    gb_apu_write(apu, 0xff26, 0x80);
+
+    // Square 2 with two length steps left, which come at the first and third step
+    gb_apu_write(apu, 0xff17, 0xf0);
+    gb_apu_write(apu, 0xff16, 0x3e);
+    gb_apu_write(apu, 0xff19, 0xc0);
+    REQUIRE(gb_apu_read(apu, 0xff26) == 0xf2);
+
+    gb_apu_sync(apu, 3 * GB_APU_FRAME_SEQUENCER_CYCLES - 1);
+    REQUIRE(gb_apu_read(apu, 0xff26) == 0xf2);
+    gb_apu_sync(apu, 3 * GB_APU_FRAME_SEQUENCER_CYCLES);
+    REQUIRE(gb_apu_read(apu, 0xff26) == 0xf0);
+
+    // Switching the DAC off stops a channel right away
+    gb_apu_write(apu, 0xff1a, 0x80);
+    gb_apu_write(apu, 0xff1e, 0x80);
+    REQUIRE(gb_apu_read(apu, 0xff26) == 0xf4);
+    gb_apu_write(apu, 0xff1a, 0x00);
+    REQUIRE(gb_apu_read(apu, 0xff26) == 0xf0);
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("APU produces a sample every 64 cycles")
+{
+    Gb *gb = gb_create(nullptr);
+    GbApu *apu = gb->apu;
+
+    // A 1024 Hz square wave with 50% duty on both sides
+    gb_apu_write(apu, 0xff25, 0x22);
+    gb_apu_write(apu, 0xff16, 0x80);
+    gb_apu_write(apu, 0xff17, 0xf0);
+    gb_apu_write(apu, 0xff18, 0x80);
+    gb_apu_write(apu, 0xff19, 0x87);
+
+    gb_run_cycles(gb, 64 * 4096);
+    std::vector<int16_t> samples(GB_APU_BUFFER_FRAMES * 2);
+    const size_t frames = gb_take_audio_samples(gb, samples.data(), GB_APU_BUFFER_FRAMES);
+    REQUIRE(frames == gb->cpu->cycles / GB_APU_SAMPLE_CYCLES);
+    REQUIRE(gb_take_audio_samples(gb, samples.data(), GB_APU_BUFFER_FRAMES) == 0);
+
+    // Once the high-pass filter settled the wave swings around zero, a quarter of the full scale high
+    const auto settled = samples.begin() + 2048 * 2;
+    const auto end = samples.begin() + static_cast<std::ptrdiff_t>(frames * 2);
+    const auto [minimum, maximum] = std::minmax_element(settled, end);
+    REQUIRE(*maximum > 6000);
+    REQUIRE(*maximum < 10000);
+    REQUIRE(*minimum < -6000);
+    REQUIRE(*minimum > -10000);
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("APU records WAV files")
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "hyper_gb_apu_tests.wav";
+    Gb *gb = gb_create(nullptr);
+    GbApu *apu = gb->apu;
+
+    // More frames than the ring buffer holds
+    REQUIRE(gb_apu_start_wav(apu, path.string().c_str()));
+    gb_apu_sync(apu, static_cast<uint64_t>(GB_APU_SAMPLE_CYCLES) * (GB_APU_BUFFER_FRAMES * 3 + 5));
+    gb_apu_stop_wav(apu);
+
+    std::ifstream file(path, std::ios::binary);
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const size_t data_size = (GB_APU_BUFFER_FRAMES * 3 + 5) * 4;
+    REQUIRE(bytes.size() == 44 + data_size);
+    REQUIRE(std::equal(bytes.begin(), bytes.begin() + 4, "RIFF"));
+    REQUIRE(std::equal(bytes.begin() + 8, bytes.begin() + 12, "WAVE"));
+    REQUIRE((bytes[40] | bytes[41] << 8 | bytes[42] << 16 | bytes[43] << 24) == static_cast<int>(data_size));
+
+    file.close();
+    gb_destroy(gb);
+    std::filesystem::remove(path);
+}
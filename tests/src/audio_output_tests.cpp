@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <gb/apu.h>
+#include <gb/audio_output.h>
+
+static std::vector<int16_t> make_tone(const double frequency, const size_t frames)
+{
+    std::vector<int16_t> samples(frames * 2);
+    for (size_t i = 0; i < frames; ++i)
+    {
+        const double phase = 2.0 * 3.14159265358979323846 * frequency * static_cast<double>(i) / GB_APU_SAMPLE_RATE;
+        const auto value = static_cast<int16_t>(std::lround(16000.0 * std::sin(phase)));
+        samples[i * 2] = value;
+        samples[i * 2 + 1] = static_cast<int16_t>(-value);
+    }
+
+    return samples;
+}
+
+static int16_t get_peak(const std::vector<int16_t> &samples, const size_t first_frame)
+{
+    int16_t peak = 0;
+    for (size_t i = first_frame * 2; i < samples.size(); ++i)
+    {
+        peak = std::max(peak, static_cast<int16_t>(std::abs(samples[i])));
+    }
+
+    return peak;
+}
+
+TEST_CASE("Audio output resamples to the host rate")
+{
+    GbAudioOutput *output = gb_audio_output_create(GB_APU_SAMPLE_RATE, 48000, 16384);
+    gb_audio_output_set_dynamic_rate(output, false);
+
+    // Written in uneven batches, which must not change the result
+    const std::vector<int16_t> tone = make_tone(1000.0, GB_APU_SAMPLE_RATE / 8);
+    for (size_t offset = 0; offset < GB_APU_SAMPLE_RATE / 8; offset += 777)
+    {
+        const size_t frames = std::min<size_t>(777, GB_APU_SAMPLE_RATE / 8 - offset);
+        gb_audio_output_write(output, &tone[offset * 2], frames);
+    }
+
+    // An eighth of a second, minus the frames still waiting for their last taps
+    const size_t queued = gb_audio_output_get_queued(output);
+    REQUIRE(queued <= 6000);
+    REQUIRE(queued >= 6000 - GB_AUDIO_OUTPUT_TAPS);
+
+    std::vector<int16_t> samples(queued * 2);
+    REQUIRE(gb_audio_output_read(output, samples.data(), queued) == queued);
+    REQUIRE(gb_audio_output_get_queued(output) == 0);
+
+    const int16_t peak = get_peak(samples, 100);
+    REQUIRE(peak > 15800);
+    REQUIRE(peak < 16200);
+    REQUIRE(samples[1000 * 2] == -samples[1000 * 2 + 1]);
+
+    gb_audio_output_destroy(output);
+}
+
+TEST_CASE("Audio output removes what the host rate can't represent")
+{
+    GbAudioOutput *output = gb_audio_output_create(GB_APU_SAMPLE_RATE, 48000, 16384);
+    gb_audio_output_set_dynamic_rate(output, false);
+
+    // Above 24 kHz the tone would fold back into the audible range
+    const std::vector<int16_t> tone = make_tone(30000.0, 8192);
+    gb_audio_output_write(output, tone.data(), 8192);
+
+    std::vector<int16_t> samples(gb_audio_output_get_queued(output) * 2);
+    gb_audio_output_read(output, samples.data(), samples.size() / 2);
+    REQUIRE(get_peak(samples, 100) < 200);
+
+    gb_audio_output_destroy(output);
+}
+
+TEST_CASE("Audio output drops frames once the queue is full")
+{
+    GbAudioOutput *output = gb_audio_output_create(GB_APU_SAMPLE_RATE, GB_APU_SAMPLE_RATE, 1000);
+    gb_audio_output_set_dynamic_rate(output, false);
+
+    const std::vector<int16_t> tone = make_tone(1000.0, 2048);
+    gb_audio_output_write(output, tone.data(), 2048);
+    REQUIRE(gb_audio_output_get_queued(output) == 1024);
+    REQUIRE(output->dropped_frames == 2048 - 1024 - GB_AUDIO_OUTPUT_TAPS / 2);
+
+    // At the same rate the filter only delays the input
+    std::vector<int16_t> samples(1024 * 2);
+    REQUIRE(gb_audio_output_read(output, samples.data(), 2000) == 1024);
+    for (size_t i = 100; i < 1024; ++i)
+    {
+        REQUIRE(std::abs(samples[i * 2] - tone[i * 2]) <= 2);
+    }
+
+    gb_audio_output_destroy(output);
+}
+
+TEST_CASE("Audio output steers the queue towards half full")
+{
+    GbAudioOutput *output = gb_audio_output_create(GB_APU_SAMPLE_RATE, 48000, 4096);
+    const std::vector<int16_t> tone = make_tone(1000.0, 1024);
+
+    // The first batch also fills the filter, so the comparison starts with the second
+    gb_audio_output_write(output, tone.data(), 1024);
+    const size_t first_queued = gb_audio_output_get_queued(output);
+    gb_audio_output_write(output, tone.data(), 1024);
+    REQUIRE(output->rate_adjustment < 1.0);
+    const size_t produced_while_empty = gb_audio_output_get_queued(output) - first_queued;
+
+    // Fuller than half, the same input gives fewer frames
+    while (gb_audio_output_get_queued(output) < 3000)
+    {
+        gb_audio_output_write(output, tone.data(), 64);
+    }
+
+    const size_t queued = gb_audio_output_get_queued(output);
+    gb_audio_output_write(output, tone.data(), 1024);
+    REQUIRE(output->rate_adjustment > 1.0);
+    REQUIRE(gb_audio_output_get_queued(output) - queued < produced_while_empty);
+
+    gb_audio_output_destroy(output);
+}
@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <gb/cartridge.h>
+#include <gb/cpu.h>
+#include <gb/rom_cache.h>
+
+// Every bank starts with its own number, so reads tell which bank is mapped
+static GbCartridge *create_cartridge(
+    const uint8_t type,
+    const uint8_t rom_size,
+    const uint8_t ram_size,
+    const char *save = nullptr)
+{
+    std::vector<uint8_t> rom(static_cast<size_t>(0x8000) << rom_size, 0x00);
+    for (size_t bank = 0; bank < rom.size() / GB_CARTRIDGE_ROM_BANK_SIZE; ++bank)
+    {
+        rom[bank * GB_CARTRIDGE_ROM_BANK_SIZE + 0x0200] = static_cast<uint8_t>(bank);
+        rom[bank * GB_CARTRIDGE_ROM_BANK_SIZE + 0x0201] = static_cast<uint8_t>(bank >> 8);
+    }
+
+    rom[0x0147] = type;
+    rom[0x0148] = rom_size;
+    rom[0x0149] = ram_size;
+    return gb_cartridge_create_from_memory(rom.data(), rom.size(), save);
+}
+
+static uint16_t read_bank(GbCartridge *cartridge, const uint16_t page_address)
+{
+    const uint16_t address = page_address + 0x0200;
+    const uint8_t low = gb_cartridge_read(cartridge, address);
+    const uint8_t high = gb_cartridge_read(cartridge, address + 1);
+    return static_cast<uint16_t>(low | high << 8);
+}
+
+TEST_CASE("Cartridge headers are parsed and validated")
+{
+    std::vector<uint8_t> rom(0x20000, 0x00);
+    const char title[] = "HYPER TEST";
+    std::copy(std::begin(title), std::end(title) - 1, rom.begin() + 0x0134);
+    rom[0x0147] = 0x10;
+    rom[0x0148] = 0x02;
+    rom[0x0149] = 0x03;
+
+    uint8_t checksum = 0;
+    for (size_t i = 0x0134; i < 0x014d; ++i)
+    {
+        checksum = static_cast<uint8_t>(checksum - rom[i] - 1);
+    }
+
+    rom[0x014d] = checksum;
+
+    GbCartridgeHeader header {};
+    gb_cartridge_header_parse(&header, &rom[GB_CARTRIDGE_HEADER_ADDRESS]);
+    REQUIRE(std::string(header.title) == "HYPER TEST");
+    REQUIRE(header.mapper == GB_MAPPER_MBC3);
+    REQUIRE(header.battery);
+    REQUIRE(header.timer);
+    REQUIRE(header.rom_bytes == 0x20000);
+    REQUIRE(header.ram_bytes == 0x8000);
+    REQUIRE(header.header_checksum_valid);
+    REQUIRE(gb_cartridge_header_validate(&header, rom.size()) == GB_CARTRIDGE_HEADER_VALID);
+
+    // Truncated ROMs are refused
+    REQUIRE(gb_cartridge_header_validate(&header, 0x10000) == GB_CARTRIDGE_HEADER_TRUNCATED);
+    REQUIRE(gb_cartridge_create_from_memory(rom.data(), 0x10000, nullptr) == nullptr);
+
+    // The checksum bytes themselves don't count, 0x2e8 is the sum of the title
+    rom[0x014e] = 0x12;
+    REQUIRE(gb_cartridge_compute_global_checksum(rom.data(), rom.size()) == 0x2e8 + 0x10 + 0x02 + 0x03 + checksum);
+}
+
+TEST_CASE("ROM only cartridges map both banks")
+{
+    GbCartridge *cartridge = create_cartridge(0x00, 0x00, 0x00);
+    REQUIRE(cartridge->header.mapper == GB_MAPPER_NONE);
+    REQUIRE(read_bank(cartridge, 0x0000) == 0);
+    REQUIRE(read_bank(cartridge, 0x4000) == 1);
+
+    gb_cartridge_write(cartridge, 0x2000, 0x05);
+    REQUIRE(read_bank(cartridge, 0x4000) == 1);
+    REQUIRE(gb_cartridge_read_ram(cartridge, 0x0000) == 0xff);
+
+    gb_cartridge_destroy(cartridge);
+}
+
+TEST_CASE("MBC1 switches ROM and RAM banks")
+{
+    // 1 MiB of ROM and 32 KiB of RAM
+    GbCartridge *cartridge = create_cartridge(0x03, 0x05, 0x03);
+    REQUIRE(cartridge->header.mapper == GB_MAPPER_MBC1);
+    REQUIRE(cartridge->header.battery);
+
+    gb_cartridge_write(cartridge, 0x2000, 0x05);
+    REQUIRE(read_bank(cartridge, 0x4000) == 5);
+
+    gb_cartridge_write(cartridge, 0x2000, 0x00);
+    REQUIRE(read_bank(cartridge, 0x4000) == 1);
+
+    // The upper bits turn the unreachable bank 0x20 into 0x21
+    gb_cartridge_write(cartridge, 0x4000, 0x01);
+    REQUIRE(read_bank(cartridge, 0x4000) == 0x21);
+    REQUIRE(read_bank(cartridge, 0x0000) == 0x00);
+
+    gb_cartridge_write(cartridge, 0x6000, 0x01);
+    REQUIRE(read_bank(cartridge, 0x0000) == 0x20);
+
+    // RAM reads as open bus until enabled
+    gb_cartridge_write_ram(cartridge, 0x0000, 0x12);
+    REQUIRE(gb_cartridge_read_ram(cartridge, 0x0000) == 0xff);
+
+    gb_cartridge_write(cartridge, 0x0000, 0x0a);
+    gb_cartridge_write_ram(cartridge, 0x0000, 0x12);
+    REQUIRE(gb_cartridge_read_ram(cartridge, 0x0000) == 0x12);
+
+    gb_cartridge_write(cartridge, 0x4000, 0x02);
+    REQUIRE(gb_cartridge_read_ram(cartridge, 0x0000) == 0xff);
+
+    gb_cartridge_write(cartridge, 0x4000, 0x01);
+    REQUIRE(gb_cartridge_read_ram(cartridge, 0x0000) == 0x12);
+
+    gb_cartridge_destroy(cartridge);
+}
+
+TEST_CASE("MBC2 decodes its registers from address bit 8")
+{
+    GbCartridge *cartridge = create_cartridge(0x06, 0x03, 0x00);
+    REQUIRE(cartridge->header.mapper == GB_MAPPER_MBC2);
+
+    gb_cartridge_write(cartridge, 0x2000, 0x03);
+    REQUIRE(read_bank(cartridge, 0x4000) == 1);
+
+    gb_cartridge_write(cartridge, 0x2100, 0x03);
+    REQUIRE(read_bank(cartridge, 0x4000) == 3);
+
+    // Only the lower half of each byte is stored and the 512 of them repeat across the whole area
+    gb_cartridge_write(cartridge, 0x0000, 0x0a);
+    gb_cartridge_write_ram(cartridge, 0x0010, 0x5a);
+    REQUIRE(gb_cartridge_read_ram(cartridge, 0x0010) == 0xfa);
+    REQUIRE(gb_cartridge_read_ram(cartridge, 0x0210) == 0xfa);
+    REQUIRE(gb_cartridge_read_ram(cartridge, 0x1e10) == 0xfa);
+
+    gb_cartridge_destroy(cartridge);
+}
+
+TEST_CASE("MBC3 selects 128 ROM banks and 4 RAM banks")
+{
+    GbCartridge *cartridge = create_cartridge(0x13, 0x06, 0x03);
+    REQUIRE(cartridge->header.mapper == GB_MAPPER_MBC3);
+
+    gb_cartridge_write(cartridge, 0x2000, 0x7f);
+    REQUIRE(read_bank(cartridge, 0x4000) == 0x7f);
+
+    gb_cartridge_write(cartridge, 0x0000, 0x0a);
+    for (uint8_t bank = 0; bank < 4; ++bank)
+    {
+        gb_cartridge_write(cartridge, 0x4000, bank);
+        gb_cartridge_write_ram(cartridge, 0x1fff, bank);
+    }
+
+    gb_cartridge_write(cartridge, 0x4000, 0x02);
+    REQUIRE(gb_cartridge_read_ram(cartridge, 0x1fff) == 0x02);
+
+    gb_cartridge_destroy(cartridge);
+}
+
+TEST_CASE("MBC5 maps bank 0 and nine bank bits")
+{
+    // 8 MiB of ROM
+    GbCartridge *cartridge = create_cartridge(0x19, 0x08, 0x00);
+    REQUIRE(cartridge->header.mapper == GB_MAPPER_MBC5);
+
+    gb_cartridge_write(cartridge, 0x2000, 0x00);
+    REQUIRE(read_bank(cartridge, 0x4000) == 0);
+
+    gb_cartridge_write(cartridge, 0x2000, 0x23);
+    gb_cartridge_write(cartridge, 0x3000, 0x01);
+    REQUIRE(read_bank(cartridge, 0x4000) == 0x123);
+
+    gb_cartridge_destroy(cartridge);
+}
+
+TEST_CASE("Bank numbers wrap around the size of the ROM")
+{
+    // 256 KiB, 16 banks
+    GbCartridge *cartridge = create_cartridge(0x01, 0x03, 0x00);
+
+    gb_cartridge_write(cartridge, 0x2000, 0x13);
+    REQUIRE(read_bank(cartridge, 0x4000) == 0x03);
+
+    gb_cartridge_destroy(cartridge);
+}
+
+TEST_CASE("Battery backed RAM persists through the save file")
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "hyper_gb_cartridge_tests.sav";
+    std::filesystem::remove(path);
+
+    GbCartridge *cartridge = create_cartridge(0x03, 0x00, 0x03, path.string().c_str());
+    REQUIRE(cartridge->save != nullptr);
+
+    gb_cartridge_write(cartridge, 0x0000, 0x0a);
+    gb_cartridge_write(cartridge, 0x6000, 0x01);
+    gb_cartridge_write(cartridge, 0x4000, 0x03);
+    gb_cartridge_write_ram(cartridge, 0x1234, 0x56);
+    gb_cartridge_destroy(cartridge);
+
+    REQUIRE(std::filesystem::file_size(path) == 0x8000);
+
+    cartridge = create_cartridge(0x03, 0x00, 0x03, path.string().c_str());
+    gb_cartridge_write(cartridge, 0x0000, 0x0a);
+    gb_cartridge_write(cartridge, 0x6000, 0x01);
+    gb_cartridge_write(cartridge, 0x4000, 0x03);
+    REQUIRE(gb_cartridge_read_ram(cartridge, 0x1234) == 0x56);
+    gb_cartridge_destroy(cartridge);
+
+    // Without a battery nothing is saved
+    cartridge = create_cartridge(0x02, 0x00, 0x03, path.string().c_str());
+    REQUIRE(cartridge->save == nullptr);
+    gb_cartridge_destroy(cartridge);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Cartridges of the same game share one mapped ROM")
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::filesystem::path path = directory / "hyper_gb_rom_cache_tests.gb";
+    const std::filesystem::path copy_path = directory / "hyper_gb_rom_cache_tests_copy.gb";
+
+    std::vector<uint8_t> rom(0x10000, 0x00);
+    rom[0x0147] = 0x01;
+    rom[0x0148] = 0x01;
+    rom[0x4000 * 3] = 0x42;
+    for (const std::filesystem::path &file : { path, copy_path })
+    {
+        std::ofstream stream(file, std::ios::binary);
+        stream.write(reinterpret_cast<const char *>(rom.data()), static_cast<std::streamsize>(rom.size()));
+    }
+
+    GbCartridge *first = gb_cartridge_create(path.string().c_str());
+    GbCartridge *second = gb_cartridge_create(path.string().c_str());
+    GbCartridge *copy = gb_cartridge_create(copy_path.string().c_str());
+    REQUIRE(first->shared_rom != nullptr);
+    REQUIRE(first->rom == second->rom);
+    REQUIRE(first->rom == copy->rom);
+    REQUIRE(first->shared_rom->references == 3);
+
+    // Bank switches only move the pointers of each cartridge
+    gb_cartridge_write(first, 0x2000, 0x03);
+    REQUIRE(gb_cartridge_read(first, 0x4000) == 0x42);
+    REQUIRE(gb_cartridge_read(second, 0x4000) == 0x00);
+
+    gb_cartridge_destroy(copy);
+    gb_cartridge_destroy(second);
+    gb_cartridge_destroy(first);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(copy_path);
+}
+
+TEST_CASE("MBC3 clock counts emulated time")
+{
+    constexpr uint64_t SECOND = 4194304;
+
+    GbCpu *cpu = gb_cpu_create();
+    GbCartridge *cartridge = create_cartridge(0x10, 0x00, 0x02);
+    cartridge->cpu = cpu;
+    REQUIRE(cartridge->rtc != nullptr);
+
+    const auto latch = [&]
+    {
+        gb_cartridge_write(cartridge, 0x6000, 0x00);
+        gb_cartridge_write(cartridge, 0x6000, 0x01);
+    };
+
+    const auto read_register = [&](const uint8_t reg)
+    {
+        gb_cartridge_write(cartridge, 0x4000, reg);
+        return gb_cartridge_read_ram(cartridge, 0x0000);
+    };
+
+    gb_cartridge_write(cartridge, 0x0000, 0x0a);
+    cpu->cycles = 3 * 86400 * SECOND + 3661 * SECOND + SECOND / 2;
+    REQUIRE(read_register(0x08) == 0x00);
+
+    // Reads only see the time of the last latch
+    latch();
+    REQUIRE(read_register(0x08) == 1);
+    REQUIRE(read_register(0x09) == 1);
+    REQUIRE(read_register(0x0a) == 1);
+    REQUIRE(read_register(0x0b) == 3);
+
+    // The started half second still counts
+    cpu->cycles += SECOND / 2;
+    latch();
+    REQUIRE(read_register(0x08) == 2);
+
+    // Halted clocks keep their time
+    gb_cartridge_write(cartridge, 0x4000, 0x0c);
+    gb_cartridge_write_ram(cartridge, 0x0000, 0x40);
+    cpu->cycles += 100 * SECOND;
+    latch();
+    REQUIRE(read_register(0x08) == 2);
+
+    // Running past day 511 sets the carry
+    gb_cartridge_write(cartridge, 0x4000, 0x0b);
+    gb_cartridge_write_ram(cartridge, 0x0000, 0xff);
+    gb_cartridge_write(cartridge, 0x4000, 0x0c);
+    gb_cartridge_write_ram(cartridge, 0x0000, 0x01);
+    cpu->cycles += 86400 * SECOND;
+    latch();
+    REQUIRE(read_register(0x0b) == 0x00);
+    REQUIRE(read_register(0x0c) == 0x80);
+
+    // RAM banks are still there next to the clock
+    gb_cartridge_write(cartridge, 0x4000, 0x00);
+    gb_cartridge_write_ram(cartridge, 0x0000, 0x12);
+    REQUIRE(read_register(0x00) == 0x12);
+
+    gb_cartridge_destroy(cartridge);
+    gb_cpu_destroy(cpu);
+}
+
+TEST_CASE("MBC3 clock state is part of the save file")
+{
+    constexpr uint64_t SECOND = 4194304;
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "hyper_gb_rtc_tests.sav";
+    std::filesystem::remove(path);
+
+    GbCpu *cpu = gb_cpu_create();
+    GbCartridge *cartridge = create_cartridge(0x10, 0x00, 0x02, path.string().c_str());
+    cartridge->cpu = cpu;
+    cpu->cycles = 75 * SECOND;
+    gb_cartridge_destroy(cartridge);
+
+    REQUIRE(std::filesystem::file_size(path) == 0x2000 + GB_RTC_SAVE_SIZE);
+
+    cpu->cycles = 0;
+    cartridge = create_cartridge(0x10, 0x00, 0x02, path.string().c_str());
+    cartridge->cpu = cpu;
+    REQUIRE(cartridge->rtc->registers[GB_RTC_SECONDS] == 15);
+    REQUIRE(cartridge->rtc->registers[GB_RTC_MINUTES] == 1);
+    gb_cartridge_destroy(cartridge);
+
+    gb_cpu_destroy(cpu);
+    std::filesystem::remove(path);
+}
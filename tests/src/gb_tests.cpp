@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <gb/cpu.h>
+#include <gb/gb.h>
+#include <gb/mmu.h>
+#include <gb/ppu.h>
+
+// 16 NOPs followed by JR -2, which spins forever
+static Gb *create_spinning_gb()
+{
+    Gb *gb = gb_create(nullptr);
+    for (uint16_t address = 0x100; address < 0x110; ++address)
+    {
+        gb_mmu_write(gb->mmu, address, 0x00);
+    }
+
+    gb_mmu_write(gb->mmu, 0x110, 0x18);
+    gb_mmu_write(gb->mmu, 0x111, 0xfe);
+    gb->cpu->interrupt_enable = 0;
+
+    return gb;
+}
+
+TEST_CASE("Stepping and cycle budgets run whole instructions")
+{
+    Gb *gb = create_spinning_gb();
+
+    REQUIRE(gb_step(gb) == 4);
+    REQUIRE(gb->cpu->registers.pc == 0x101);
+
+    REQUIRE(gb_run_until_pc(gb, 0x108, 1000) == 7 * 4);
+    REQUIRE(gb->cpu->registers.pc == 0x108);
+
+    // JR takes 12 cycles, so a budget can be overshot by the rest of it
+    const uint64_t cycles = gb_run_cycles(gb, 1000);
+    REQUIRE(cycles >= 1000);
+    REQUIRE(cycles < 1000 + 12);
+    REQUIRE(gb->ppu->cycles == gb->cpu->cycles);
+
+    // A PC that is never reached runs the whole budget
+    REQUIRE(gb_run_until_pc(gb, 0x4000, 500) >= 500);
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Running until V-Blank lines up with the PPU")
+{
+    Gb *gb = create_spinning_gb();
+
+    gb_run_until_vblank(gb);
+    REQUIRE(gb->ppu->ly == 144);
+    REQUIRE(gb->ppu->mode == GB_PPU_MODE_VBLANK);
+
+    // Every following run is one PPU frame long, give or take the instruction that crossed into V-Blank
+    for (uint32_t frame = 0; frame < 5; ++frame)
+    {
+        const uint64_t vblank_count = gb->ppu->vblank_count;
+        const uint64_t cycles = gb_run_until_vblank(gb);
+        REQUIRE(gb->ppu->vblank_count == vblank_count + 1);
+        REQUIRE(gb->ppu->ly == 144);
+        REQUIRE(cycles > 154 * 456 - 12);
+        REQUIRE(cycles < 154 * 456 + 12);
+    }
+
+    // Without the LCD there is no V-Blank to wait for
+    gb_ppu_set_lcd_control(gb->ppu, 0x11);
+    REQUIRE(gb_run_until_vblank(gb) >= 2 * 154 * 456);
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("STOP switches to double speed once KEY1 is armed")
+{
+    Gb *gb = create_spinning_gb();
+    gb_mmu_write(gb->mmu, 0x100, 0x10);
+
+    // Unarmed, STOP leaves the speed alone
+    REQUIRE(gb_step(gb) == 4);
+    REQUIRE_FALSE(gb->cpu->double_speed);
+
+    // The switch pauses the CPU for 2050 M-cycles on top of STOP itself
+    gb->cpu->registers.pc = 0x100;
+    gb->cpu->speed_switch_armed = true;
+    REQUIRE(gb_step(gb) == 2050 * 4 + 2);
+    REQUIRE(gb->cpu->double_speed);
+    REQUIRE_FALSE(gb->cpu->speed_switch_armed);
+
+    // A NOP now takes half the master cycles
+    gb->cpu->registers.pc = 0x101;
+    REQUIRE(gb_step(gb) == 2);
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Skipping the boot ROM starts with the post-boot registers")
+{
+    Gb *gb = gb_create(nullptr);
+
+    REQUIRE(gb->cpu->registers.af == 0x01b0);
+    REQUIRE(gb->cpu->registers.hl == 0x014d);
+    REQUIRE(gb->cpu->registers.pc == 0x0100);
+    REQUIRE(gb->cpu->registers.sp == 0xfffe);
+
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff00) == 0xff);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff02) == 0x7e);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff04) == 0xab);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff07) == 0xf8);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff11) == 0xbf);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff24) == 0x77);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff26) == 0xf1);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff40) == 0x91);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff47) == 0xfc);
+
+    // Unused bits and addresses read as 1, writes to them are lost
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff0f) == 0xe1);
+    const std::array<uint16_t, 8> unused_addresses { 0xff03, 0xff08, 0xff0e, 0xff4c, 0xff4d, 0xff50, 0xff72, 0xff7f };
+    for (const uint16_t address : unused_addresses)
+    {
+        gb_mmu_write_io(gb->mmu, address, 0x00);
+        REQUIRE(gb_mmu_read_io(gb->mmu, address) == 0xff);
+    }
+
+    // The first V-Blank is a line away
+    REQUIRE(gb->ppu->ly == 153);
+    REQUIRE(gb_run_until_vblank(gb) < 2 * 154 * 456);
+
+    gb_destroy(gb);
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "hyper_gb_gb_tests_cgb.gbc";
+    {
+        std::vector<uint8_t> rom(0x8000, 0x00);
+        rom[0x0143] = 0x80;
+        std::ofstream stream(path, std::ios::binary);
+        stream.write(reinterpret_cast<const char *>(rom.data()), static_cast<std::streamsize>(rom.size()));
+    }
+
+    gb = gb_create(path.string().c_str());
+    REQUIRE(gb->cgb);
+    REQUIRE(gb->cpu->registers.af == 0x1180);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff4c) == 0xff);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff4d) == 0x7e);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff6c) == 0xfe);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff70) == 0xf8);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff72) == 0x00);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff74) == 0x00);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff75) == 0x8f);
+
+    gb_mmu_write_io(gb->mmu, 0xff75, 0xff);
+    REQUIRE(gb_mmu_read_io(gb->mmu, 0xff75) == 0xff);
+
+    gb_destroy(gb);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("A boot ROM runs from power on until it unmaps itself")
+{
+    // NOPs up to the end, where it writes 1 to 0xff50 and falls through into the cartridge
+    std::array<uint8_t, GB_BOOT_ROM_DMG_SIZE> boot_rom {};
+    boot_rom[0xfc] = 0x3e;
+    boot_rom[0xfd] = 0x01;
+    boot_rom[0xfe] = 0xe0;
+    boot_rom[0xff] = 0x50;
+
+    REQUIRE(gb_create_with_boot_rom(nullptr, boot_rom.data(), 0x200) == nullptr);
+
+    Gb *gb = gb_create_with_boot_rom(nullptr, boot_rom.data(), boot_rom.size());
+    gb_mmu_write(gb->mmu, 0x0000, 0x12);
+    gb_mmu_write(gb->mmu, 0x0100, 0x18);
+    gb_mmu_write(gb->mmu, 0x0101, 0xfe);
+
+    REQUIRE(gb->cpu->registers.pc == 0x0000);
+    REQUIRE(gb->ppu->lcd_control == 0x00);
+    REQUIRE(gb_mmu_read(gb->mmu, 0x0000) == 0x00);
+
+    gb_run_until_pc(gb, 0x0100, 10'000);
+    REQUIRE(gb->cpu->registers.pc == 0x0100);
+    REQUIRE(gb->cpu->registers.a == 0x01);
+    REQUIRE(gb_mmu_read(gb->mmu, 0x0000) == 0x12);
+
+    gb_destroy(gb);
+}
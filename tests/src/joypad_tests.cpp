@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstdint>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+#include <gb/cpu.h>
+#include <gb/gb.h>
+#include <gb/joypad.h>
+#include <gb/scheduler.h>
+#include <gb/utils/bits.h>
+
+TEST_CASE("Joypad shows the selected group and interrupts on presses")
+{
+    Gb *gb = gb_create(nullptr);
+    GbJoypad *joypad = gb->joypad;
+
+    REQUIRE(gb_joypad_read(joypad) == 0xff);
+
+    // Select the d-pad
+    gb_joypad_write(joypad, 0x20);
+    REQUIRE(gb_set_input(gb, GB_BUTTON_DOWN | GB_BUTTON_A, 100));
+
+    gb_joypad_sync(joypad, 99);
+    REQUIRE(gb_joypad_read(joypad) == 0xef);
+    REQUIRE(gb_scheduler_get_next_deadline(gb->scheduler) <= 100);
+
+    gb_joypad_sync(joypad, 100);
+    REQUIRE(gb_joypad_read(joypad) == 0xe7);
+    REQUIRE(GB_BIT_CHECK(gb->cpu->interrupt_flag, GB_INTERRUPT_JOYPAD));
+
+    // Switching to the buttons brings A low, which interrupts again
+    gb->cpu->interrupt_flag = 0;
+    gb_joypad_write(joypad, 0x10);
+    REQUIRE(gb_joypad_read(joypad) == 0xde);
+    REQUIRE(GB_BIT_CHECK(gb->cpu->interrupt_flag, GB_INTERRUPT_JOYPAD));
+
+    // Releasing doesn't
+    gb->cpu->interrupt_flag = 0;
+    REQUIRE(gb_set_input(gb, 0x00, 200));
+    gb_joypad_sync(joypad, 200);
+    REQUIRE(gb_joypad_read(joypad) == 0xdf);
+    REQUIRE_FALSE(GB_BIT_CHECK(gb->cpu->interrupt_flag, GB_INTERRUPT_JOYPAD));
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Inputs from another thread arrive in order")
+{
+    Gb *gb = gb_create(nullptr);
+    GbJoypad *joypad = gb->joypad;
+    gb_joypad_write(joypad, 0x20);
+
+    constexpr uint64_t INPUT_COUNT = 10000;
+    std::thread producer(
+        [gb]
+        {
+            for (uint64_t i = 1; i <= INPUT_COUNT; ++i)
+            {
+                while (!gb_set_input(gb, static_cast<uint8_t>(i & 0x0f), i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+    // Input `i` is the only one that can be applied at cycle `i`, so the lines show exactly it once it arrived
+    for (uint64_t cycle = 1; cycle <= INPUT_COUNT; ++cycle)
+    {
+        const uint8_t expected = static_cast<uint8_t>(~cycle & 0x0f);
+        do
+        {
+            gb_joypad_sync(joypad, cycle);
+        } while ((gb_joypad_read(joypad) & 0x0f) != expected);
+    }
+
+    producer.join();
+    REQUIRE((gb_joypad_read(joypad) & 0x0f) == static_cast<uint8_t>(~INPUT_COUNT & 0x0f));
+
+    gb_destroy(gb);
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <random>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <catch2/catch_test_macros.hpp>
+#include <gb/cpu.h>
+#include <gb/gb.h>
+#include <gb/link.h>
+#include <gb/serial.h>
+#include <gb/utils/bits.h>
+
+// The first instance sends on its own clock, the second waits for it
+static void start_transfer(Gb *master, Gb *slave)
+{
+    gb_serial_set_sb(master->serial, 0x42);
+    gb_serial_set_sc(master->serial, 0x81);
+    gb_serial_set_sb(slave->serial, 0x99);
+    gb_serial_set_sc(slave->serial, 0x80);
+}
+
+static void require_exchanged(Gb *master, Gb *slave)
+{
+    REQUIRE(master->serial->sb == 0x99);
+    REQUIRE(slave->serial->sb == 0x42);
+    REQUIRE_FALSE(GB_BIT_CHECK(master->serial->sc, 7));
+    REQUIRE_FALSE(GB_BIT_CHECK(slave->serial->sc, 7));
+    REQUIRE(GB_BIT_CHECK(master->cpu->interrupt_flag, GB_INTERRUPT_SERIAL));
+    REQUIRE(GB_BIT_CHECK(slave->cpu->interrupt_flag, GB_INTERRUPT_SERIAL));
+}
+
+TEST_CASE("Local link exchanges bytes when the transfer finishes")
+{
+    Gb *master = gb_create(nullptr);
+    Gb *slave = gb_create(nullptr);
+    GbLink *link = gb_link_create_local(master, slave);
+
+    start_transfer(master, slave);
+    gb_link_run_cycles(link, GB_SERIAL_TRANSFER_CYCLES - 8);
+    REQUIRE(GB_BIT_CHECK(master->serial->sc, 7));
+    REQUIRE(slave->serial->sb == 0x99);
+
+    gb_link_run_cycles(link, 8);
+    require_exchanged(master, slave);
+
+    // Without the cable the transfer times out on its own again
+    gb_link_destroy(link);
+    gb_serial_set_sc(master->serial, 0x81);
+    gb_run_cycles(master, GB_SERIAL_TRANSFER_CYCLES);
+    REQUIRE(master->serial->sb == 0xff);
+
+    gb_destroy(slave);
+    gb_destroy(master);
+}
+
+// Unique per process and removed before and after a test, so parallel runs and leftovers of crashed ones don't collide
+struct SocketPath
+{
+    std::string path { (std::filesystem::temp_directory_path()
+                        / ("hyper_gb_link_tests_" + std::to_string(std::random_device {}()) + ".sock"))
+                           .string() };
+
+    SocketPath() { std::filesystem::remove(path); }
+
+    ~SocketPath()
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+};
+
+// A thread that is still joinable when a REQUIRE throws would terminate the run, so it's detached instead. It only
+// owns state that outlives the test case
+struct PartnerThread
+{
+    std::thread thread;
+
+    ~PartnerThread()
+    {
+        if (thread.joinable())
+        {
+            thread.detach();
+        }
+    }
+};
+
+TEST_CASE("Socket link exchanges bytes at the end of a window")
+{
+    const SocketPath socket;
+    Gb *master = gb_create(nullptr);
+    Gb *slave = gb_create(nullptr);
+    start_transfer(master, slave);
+
+    // Bound before the partner connects, so it never comes too early
+    GbLinkListener *listener = gb_link_listen(socket.path.c_str());
+    REQUIRE(listener);
+
+    std::promise<GbLink *> accepted;
+    std::future<GbLink *> accepted_link = accepted.get_future();
+    PartnerThread partner { std::thread(
+        [listener, master, accepted = std::move(accepted)]() mutable
+        {
+            GbLink *link = gb_link_accept(listener, master, 1024);
+            if (link)
+            {
+                gb_link_run_cycles(link, 2 * GB_SERIAL_TRANSFER_CYCLES);
+            }
+            accepted.set_value(link);
+        }) };
+
+    GbLink *slave_link = gb_link_create_socket(slave, socket.path.c_str(), false, 1024);
+    REQUIRE(slave_link);
+    REQUIRE(gb_link_run_cycles(slave_link, 2 * GB_SERIAL_TRANSFER_CYCLES) == 2 * GB_SERIAL_TRANSFER_CYCLES);
+    partner.thread.join();
+
+    GbLink *master_link = accepted_link.get();
+    REQUIRE(master_link);
+    require_exchanged(master, slave);
+
+    gb_link_destroy(slave_link);
+    gb_link_destroy(master_link);
+    gb_destroy(slave);
+    gb_destroy(master);
+}
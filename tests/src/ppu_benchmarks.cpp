@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <array>
+#include <random>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <gb/definitions.h>
+#include <gb/gb.h>
+#include <gb/ppu.h>
+#include <gb/ppu_compositor.h>
+
+static constexpr std::array<GbPpuCompositor, 3> COMPOSITORS = {
+    GB_PPU_COMPOSITOR_SCALAR,
+    GB_PPU_COMPOSITOR_SSE2,
+    GB_PPU_COMPOSITOR_AVX2,
+};
+
+static constexpr std::array<const char *, 3> COMPOSITOR_NAMES = {
+    "scalar",
+    "sse2",
+    "avx2",
+};
+
+static constexpr std::array<GbPpuRenderer, 3> RENDERERS = {
+    GB_PPU_RENDERER_SCANLINE,
+    GB_PPU_RENDERER_FIFO,
+    GB_PPU_RENDERER_DEFERRED,
+};
+
+static constexpr std::array<const char *, 3> RENDERER_NAMES = {
+    "scanline",
+    "fifo",
+    "deferred",
+};
+
+static void fill_random_vram(GbPpu *ppu)
+{
+    std::mt19937 random(0x5eed);
+    for (uint32_t i = 0; i < 0x2000; ++i)
+    {
+        ppu->vram[i] = static_cast<uint8_t>(random());
+    }
+
+    for (uint16_t i = 0; i < 0xa0; ++i)
+    {
+        gb_ppu_write_oam(ppu, i, static_cast<uint8_t>(random()));
+    }
+}
+
+static void run_scanline(GbPpu *ppu)
+{
+    for (uint32_t dots = 0; dots < 456; dots += 4)
+    {
+        gb_ppu_tick(ppu, 4);
+    }
+}
+
+TEST_CASE("Compositor line benchmark", "[.][benchmark]")
+{
+    std::mt19937 random(7);
+
+    GbPpuLine line {};
+    for (uint32_t x = 0; x < GB_SCREEN_WIDTH; ++x)
+    {
+        line.bg[x] = static_cast<uint8_t>(random() & 0b11);
+        line.obj[x] = static_cast<uint8_t>(random() & 0b1111);
+    }
+
+    std::array<uint16_t, GB_SCREEN_WIDTH> output {};
+    for (size_t i = 0; i < COMPOSITORS.size(); ++i)
+    {
+        if (!gb_ppu_compositor_is_supported(COMPOSITORS[i]))
+        {
+            continue;
+        }
+
+        BENCHMARK(COMPOSITOR_NAMES[i])
+        {
+            gb_ppu_compose_line(COMPOSITORS[i], &line, 0xe4, 0xd2, 0x1b, output.data());
+            return output[0];
+        };
+    }
+}
+
+TEST_CASE("Scanline benchmark", "[.][benchmark]")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_random_vram(ppu);
+    ppu->lcd_control = 0x91;
+    ppu->bgp = 0xe4;
+    ppu->scx = 3;
+
+    // One scanline is 456 dots, so a full frame is 154 of them
+    BENCHMARK("Background")
+    {
+        run_scanline(ppu);
+        return ppu->ly;
+    };
+
+    ppu->lcd_control = 0x93;
+    BENCHMARK("Background and objects")
+    {
+        run_scanline(ppu);
+        return ppu->ly;
+    };
+
+    // The window covers the whole screen, so every line fetches window tiles instead of background tiles
+    ppu->lcd_control = 0xb1;
+    ppu->wy = 0;
+    ppu->wx = 7;
+    BENCHMARK("Window")
+    {
+        run_scanline(ppu);
+        return ppu->ly;
+    };
+
+    ppu->lcd_control = 0xb3;
+    ppu->wy = 72;
+    ppu->wx = 87;
+    BENCHMARK("Background, window and objects")
+    {
+        run_scanline(ppu);
+        return ppu->ly;
+    };
+
+    // Unchanged VRAM turns every background and window line into a copy out of the decoded maps
+    gb_ppu_set_tile_map_cache(ppu, true);
+    BENCHMARK("Background, window and objects (tile map cache)")
+    {
+        run_scanline(ppu);
+        return ppu->ly;
+    };
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Renderer frame benchmark", "[.][benchmark]")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_random_vram(ppu);
+    ppu->lcd_control = 0xb3;
+    ppu->bgp = 0xe4;
+    ppu->obp0 = 0xd2;
+    ppu->scx = 3;
+    ppu->wy = 72;
+    ppu->wx = 87;
+
+    // The same 154 lines for every renderer, so the differences are the cost of the dot-by-dot FIFO emulation and the
+    // time the deferred renderer saves by drawing the lines on several threads
+    for (size_t i = 0; i < RENDERERS.size(); ++i)
+    {
+        gb_ppu_set_renderer(ppu, RENDERERS[i]);
+
+        BENCHMARK(RENDERER_NAMES[i])
+        {
+            for (uint32_t line = 0; line < 154; ++line)
+            {
+                run_scanline(ppu);
+            }
+
+            return ppu->ly;
+        };
+    }
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Render policy frame benchmark", "[.][benchmark]")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_random_vram(ppu);
+    ppu->lcd_control = 0xb3;
+    ppu->bgp = 0xe4;
+    ppu->wy = 72;
+    ppu->wx = 87;
+
+    // Headless runs catch the PPU up once per frame, skipped frames should leave only the mode changes
+    BENCHMARK("always")
+    {
+        gb_ppu_sync(ppu, ppu->cycles + 154 * 456);
+        return ppu->ly;
+    };
+
+    gb_ppu_set_render_policy(ppu, GB_PPU_RENDER_NEVER, 0);
+    BENCHMARK("never")
+    {
+        gb_ppu_sync(ppu, ppu->cycles + 154 * 456);
+        return ppu->ly;
+    };
+
+    gb_destroy(gb);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstdint>
+
+#include <catch2/catch_test_macros.hpp>
+#include <gb/cpu.h>
+#include <gb/definitions.h>
+#include <gb/gb.h>
+#include <gb/mmu.h>
+#include <gb/ppu.h>
+#include <gb/ppu_cgb.h>
+
+static Gb *create_cgb()
+{
+    Gb *gb = gb_create(nullptr);
+    gb_ppu_set_cgb(gb->ppu, true);
+    return gb;
+}
+
+static void write_color(GbPpu *ppu, const uint16_t index_address, const uint8_t index, const uint16_t color)
+{
+    gb_ppu_cgb_write_palette(ppu, index_address, static_cast<uint8_t>(0x80 | index));
+    gb_ppu_cgb_write_palette(ppu, index_address + 1, static_cast<uint8_t>(color & 0xff));
+    gb_ppu_cgb_write_palette(ppu, index_address + 1, static_cast<uint8_t>(color >> 8));
+}
+
+static void tick_until_hblank(GbPpu *ppu)
+{
+    while (ppu->mode == GB_PPU_MODE_HBLANK)
+    {
+        gb_ppu_tick(ppu, 4);
+    }
+
+    while (ppu->mode != GB_PPU_MODE_HBLANK)
+    {
+        gb_ppu_tick(ppu, 4);
+    }
+}
+
+TEST_CASE("CGB palette index increments after data writes")
+{
+    Gb *gb = create_cgb();
+    GbPpu *ppu = gb->ppu;
+
+    gb_ppu_cgb_write_palette(ppu, 0xff68, 0xbe);
+    REQUIRE(gb_ppu_cgb_read_palette(ppu, 0xff68) == 0xfe);
+
+    // The index wraps around within the 64 bytes and keeps the increment bit
+    gb_ppu_cgb_write_palette(ppu, 0xff69, 0x12);
+    gb_ppu_cgb_write_palette(ppu, 0xff69, 0x34);
+    gb_ppu_cgb_write_palette(ppu, 0xff69, 0x56);
+    REQUIRE(ppu->cgb->bg_palettes[0x3e] == 0x12);
+    REQUIRE(ppu->cgb->bg_palettes[0x3f] == 0x34);
+    REQUIRE(ppu->cgb->bg_palettes[0x00] == 0x56);
+    REQUIRE(gb_ppu_cgb_read_palette(ppu, 0xff68) == 0xc1);
+
+    // Without the increment bit every write lands on the same byte
+    gb_ppu_cgb_write_palette(ppu, 0xff6a, 0x05);
+    gb_ppu_cgb_write_palette(ppu, 0xff6b, 0x78);
+    gb_ppu_cgb_write_palette(ppu, 0xff6b, 0x9a);
+    REQUIRE(ppu->cgb->obj_palettes[0x05] == 0x9a);
+    REQUIRE(gb_ppu_cgb_read_palette(ppu, 0xff6b) == 0x9a);
+    REQUIRE(ppu->cgb->bg_palettes[0x05] == 0xff);
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("CGB tile attributes pick the bank, palette and flips")
+{
+    Gb *gb = create_cgb();
+    GbPpu *ppu = gb->ppu;
+
+    // Palette 2 color 1 is red, every other color keeps the white of the boot ROM
+    write_color(ppu, 0xff68, (2 * 4 + 1) * 2, 0x001f);
+
+    // The first tile uses palette 2, bank 1 and both flips, its bank 1 tile only has the leftmost pixel of row 7 set
+    gb_ppu_cgb_set_vram_bank(ppu, 1);
+    gb_ppu_write(ppu, 0x1800, 0b01101010);
+    gb_ppu_write(ppu, 14, 0x80);
+    REQUIRE(ppu->vram[0x1800] == 0x00);
+
+    gb_ppu_set_lcd_control(ppu, 0x91);
+    ppu->ly = 0;
+    gb_ppu_draw_line(ppu);
+
+    for (uint32_t x = 0; x < 16; ++x)
+    {
+        REQUIRE(ppu->screen[x] == (x == 7 ? 0x001f : 0x7fff));
+    }
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("CGB VRAM DMA copies blocks at H-Blank or all at once")
+{
+    Gb *gb = create_cgb();
+    GbPpu *ppu = gb->ppu;
+
+    for (uint16_t i = 0; i < 0x40; ++i)
+    {
+        gb_mmu_write(gb->mmu, static_cast<uint16_t>(0xc000 + i), static_cast<uint8_t>(i + 1));
+    }
+
+    gb_ppu_set_lcd_control(ppu, 0x91);
+    gb_ppu_cgb_write_dma(ppu, 0xff51, 0xc0);
+    gb_ppu_cgb_write_dma(ppu, 0xff52, 0x00);
+    gb_ppu_cgb_write_dma(ppu, 0xff53, 0x80);
+    gb_ppu_cgb_write_dma(ppu, 0xff54, 0x00);
+
+    // Two blocks, one per H-Blank
+    REQUIRE(gb_ppu_cgb_write_dma(ppu, 0xff55, 0x81) == 0);
+    REQUIRE(gb_ppu_cgb_read_dma(ppu, 0xff55) == 0x01);
+    REQUIRE(ppu->vram[0] == 0x00);
+
+    // The CPU stalls for every block as well
+    const uint64_t cpu_cycles = gb->cpu->cycles;
+    tick_until_hblank(ppu);
+    REQUIRE(gb->cpu->cycles == cpu_cycles + GB_PPU_CGB_DMA_BLOCK_CYCLES);
+    REQUIRE(ppu->ly < GB_SCREEN_HEIGHT);
+    REQUIRE(ppu->vram[0] == 0x01);
+    REQUIRE(ppu->vram[15] == 0x10);
+    REQUIRE(ppu->vram[16] == 0x00);
+    REQUIRE(gb_ppu_cgb_read_dma(ppu, 0xff55) == 0x00);
+
+    tick_until_hblank(ppu);
+    REQUIRE(ppu->vram[31] == 0x20);
+    REQUIRE(gb_ppu_cgb_read_dma(ppu, 0xff55) == 0xff);
+
+    // A general purpose DMA continues from where the last one stopped and stalls the CPU for every block
+    REQUIRE(gb_ppu_cgb_write_dma(ppu, 0xff55, 0x01) == 2 * GB_PPU_CGB_DMA_BLOCK_CYCLES);
+    REQUIRE(ppu->vram[32] == 0x21);
+    REQUIRE(ppu->vram[63] == 0x40);
+    REQUIRE(gb_ppu_cgb_read_dma(ppu, 0xff55) == 0xff);
+
+    gb_destroy(gb);
+}
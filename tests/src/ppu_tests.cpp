@@ -0,0 +1,945 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <gb/cpu.h>
+#include <gb/definitions.h>
+#include <gb/gb.h>
+#include <gb/ppu.h>
+#include <gb/ppu_compositor.h>
+#include <gb/ppu_fifo.h>
+#include <gb/utils/bits.h>
+
+static constexpr std::array<GbPpuCompositor, 3> COMPOSITORS = {
+    GB_PPU_COMPOSITOR_SCALAR,
+    GB_PPU_COMPOSITOR_SSE2,
+    GB_PPU_COMPOSITOR_AVX2,
+};
+
+static uint8_t palette_shade(const uint8_t palette, const uint8_t color)
+{
+    return static_cast<uint8_t>((palette >> (color * 2)) & 0b11);
+}
+
+using LineCallback = std::function<void(GbPpu *, uint32_t line)>;
+
+// Renders one frame, `before_line` may change registers before each visible line is drawn
+static void render_frame(GbPpu *ppu, const LineCallback &before_line = {})
+{
+    while (ppu->ly != 0 || ppu->mode != GB_PPU_MODE_OAM_SCAN)
+    {
+        gb_ppu_tick(ppu, 4);
+    }
+
+    for (uint32_t line = 0; line < GB_SCREEN_HEIGHT; ++line)
+    {
+        if (before_line)
+        {
+            before_line(ppu, line);
+        }
+
+        while (ppu->ly == line)
+        {
+            gb_ppu_tick(ppu, 4);
+        }
+    }
+}
+
+static void fill_test_pattern(GbPpu *ppu)
+{
+    std::mt19937 random(0x1234);
+
+    // Tile data for both addressing modes and both tile maps
+    for (uint32_t i = 0; i < 0x2000; ++i)
+    {
+        ppu->vram[i] = static_cast<uint8_t>(random());
+    }
+}
+
+static uint8_t reference_tile_color(const GbPpu *ppu, const uint32_t map, const uint32_t map_x, const uint32_t map_y)
+{
+    const bool unsigned_tiles = (ppu->lcd_control & 0x10) != 0;
+    const uint8_t tile = ppu->vram[map + (map_y / 8) * 32 + map_x / 8];
+    const uint32_t tile_address
+        = unsigned_tiles ? tile * 16u : static_cast<uint32_t>(0x1000 + static_cast<int8_t>(tile) * 16);
+    const uint8_t low = ppu->vram[tile_address + (map_y % 8) * 2];
+    const uint8_t high = ppu->vram[tile_address + (map_y % 8) * 2 + 1];
+    const uint32_t bit = 7 - (map_x % 8);
+    return static_cast<uint8_t>((((high >> bit) & 1) << 1) | ((low >> bit) & 1));
+}
+
+struct ReferenceWindow
+{
+    bool triggered { false };
+    uint32_t line { 0 };
+};
+
+static void reference_line(const GbPpu *ppu, const int32_t y, ReferenceWindow &window, uint8_t *shades)
+{
+    const bool background_enabled = (ppu->lcd_control & 0x01) != 0;
+    const bool objects_enabled = (ppu->lcd_control & 0x02) != 0;
+    const int32_t height = (ppu->lcd_control & 0x04) != 0 ? 16 : 8;
+    const uint32_t background_map = (ppu->lcd_control & 0x08) != 0 ? 0x1c00 : 0x1800;
+    const uint32_t window_map = (ppu->lcd_control & 0x40) != 0 ? 0x1c00 : 0x1800;
+
+    window.triggered = window.triggered || y == ppu->wy;
+    const bool window_visible = (ppu->lcd_control & 0x20) != 0 && window.triggered && ppu->wx <= 166;
+
+    // Full OAM scan with the hardware limit of 10 objects per line
+    std::vector<uint32_t> selected;
+    for (uint32_t object = 0; object < 40 && selected.size() < 10; ++object)
+    {
+        const int32_t top = ppu->oam[object * 4] - 16;
+        if (y >= top && y < top + height)
+        {
+            selected.push_back(object);
+        }
+    }
+
+    for (int32_t x = 0; x < GB_SCREEN_WIDTH; ++x)
+    {
+        uint8_t bg = 0;
+        if (background_enabled && window_visible && x >= ppu->wx - 7)
+        {
+            bg = reference_tile_color(ppu, window_map, static_cast<uint32_t>(x - (ppu->wx - 7)), window.line);
+        }
+        else if (background_enabled)
+        {
+            bg = reference_tile_color(ppu, background_map, (x + ppu->scx) & 0xff, (y + ppu->scy) & 0xff);
+        }
+
+        uint8_t shade = background_enabled ? palette_shade(ppu->bgp, bg) : 0;
+
+        int32_t best_x = 0x7fffffff;
+        for (const uint32_t object : selected)
+        {
+            const uint8_t *entry = &ppu->oam[object * 4];
+            const int32_t left = entry[1] - 8;
+            if (!objects_enabled || x < left || x >= left + 8 || left >= best_x)
+            {
+                continue;
+            }
+
+            int32_t row = y - (entry[0] - 16);
+            if ((entry[3] & 0x40) != 0)
+            {
+                row = height - 1 - row;
+            }
+
+            uint32_t tile = entry[2];
+            if (height == 16)
+            {
+                tile = (tile & 0xfe) + static_cast<uint32_t>(row / 8);
+                row %= 8;
+            }
+
+            const uint32_t bit = (entry[3] & 0x20) != 0 ? static_cast<uint32_t>(x - left)
+                                                         : static_cast<uint32_t>(7 - (x - left));
+            const uint8_t low = ppu->vram[tile * 16 + static_cast<uint32_t>(row) * 2];
+            const uint8_t high = ppu->vram[tile * 16 + static_cast<uint32_t>(row) * 2 + 1];
+            const auto color = static_cast<uint8_t>((((high >> bit) & 1) << 1) | ((low >> bit) & 1));
+            if (color == 0)
+            {
+                continue;
+            }
+
+            best_x = left;
+            const bool behind_bg = (entry[3] & 0x80) != 0 && bg != 0;
+            shade = behind_bg ? palette_shade(ppu->bgp, bg)
+                              : palette_shade((entry[3] & 0x10) != 0 ? ppu->obp1 : ppu->obp0, color);
+        }
+
+        shades[x] = shade;
+    }
+
+    if (window_visible)
+    {
+        window.line += 1;
+    }
+}
+
+static std::vector<uint8_t> reference_frame(GbPpu *ppu, const LineCallback &before_line = {})
+{
+    std::vector<uint8_t> shades(GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT);
+
+    ReferenceWindow window;
+    for (uint32_t y = 0; y < GB_SCREEN_HEIGHT; ++y)
+    {
+        if (before_line)
+        {
+            before_line(ppu, y);
+        }
+
+        reference_line(ppu, static_cast<int32_t>(y), window, &shades[y * GB_SCREEN_WIDTH]);
+    }
+
+    return shades;
+}
+
+static void fill_random_oam(GbPpu *ppu, const uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<uint32_t> crowded_y(16, 55);
+    std::uniform_int_distribution<uint32_t> any_y(0, 175);
+    for (uint16_t object = 0; object < 40; ++object)
+    {
+        // Half of the objects are crowded onto a few lines to hit the per-line limit
+        const uint32_t y = object % 2 == 0 ? crowded_y(random) : any_y(random);
+        gb_ppu_write_oam(ppu, static_cast<uint16_t>(object * 4 + 0), static_cast<uint8_t>(y));
+        gb_ppu_write_oam(ppu, static_cast<uint16_t>(object * 4 + 1), static_cast<uint8_t>(random() % 176));
+        gb_ppu_write_oam(ppu, static_cast<uint16_t>(object * 4 + 2), static_cast<uint8_t>(random()));
+        gb_ppu_write_oam(ppu, static_cast<uint16_t>(object * 4 + 3), static_cast<uint8_t>(random() & 0xf0));
+    }
+}
+
+// Takes the frame that was finished last
+static const uint16_t *take_frame(GbPpu *ppu)
+{
+    std::array<uint64_t, GB_PPU_DIRTY_WORDS> lines {};
+    return gb_ppu_take_frame(ppu, lines.data());
+}
+
+static void require_frame(GbPpu *ppu, const std::vector<uint8_t> &expected)
+{
+    const uint16_t *screen = take_frame(ppu);
+    REQUIRE(screen != nullptr);
+    for (uint32_t i = 0; i < GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT; ++i)
+    {
+        REQUIRE(screen[i] == expected[i]);
+    }
+}
+
+// Checks the scanline renderer with every supported compositor and the other renderers against `expected`
+static void require_every_renderer(GbPpu *ppu, const std::vector<uint8_t> &expected)
+{
+    for (const GbPpuCompositor compositor : COMPOSITORS)
+    {
+        if (!gb_ppu_set_compositor(ppu, compositor))
+        {
+            continue;
+        }
+
+        std::memset(ppu->screen, 0xff, sizeof(uint16_t) * GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT);
+        render_frame(ppu);
+        require_frame(ppu, expected);
+    }
+
+    for (const GbPpuRenderer renderer : { GB_PPU_RENDERER_FIFO, GB_PPU_RENDERER_DEFERRED })
+    {
+        gb_ppu_set_renderer(ppu, renderer);
+        std::memset(ppu->screen, 0xff, sizeof(uint16_t) * GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT);
+        render_frame(ppu);
+        require_frame(ppu, expected);
+    }
+    gb_ppu_set_renderer(ppu, GB_PPU_RENDERER_SCANLINE);
+
+    // The cache is created fresh, as the tests fill VRAM without going through gb_ppu_write
+    gb_ppu_set_tile_map_cache(ppu, true);
+    std::memset(ppu->screen, 0xff, sizeof(uint16_t) * GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT);
+    render_frame(ppu);
+    require_frame(ppu, expected);
+    gb_ppu_set_tile_map_cache(ppu, false);
+}
+
+TEST_CASE("Compositor applies palettes and object priority")
+{
+    GbPpuLine line {};
+    line.bg[0] = 0;
+    line.obj[0] = 0; // Transparent object, BG color 0
+    line.bg[1] = 2;
+    line.obj[1] = 0; // Transparent object, BG color 2
+    line.bg[2] = 2;
+    line.obj[2] = 1; // Object over BG with OBP0
+    line.bg[3] = 2;
+    line.obj[3] = 3 | GB_OBJ_PIXEL_PALETTE; // Object over BG with OBP1
+    line.bg[4] = 1;
+    line.obj[4] = 3 | GB_OBJ_PIXEL_BG_PRIORITY; // BG colors 1-3 hide the object
+    line.bg[5] = 0;
+    line.obj[5] = 2 | GB_OBJ_PIXEL_BG_PRIORITY; // BG color 0 never hides the object
+
+    const uint8_t bgp = 0b00'01'10'11;
+    const uint8_t obp0 = 0b10'01'11'00;
+    const uint8_t obp1 = 0b01'11'10'00;
+
+    for (const GbPpuCompositor compositor : COMPOSITORS)
+    {
+        if (!gb_ppu_compositor_is_supported(compositor))
+        {
+            continue;
+        }
+
+        std::array<uint16_t, GB_SCREEN_WIDTH> output {};
+        gb_ppu_compose_line(compositor, &line, bgp, obp0, obp1, output.data());
+
+        REQUIRE(output[0] == palette_shade(bgp, 0));
+        REQUIRE(output[1] == palette_shade(bgp, 2));
+        REQUIRE(output[2] == palette_shade(obp0, 1));
+        REQUIRE(output[3] == palette_shade(obp1, 3));
+        REQUIRE(output[4] == palette_shade(bgp, 1));
+        REQUIRE(output[5] == palette_shade(obp0, 2));
+    }
+}
+
+TEST_CASE("SIMD compositors match the scalar compositor")
+{
+    std::mt19937 random(42);
+
+    for (uint32_t iteration = 0; iteration < 256; ++iteration)
+    {
+        GbPpuLine line {};
+        for (uint32_t x = 0; x < GB_SCREEN_WIDTH; ++x)
+        {
+            line.bg[x] = static_cast<uint8_t>(random() & 0b11);
+            line.obj[x] = static_cast<uint8_t>(random() & 0b1111);
+        }
+
+        const auto bgp = static_cast<uint8_t>(random());
+        const auto obp0 = static_cast<uint8_t>(random());
+        const auto obp1 = static_cast<uint8_t>(random());
+
+        std::array<uint16_t, GB_SCREEN_WIDTH> expected {};
+        gb_ppu_compose_line(GB_PPU_COMPOSITOR_SCALAR, &line, bgp, obp0, obp1, expected.data());
+
+        for (const GbPpuCompositor compositor : COMPOSITORS)
+        {
+            if (!gb_ppu_compositor_is_supported(compositor))
+            {
+                continue;
+            }
+
+            std::array<uint16_t, GB_SCREEN_WIDTH> output {};
+            gb_ppu_compose_line(compositor, &line, bgp, obp0, obp1, output.data());
+            REQUIRE(output == expected);
+        }
+    }
+}
+
+TEST_CASE("Background golden frame matches for every renderer")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_test_pattern(ppu);
+    ppu->scx = 13;
+    ppu->scy = 250;
+    ppu->bgp = 0b00'01'10'11;
+
+    for (const uint8_t lcd_control : std::array<uint8_t, 4> { 0x91, 0x81, 0x99, 0x80 })
+    {
+        ppu->lcd_control = lcd_control;
+
+        const std::vector<uint8_t> expected = reference_frame(ppu);
+        require_every_renderer(ppu, expected);
+    }
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Object golden frames match a full OAM scan")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_test_pattern(ppu);
+    ppu->scx = 100;
+    ppu->scy = 7;
+    ppu->bgp = 0b11'10'01'00;
+    ppu->obp0 = 0b00'01'10'11;
+    ppu->obp1 = 0b01'10'11'00;
+
+    // 8x8 and 8x16 objects, with the background on and off
+    for (const uint8_t lcd_control : std::array<uint8_t, 4> { 0x93, 0x97, 0x92, 0x96 })
+    {
+        ppu->lcd_control = lcd_control;
+
+        for (uint32_t seed = 0; seed < 4; ++seed)
+        {
+            fill_random_oam(ppu, seed);
+            const std::vector<uint8_t> expected = reference_frame(ppu);
+            require_every_renderer(ppu, expected);
+        }
+    }
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Object cache follows OAM writes")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_test_pattern(ppu);
+    ppu->lcd_control = 0x93;
+    ppu->bgp = 0xe4;
+    ppu->obp0 = 0x1b;
+
+    fill_random_oam(ppu, 99);
+    render_frame(ppu);
+    require_frame(ppu, reference_frame(ppu));
+
+    // Moving a single object has to show up in the next frame
+    gb_ppu_write_oam(ppu, 0, 40);
+    gb_ppu_write_oam(ppu, 1, 40);
+    render_frame(ppu);
+    require_frame(ppu, reference_frame(ppu));
+
+    // Switching to 8x16 objects changes the buckets without any OAM write
+    ppu->lcd_control = 0x97;
+    render_frame(ppu);
+    require_frame(ppu, reference_frame(ppu));
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Tile map cache follows VRAM writes")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_test_pattern(ppu);
+    ppu->lcd_control = 0xf1;
+    ppu->bgp = 0xe4;
+    ppu->scx = 250;
+    ppu->scy = 3;
+    ppu->wy = 80;
+    ppu->wx = 47;
+
+    gb_ppu_set_tile_map_cache(ppu, true);
+    render_frame(ppu);
+    require_frame(ppu, reference_frame(ppu));
+
+    // A map entry in each map and a row of tile data shared by many cells
+    gb_ppu_write(ppu, 0x1800 + 5, 0x20);
+    gb_ppu_write(ppu, 0x1c00 + 33, 0x81);
+    gb_ppu_write(ppu, 0x0020 + 6, 0x5a);
+    render_frame(ppu);
+    require_frame(ppu, reference_frame(ppu));
+
+    // Signed addressing maps the same entries to different tiles without any VRAM write
+    ppu->lcd_control = 0xe1;
+    render_frame(ppu);
+    require_frame(ppu, reference_frame(ppu));
+
+    gb_ppu_write(ppu, 0x1000 + 3, 0xc3);
+    render_frame(ppu);
+    require_frame(ppu, reference_frame(ppu));
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Window golden frames cover the WX and WY edge cases")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_test_pattern(ppu);
+    fill_random_oam(ppu, 7);
+    ppu->scx = 37;
+    ppu->scy = 91;
+    ppu->bgp = 0b00'01'10'11;
+    ppu->obp0 = 0b11'10'01'00;
+    ppu->obp1 = 0b10'11'00'01;
+
+    const std::array<std::pair<uint8_t, uint8_t>, 9> positions = { {
+        { 0, 7 }, // Covers the whole screen
+        { 60, 87 }, // Bottom right quarter
+        { 0, 0 }, // Left edge scrolled off screen
+        { 10, 3 },
+        { 0, 166 }, // A single column
+        { 0, 167 }, // Hidden
+        { 143, 7 }, // Only the last line
+        { 144, 7 }, // Hidden
+        { 255, 7 },
+    } };
+
+    for (const uint8_t lcd_control : std::array<uint8_t, 5> { 0xf1, 0xb3, 0xe7, 0xd1, 0xf0 })
+    {
+        ppu->lcd_control = lcd_control;
+
+        for (const auto &[wy, wx] : positions)
+        {
+            ppu->wy = wy;
+            ppu->wx = wx;
+
+            const std::vector<uint8_t> expected = reference_frame(ppu);
+            require_every_renderer(ppu, expected);
+        }
+    }
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Window line counter only advances on lines showing the window")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_test_pattern(ppu);
+    ppu->bgp = 0xe4;
+    ppu->wy = 20;
+    ppu->wx = 50;
+
+    // The window is switched off for a few lines and moved off screen for a few others
+    const LineCallback before_line = [](GbPpu *target, const uint32_t line) {
+        target->lcd_control = (line >= 40 && line < 70) ? 0x91 : 0xf1;
+        target->wx = (line >= 100 && line < 110) ? 200 : 50;
+        target->wy = line >= 30 ? 200 : 20;
+    };
+
+    const std::vector<uint8_t> expected = reference_frame(ppu, before_line);
+
+    uint32_t window_line = 0;
+    render_frame(ppu, [&](GbPpu *target, const uint32_t line) {
+        before_line(target, line);
+        window_line = target->window_line;
+    });
+    require_frame(ppu, expected);
+
+    // Lines 20-39 and 70-142 showed the window, except for the 10 lines it was moved off screen
+    REQUIRE(window_line == (40 - 20) + (143 - 70) - 10);
+
+    gb_destroy(gb);
+}
+
+// Ticks dot by dot to the start of `line` and returns the length of its mode 3
+static uint32_t measure_drawing_dots(GbPpu *ppu, const uint8_t line)
+{
+    while (ppu->ly != line || ppu->mode != GB_PPU_MODE_OAM_SCAN)
+    {
+        gb_ppu_tick(ppu, 1);
+    }
+
+    while (ppu->mode != GB_PPU_MODE_DRAWING)
+    {
+        gb_ppu_tick(ppu, 1);
+    }
+
+    uint32_t dots = 0;
+    while (ppu->mode == GB_PPU_MODE_DRAWING)
+    {
+        REQUIRE((ppu->lcd_status & 0b11) == 3);
+        gb_ppu_tick(ppu, 1);
+        dots += 1;
+    }
+
+    REQUIRE((ppu->lcd_status & 0b11) == 0);
+    return dots;
+}
+
+TEST_CASE("FIFO renderer stretches mode 3 like the hardware")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_test_pattern(ppu);
+    gb_ppu_set_renderer(ppu, GB_PPU_RENDERER_FIFO);
+    ppu->lcd_control = 0x91;
+
+    // A frame is always 154 lines of 456 dots
+    uint32_t frame_dots = measure_drawing_dots(ppu, 0);
+    while (ppu->ly != 0 || ppu->mode != GB_PPU_MODE_DRAWING)
+    {
+        gb_ppu_tick(ppu, 1);
+        frame_dots += 1;
+    }
+    REQUIRE(frame_dots == 154 * 456);
+
+    REQUIRE(measure_drawing_dots(ppu, 10) == 172);
+
+    // Pixels scrolled out by SCX are fetched and thrown away one dot each
+    ppu->scx = 5;
+    REQUIRE(measure_drawing_dots(ppu, 20) == 177);
+    ppu->scx = 0;
+
+    // Restarting the fetcher for the window costs another 6 dots
+    ppu->lcd_control = 0xb1;
+    ppu->wy = 0;
+    ppu->wx = 87;
+    REQUIRE(measure_drawing_dots(ppu, 30) == 178);
+
+    // Every object costs 6 dots plus the wait for the background fetcher
+    ppu->lcd_control = 0x93;
+    for (uint16_t object = 0; object < 40; ++object)
+    {
+        gb_ppu_write_oam(ppu, static_cast<uint16_t>(object * 4), 0);
+    }
+    gb_ppu_write_oam(ppu, 0, 16 + 40);
+    gb_ppu_write_oam(ppu, 1, 8 + 50);
+    gb_ppu_write_oam(ppu, 4, 16 + 40);
+    gb_ppu_write_oam(ppu, 5, 8 + 99);
+
+    const uint32_t dots = measure_drawing_dots(ppu, 40);
+    REQUIRE(dots >= 172 + 2 * 6);
+    REQUIRE(dots <= 172 + 2 * 11);
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("FIFO renderer shows mid-line palette writes")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_test_pattern(ppu);
+    gb_ppu_set_renderer(ppu, GB_PPU_RENDERER_FIFO);
+    ppu->lcd_control = 0x91;
+    ppu->scx = 3;
+
+    ppu->bgp = 0b11'10'01'00;
+    const std::vector<uint8_t> before = reference_frame(ppu);
+    ppu->bgp = 0b00'01'10'11;
+    const std::vector<uint8_t> after = reference_frame(ppu);
+
+    // BGP is switched halfway through every line
+    std::vector<uint8_t> split_x(GB_SCREEN_HEIGHT);
+    render_frame(ppu, [&](GbPpu *target, const uint32_t line) {
+        target->bgp = 0b11'10'01'00;
+        while (target->fifo->lcd_x < 80 || target->mode != GB_PPU_MODE_DRAWING)
+        {
+            gb_ppu_tick(target, 1);
+        }
+
+        split_x[line] = target->fifo->lcd_x;
+        target->bgp = 0b00'01'10'11;
+    });
+
+    const uint16_t *screen = take_frame(ppu);
+    for (uint32_t y = 0; y < GB_SCREEN_HEIGHT; ++y)
+    {
+        for (uint32_t x = 0; x < GB_SCREEN_WIDTH; ++x)
+        {
+            const uint32_t i = y * GB_SCREEN_WIDTH + x;
+            REQUIRE(screen[i] == (x < split_x[y] ? before[i] : after[i]));
+        }
+    }
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Deferred renderer replays mid-frame writes")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_test_pattern(ppu);
+    fill_random_oam(ppu, 5);
+    ppu->lcd_control = 0xf3;
+    ppu->bgp = 0xe4;
+    ppu->obp0 = 0xd2;
+    ppu->obp1 = 0x1b;
+    ppu->wy = 60;
+    ppu->wx = 80;
+
+    // Registers, tile data, map entries and objects all change while the frame is drawn
+    const LineCallback before_line = [](GbPpu *current, const uint32_t line)
+    {
+        current->scx = static_cast<uint8_t>(line * 3);
+        current->scy = static_cast<uint8_t>(line / 2);
+        current->bgp = static_cast<uint8_t>(0xe4 ^ line);
+        gb_ppu_write(current, static_cast<uint16_t>((line * 37) % 0x1800), static_cast<uint8_t>(line * 11));
+        gb_ppu_write(current, static_cast<uint16_t>(0x1800 + line * 5), static_cast<uint8_t>(line));
+        gb_ppu_write_oam(current, static_cast<uint16_t>((line % 40) * 4 + 1), static_cast<uint8_t>(line));
+
+        if (line == 90)
+        {
+            current->lcd_control = 0xe7;
+        }
+    };
+
+    // Both renderers start from the same memory, the writes repeat identically every frame
+    std::vector<uint8_t> vram(ppu->vram, ppu->vram + 0x2000);
+    std::vector<uint8_t> oam(ppu->oam, ppu->oam + 0xa0);
+
+    render_frame(ppu, before_line);
+    const uint16_t *scanline_screen = take_frame(ppu);
+    const std::vector<uint16_t> expected(scanline_screen, scanline_screen + GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT);
+
+    gb_ppu_set_renderer(ppu, GB_PPU_RENDERER_DEFERRED);
+    std::memcpy(ppu->vram, vram.data(), vram.size());
+    for (uint16_t i = 0; i < 0xa0; ++i)
+    {
+        gb_ppu_write_oam(ppu, i, oam[i]);
+    }
+    ppu->lcd_control = 0xf3;
+    std::memset(ppu->screen, 0xff, sizeof(uint16_t) * GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT);
+
+    render_frame(ppu, before_line);
+    const uint16_t *screen = take_frame(ppu);
+    for (uint32_t i = 0; i < GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT; ++i)
+    {
+        REQUIRE(screen[i] == expected[i]);
+    }
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Catch-up sync matches ticking every instruction")
+{
+    Gb *stepped = gb_create(nullptr);
+    Gb *synced = gb_create(nullptr);
+
+    for (Gb *gb : { stepped, synced })
+    {
+        fill_test_pattern(gb->ppu);
+        fill_random_oam(gb->ppu, 3);
+        gb->ppu->lcd_control = 0xf3;
+        gb->ppu->bgp = 0xe4;
+        gb->ppu->obp0 = 0x1b;
+        gb->ppu->wy = 30;
+        gb->ppu->wx = 50;
+    }
+
+    // A little over two frames, synced in uneven chunks
+    const uint64_t end = 2 * 154 * 456 + 1232;
+    while (stepped->ppu->cycles < end)
+    {
+        gb_ppu_tick(stepped->ppu, 4);
+    }
+
+    for (uint64_t cycles = 0; cycles < end; cycles += 9999)
+    {
+        gb_ppu_sync(synced->ppu, cycles);
+    }
+    gb_ppu_sync(synced->ppu, end);
+
+    REQUIRE(synced->ppu->ly == stepped->ppu->ly);
+    REQUIRE(synced->ppu->mode == stepped->ppu->mode);
+    REQUIRE(synced->ppu->dots_counter == stepped->ppu->dots_counter);
+    REQUIRE(synced->ppu->lcd_status == stepped->ppu->lcd_status);
+    REQUIRE(synced->cpu->interrupt_flag == stepped->cpu->interrupt_flag);
+    const size_t screen_size = sizeof(uint16_t) * GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT;
+    REQUIRE(std::memcmp(take_frame(synced->ppu), take_frame(stepped->ppu), screen_size) == 0);
+
+    gb_destroy(synced);
+    gb_destroy(stepped);
+}
+
+TEST_CASE("Next interrupt deadline lands on V-Blank and enabled STAT sources")
+{
+    for (const GbPpuRenderer renderer : { GB_PPU_RENDERER_SCANLINE, GB_PPU_RENDERER_FIFO })
+    {
+        Gb *gb = gb_create(nullptr);
+        GbPpu *ppu = gb->ppu;
+        gb_ppu_set_renderer(ppu, renderer);
+
+        // Without STAT sources the PPU only has to run again for V-Blank
+        gb_ppu_sync(ppu, 1);
+        gb_ppu_sync(ppu, ppu->next_interrupt);
+        REQUIRE(ppu->ly == GB_SCREEN_HEIGHT);
+        REQUIRE(GB_BIT_CHECK(gb->cpu->interrupt_flag, 0));
+        REQUIRE((ppu->lcd_status & 0b11) == 1);
+
+        // The LYC interrupt fires once the deadlines reach line 50
+        gb->cpu->interrupt_flag = 0;
+        gb_ppu_set_lyc(ppu, 50);
+        gb_ppu_set_lcd_status(ppu, 0b0100'0000);
+        while (!GB_BIT_CHECK(gb->cpu->interrupt_flag, 1))
+        {
+            REQUIRE(ppu->next_interrupt > ppu->cycles);
+            gb_ppu_sync(ppu, ppu->next_interrupt);
+        }
+        REQUIRE(ppu->ly == 50);
+        REQUIRE(GB_BIT_CHECK(ppu->lcd_status, 2));
+
+        gb_destroy(gb);
+    }
+}
+
+TEST_CASE("Disabled LCD holds LY at 0 and restarts the frame")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    // The boot ROM leaves V-Blank pending
+    gb->cpu->interrupt_flag = 0;
+    gb_ppu_set_lcd_control(ppu, 0x91);
+    while (ppu->ly != 70)
+    {
+        gb_ppu_tick(ppu, 4);
+    }
+
+    gb_ppu_set_lcd_control(ppu, 0x11);
+    REQUIRE(ppu->ly == 0);
+    REQUIRE((ppu->lcd_status & 0b11) == 0);
+    REQUIRE(ppu->next_interrupt == UINT64_MAX);
+
+    gb_ppu_sync(ppu, ppu->cycles + 1'000'000);
+    REQUIRE(ppu->ly == 0);
+    REQUIRE(gb->cpu->interrupt_flag == 0);
+
+    gb_ppu_set_lcd_control(ppu, 0x91);
+    REQUIRE(ppu->mode == GB_PPU_MODE_OAM_SCAN);
+    gb_ppu_tick(ppu, 80);
+    REQUIRE(ppu->mode == GB_PPU_MODE_DRAWING);
+    REQUIRE(ppu->ly == 0);
+
+    gb_destroy(gb);
+}
+
+// Runs a frame and reports whether it was drawn and handed over
+static bool render_marked_frame(GbPpu *ppu)
+{
+    render_frame(ppu);
+    return take_frame(ppu) != nullptr;
+}
+
+TEST_CASE("Render policy skips pixel work but keeps timing")
+{
+    for (const GbPpuRenderer renderer : { GB_PPU_RENDERER_SCANLINE, GB_PPU_RENDERER_FIFO })
+    {
+        Gb *drawn = gb_create(nullptr);
+        Gb *skipped = gb_create(nullptr);
+
+        for (Gb *gb : { drawn, skipped })
+        {
+            gb_ppu_set_renderer(gb->ppu, renderer);
+            fill_test_pattern(gb->ppu);
+            gb->ppu->lcd_control = 0xf3;
+            gb->ppu->wy = 30;
+            gb->ppu->wx = 50;
+            gb_ppu_set_lyc(gb->ppu, 77);
+            gb_ppu_set_lcd_status(gb->ppu, 0b0110'1000);
+        }
+
+        gb_ppu_set_render_policy(skipped->ppu, GB_PPU_RENDER_NEVER, 0);
+
+        // Every interrupt, mode and window line has to happen at the same dot
+        for (uint32_t dot = 0; dot < 3 * 154 * 456; ++dot)
+        {
+            gb_ppu_tick(drawn->ppu, 1);
+            gb_ppu_tick(skipped->ppu, 1);
+
+            REQUIRE(skipped->ppu->ly == drawn->ppu->ly);
+            REQUIRE(skipped->ppu->lcd_status == drawn->ppu->lcd_status);
+            REQUIRE(skipped->ppu->window_line == drawn->ppu->window_line);
+            REQUIRE(skipped->cpu->interrupt_flag == drawn->cpu->interrupt_flag);
+        }
+
+        REQUIRE(take_frame(drawn->ppu) != nullptr);
+        REQUIRE(take_frame(skipped->ppu) == nullptr);
+
+        gb_destroy(skipped);
+        gb_destroy(drawn);
+    }
+}
+
+TEST_CASE("Render policy picks the drawn frames")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    fill_test_pattern(ppu);
+    render_frame(ppu);
+
+    gb_ppu_set_render_policy(ppu, GB_PPU_RENDER_EVERY_NTH, 3);
+    std::vector<bool> drawn;
+    for (uint32_t frame = 0; frame < 7; ++frame)
+    {
+        drawn.push_back(render_marked_frame(ppu));
+    }
+    REQUIRE(drawn == std::vector<bool> { true, false, false, true, false, false, true });
+
+    // A request draws the next frame only
+    gb_ppu_set_render_policy(ppu, GB_PPU_RENDER_ON_REQUEST, 0);
+    REQUIRE_FALSE(render_marked_frame(ppu));
+    gb_ppu_request_frame(ppu);
+    REQUIRE(render_marked_frame(ppu));
+    REQUIRE_FALSE(render_marked_frame(ppu));
+
+    gb_ppu_set_render_policy(ppu, GB_PPU_RENDER_ALWAYS, 0);
+    REQUIRE(render_marked_frame(ppu));
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Taken frames stay untouched while the next ones are drawn")
+{
+    Gb *gb = gb_create(nullptr);
+    GbPpu *ppu = gb->ppu;
+
+    uint32_t finished_frames = 0;
+    gb_set_frame_callback(
+        gb, [](void *user_data) { *static_cast<uint32_t *>(user_data) += 1; }, &finished_frames);
+
+    fill_test_pattern(ppu);
+    ppu->bgp = 0xe4;
+    render_frame(ppu);
+    REQUIRE(finished_frames == 1);
+
+    const uint16_t *front = take_frame(ppu);
+    REQUIRE(front != nullptr);
+    REQUIRE(take_frame(ppu) == nullptr);
+    const std::vector<uint16_t> shown(front, front + GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT);
+
+    // Neither the frame in progress nor finished frames that were not taken touch the front buffer
+    ppu->bgp = 0x1b;
+    render_frame(ppu);
+    render_frame(ppu);
+    while (ppu->ly != 70)
+    {
+        gb_ppu_tick(ppu, 4);
+    }
+    REQUIRE(finished_frames == 3);
+    REQUIRE(std::memcmp(front, shown.data(), sizeof(uint16_t) * shown.size()) == 0);
+
+    const uint16_t *next = take_frame(ppu);
+    REQUIRE(next != front);
+    REQUIRE(next != ppu->screen);
+    REQUIRE(std::memcmp(next, shown.data(), sizeof(uint16_t) * shown.size()) != 0);
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Dirty lines only cover changed pixels")
+{
+    for (const GbPpuRenderer renderer : { GB_PPU_RENDERER_SCANLINE, GB_PPU_RENDERER_FIFO })
+    {
+        Gb *gb = gb_create(nullptr);
+        GbPpu *ppu = gb->ppu;
+
+        gb_ppu_set_renderer(ppu, renderer);
+        fill_test_pattern(ppu);
+        ppu->bgp = 0xe4;
+
+        // Everything is dirty at first, a repeated frame changes nothing
+        std::array<uint64_t, GB_PPU_DIRTY_WORDS> lines {};
+        REQUIRE(gb_ppu_take_frame(ppu, lines.data()) == nullptr);
+        render_frame(ppu);
+        REQUIRE(gb_ppu_take_frame(ppu, lines.data()) != nullptr);
+        REQUIRE(GB_BIT_CHECK(lines[143 / 64], 143 % 64));
+        render_frame(ppu);
+        REQUIRE(gb_ppu_take_frame(ppu, lines.data()) != nullptr);
+        REQUIRE(lines == std::array<uint64_t, GB_PPU_DIRTY_WORDS> {});
+
+        // A palette change on lines 60-69 only dirties them
+        const LineCallback before_line = [](GbPpu *target, const uint32_t line) {
+            target->bgp = (line >= 60 && line < 70) ? 0x1b : 0xe4;
+        };
+        render_frame(ppu, before_line);
+        REQUIRE(gb_ppu_take_frame(ppu, lines.data()) != nullptr);
+        for (uint32_t line = 0; line < GB_SCREEN_HEIGHT; ++line)
+        {
+            REQUIRE(GB_BIT_CHECK(lines[line / 64], line % 64) == (line >= 60 && line < 70));
+        }
+
+        // Lines stay dirty until a frame is taken, even over several frames
+        ppu->bgp = 0xe4;
+        render_frame(ppu);
+        render_frame(ppu);
+        REQUIRE(gb_ppu_take_frame(ppu, lines.data()) != nullptr);
+        REQUIRE(GB_BIT_CHECK(lines[65 / 64], 65 % 64));
+        REQUIRE_FALSE(GB_BIT_CHECK(lines[10 / 64], 10 % 64));
+
+        gb_destroy(gb);
+    }
+}
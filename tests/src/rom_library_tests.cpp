@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <gb/rom_library.h>
+
+static void write_rom(const std::filesystem::path &path, const uint8_t type, const size_t size)
+{
+    std::vector<uint8_t> rom(size, 0x00);
+    if (size >= 0x0150)
+    {
+        rom[0x0134] = 'A';
+        rom[0x0147] = type;
+    }
+
+    std::ofstream stream(path, std::ios::binary);
+    stream.write(reinterpret_cast<const char *>(rom.data()), static_cast<std::streamsize>(rom.size()));
+}
+
+TEST_CASE("ROM library reads headers once and reuses the index")
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "hyper_gb_rom_library_tests";
+    const std::filesystem::path index = std::filesystem::temp_directory_path() / "hyper_gb_rom_library_tests.index";
+    std::filesystem::remove_all(directory);
+    std::filesystem::remove(index);
+    std::filesystem::create_directories(directory / "nested");
+
+    write_rom(directory / "a.gb", 0x01, 0x8000);
+    write_rom(directory / "nested" / "b.GBC", 0x19, 0x8000);
+    write_rom(directory / "truncated.gb", 0x00, 0x0100);
+    write_rom(directory / "notes.txt", 0x00, 0x8000);
+
+    GbRomLibrary *library = gb_rom_library_create(directory.string().c_str(), index.string().c_str(), 4);
+    REQUIRE(library->count == 3);
+    REQUIRE(library->scanned_count == 3);
+
+    const GbRomLibraryEntry &first = library->entries[0];
+    REQUIRE(std::string(first.path).ends_with("a.gb"));
+    REQUIRE(std::string(first.header.title) == "A");
+    REQUIRE(first.header.mapper == GB_MAPPER_MBC1);
+    REQUIRE(first.status == GB_CARTRIDGE_HEADER_VALID);
+    REQUIRE(library->entries[1].header.mapper == GB_MAPPER_MBC5);
+    REQUIRE(library->entries[2].status == GB_CARTRIDGE_HEADER_TRUNCATED);
+    gb_rom_library_destroy(library);
+
+    // Nothing changed, so no ROM is opened again
+    library = gb_rom_library_create(directory.string().c_str(), index.string().c_str(), 4);
+    REQUIRE(library->count == 3);
+    REQUIRE(library->scanned_count == 0);
+    REQUIRE(library->entries[0].header.mapper == GB_MAPPER_MBC1);
+    gb_rom_library_destroy(library);
+
+    write_rom(directory / "a.gb", 0x1b, 0x10000);
+    library = gb_rom_library_create(directory.string().c_str(), index.string().c_str(), 4);
+    REQUIRE(library->scanned_count == 1);
+    REQUIRE(library->entries[0].header.mapper == GB_MAPPER_MBC5);
+    gb_rom_library_destroy(library);
+
+    std::filesystem::remove_all(directory);
+    std::filesystem::remove(index);
+}
+
+TEST_CASE("ROM library survives linked directories and corrupt indices")
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "hyper_gb_rom_library_links";
+    const std::filesystem::path index = std::filesystem::temp_directory_path() / "hyper_gb_rom_library_links.index";
+    std::filesystem::remove_all(directory);
+    std::filesystem::remove(index);
+    std::filesystem::create_directories(directory / "nested");
+
+    // The link leads back up the tree and would be walked forever if followed
+    write_rom(directory / "nested" / "a.gb", 0x01, 0x8000);
+    std::filesystem::create_directory_symlink(directory, directory / "nested" / "loop");
+
+    GbRomLibrary *library = gb_rom_library_create(directory.string().c_str(), index.string().c_str(), 1);
+    REQUIRE(library->count == 1);
+    gb_rom_library_destroy(library);
+
+    // An index with an impossible path length is ignored and rewritten
+    {
+        std::ofstream stream(index, std::ios::binary);
+        const uint32_t header[] = { 0x58494247, 1, 1, 0, 0xffffffff };
+        stream.write(reinterpret_cast<const char *>(header), sizeof(header));
+    }
+
+    library = gb_rom_library_create(directory.string().c_str(), index.string().c_str(), 1);
+    REQUIRE(library->count == 1);
+    REQUIRE(library->scanned_count == 1);
+    REQUIRE(library->entries[0].header.mapper == GB_MAPPER_MBC1);
+    gb_rom_library_destroy(library);
+
+    std::filesystem::remove_all(directory);
+    std::filesystem::remove(index);
+}
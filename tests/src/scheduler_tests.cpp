@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstdint>
+
+#include <catch2/catch_test_macros.hpp>
+#include <gb/cpu.h>
+#include <gb/gb.h>
+#include <gb/ppu.h>
+#include <gb/scheduler.h>
+#include <gb/timer.h>
+
+TEST_CASE("Scheduler pops events in deadline order")
+{
+    GbScheduler *scheduler = gb_scheduler_create();
+    REQUIRE(gb_scheduler_get_next_deadline(scheduler) == UINT64_MAX);
+
+    gb_scheduler_schedule(scheduler, GB_EVENT_RUN_END, 300);
+    gb_scheduler_schedule(scheduler, GB_EVENT_PPU, 100);
+    gb_scheduler_schedule(scheduler, GB_EVENT_TIMER, 200);
+    REQUIRE(gb_scheduler_get_next_deadline(scheduler) == 100);
+
+    // Rescheduling moves the event instead of adding it twice
+    gb_scheduler_schedule(scheduler, GB_EVENT_PPU, 400);
+    REQUIRE(gb_scheduler_get_next_deadline(scheduler) == 200);
+
+    GbEvent event {};
+    REQUIRE_FALSE(gb_scheduler_pop(scheduler, 199, &event));
+    REQUIRE(gb_scheduler_pop(scheduler, 1000, &event));
+    REQUIRE(event == GB_EVENT_TIMER);
+
+    gb_scheduler_cancel(scheduler, GB_EVENT_RUN_END);
+    gb_scheduler_schedule(scheduler, GB_EVENT_TIMER, UINT64_MAX);
+    REQUIRE(gb_scheduler_pop(scheduler, 1000, &event));
+    REQUIRE(event == GB_EVENT_PPU);
+    REQUIRE_FALSE(gb_scheduler_pop(scheduler, UINT64_MAX - 1, &event));
+
+    gb_scheduler_destroy(scheduler);
+}
+
+TEST_CASE("Components reschedule their events when registers change")
+{
+    Gb *gb = gb_create(nullptr);
+
+    gb_ppu_set_lcd_control(gb->ppu, 0x11);
+    gb_timer_reset_div(gb->timer);
+    gb_timer_set_tac(gb->timer, 0b101);
+    gb_timer_set_tima(gb->timer, 0xff);
+    REQUIRE(gb_scheduler_get_next_deadline(gb->scheduler) == 16);
+
+    gb_timer_set_tac(gb->timer, 0b001);
+    REQUIRE(gb_scheduler_get_next_deadline(gb->scheduler) == UINT64_MAX);
+
+    // The LCD starts over on line 0, with V-Blank as the only interrupt 144 lines later
+    gb_ppu_set_lcd_control(gb->ppu, 0x91);
+    REQUIRE(gb_scheduler_get_next_deadline(gb->scheduler) == 144 * 456);
+
+    gb_destroy(gb);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include <catch2/catch_test_macros.hpp>
+#include <gb/cpu.h>
+#include <gb/gb.h>
+#include <gb/serial.h>
+#include <gb/utils/bits.h>
+
+static void send(Gb *gb, const char *text)
+{
+    for (; *text != '\0'; ++text)
+    {
+        gb_serial_set_sb(gb->serial, static_cast<uint8_t>(*text));
+        gb_serial_set_sc(gb->serial, 0x81);
+        gb_run_cycles(gb, GB_SERIAL_TRANSFER_CYCLES);
+    }
+}
+
+TEST_CASE("Serial transfers finish after eight bits and interrupt")
+{
+    Gb *gb = gb_create(nullptr);
+    GbSerial *serial = gb->serial;
+
+    gb_serial_set_sb(serial, 'P');
+    gb_serial_set_sc(serial, 0x81);
+    REQUIRE(gb_serial_get_sc(serial) == 0xff);
+
+    gb_serial_sync(serial, gb->cpu->cycles + GB_SERIAL_TRANSFER_CYCLES - 1);
+    REQUIRE(GB_BIT_CHECK(serial->sc, 7));
+    REQUIRE_FALSE(GB_BIT_CHECK(gb->cpu->interrupt_flag, GB_INTERRUPT_SERIAL));
+
+    // The scheduler finishes it on time when the CPU runs
+    gb_run_cycles(gb, GB_SERIAL_TRANSFER_CYCLES);
+    REQUIRE(gb_serial_get_sc(serial) == 0x7f);
+    REQUIRE(serial->sb == 0xff);
+    REQUIRE(GB_BIT_CHECK(gb->cpu->interrupt_flag, GB_INTERRUPT_SERIAL));
+
+    // Nothing drives the external clock
+    gb->cpu->interrupt_flag = 0;
+    gb_serial_set_sc(serial, 0x80);
+    gb_run_cycles(gb, 4 * GB_SERIAL_TRANSFER_CYCLES);
+    REQUIRE(GB_BIT_CHECK(serial->sc, 7));
+    REQUIRE_FALSE(GB_BIT_CHECK(gb->cpu->interrupt_flag, GB_INTERRUPT_SERIAL));
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Serial output can be searched and taken")
+{
+    Gb *gb = gb_create(nullptr);
+
+    send(gb, "cpu_instrs\n\nPassed");
+    REQUIRE(gb_find_serial_output(gb, "Passed"));
+    REQUIRE_FALSE(gb_find_serial_output(gb, "Failed"));
+
+    uint8_t buffer[64];
+    REQUIRE(gb_take_serial_output(gb, buffer, 4) == 4);
+    REQUIRE(std::memcmp(buffer, "cpu_", 4) == 0);
+    REQUIRE(gb_take_serial_output(gb, buffer, sizeof(buffer)) == 14);
+    REQUIRE(std::memcmp(buffer, "instrs\n\nPassed", 14) == 0);
+    REQUIRE(gb_take_serial_output(gb, buffer, sizeof(buffer)) == 0);
+    REQUIRE_FALSE(gb_find_serial_output(gb, "Passed"));
+
+    // A host that falls behind loses the oldest bytes, a match across the wrap still counts
+    for (uint32_t i = 0; i < GB_SERIAL_OUTPUT_SIZE - 3; ++i)
+    {
+        gb_serial_set_sb(gb->serial, '.');
+        gb_serial_set_sc(gb->serial, 0x80);
+    }
+    send(gb, "Failed");
+    REQUIRE(gb_find_serial_output(gb, "Failed"));
+    REQUIRE(gb_take_serial_output(gb, buffer, 1) == 1);
+    REQUIRE(buffer[0] == '.');
+    REQUIRE(gb->serial->output_tail == gb->serial->output_head - GB_SERIAL_OUTPUT_SIZE + 1);
+
+    gb_destroy(gb);
+}
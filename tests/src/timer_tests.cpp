@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2025-present, SkillerRaptor
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstdint>
+#include <random>
+
+#include <catch2/catch_test_macros.hpp>
+#include <gb/cpu.h>
+#include <gb/gb.h>
+#include <gb/timer.h>
+#include <gb/utils/bits.h>
+
+// Steps the system counter one T-cycle at a time and watches its bits like the hardware does
+struct ReferenceTimer
+{
+    uint16_t counter = 0;
+    uint8_t tima = 0;
+    uint8_t tma = 0;
+    uint8_t tac = 0;
+    bool interrupt = false;
+
+    bool signal() const
+    {
+        static constexpr uint16_t BITS[] = { 1 << 9, 1 << 3, 1 << 5, 1 << 7 };
+        return (tac & 0b100) != 0 && (counter & BITS[tac & 0b11]) != 0;
+    }
+
+    void step_tima()
+    {
+        tima += 1;
+        if (tima == 0)
+        {
+            tima = tma;
+            interrupt = true;
+        }
+    }
+
+    void update(const bool before)
+    {
+        if (before && !signal())
+        {
+            step_tima();
+        }
+    }
+
+    void tick()
+    {
+        const bool before = signal();
+        counter += 1;
+        update(before);
+    }
+
+    void reset_div()
+    {
+        const bool before = signal();
+        counter = 0;
+        update(before);
+    }
+
+    void set_tac(const uint8_t value)
+    {
+        const bool before = signal();
+        tac = value;
+        update(before);
+    }
+};
+
+TEST_CASE("Timer matches a cycle-stepped reference")
+{
+    Gb *gb = gb_create(nullptr);
+    GbTimer *timer = gb->timer;
+    ReferenceTimer reference;
+
+    // The boot ROM leaves the system counter running, the reference starts at 0
+    gb_timer_reset_div(timer);
+
+    std::mt19937 random(0x7173);
+    std::uniform_int_distribution<uint32_t> long_gap_chance(0, 15);
+    std::uniform_int_distribution<uint32_t> long_gap(0, 99'999);
+    std::uniform_int_distribution<uint32_t> short_gap(0, 599);
+    for (uint32_t operation = 0; operation < 20'000; ++operation)
+    {
+        // Mostly short gaps, with the odd long one that covers several overflows at once
+        const uint32_t gap = long_gap_chance(random) == 0 ? long_gap(random) : short_gap(random);
+        for (uint32_t i = 0; i < gap; ++i)
+        {
+            reference.tick();
+        }
+        gb_timer_sync(timer, timer->cycles + gap);
+
+        const auto value = static_cast<uint8_t>(random());
+        switch (random() % 5)
+        {
+        case 0:
+            gb_timer_reset_div(timer);
+            reference.reset_div();
+            break;
+        case 1:
+            gb_timer_set_tima(timer, value);
+            reference.tima = value;
+            break;
+        case 2:
+            gb_timer_set_tma(timer, value);
+            reference.tma = value;
+            break;
+        case 3:
+            gb_timer_set_tac(timer, value);
+            reference.set_tac(value);
+            break;
+        default:
+            break;
+        }
+
+        REQUIRE(gb_timer_get_div(timer) == static_cast<uint8_t>(reference.counter >> 8));
+        REQUIRE(timer->tima == reference.tima);
+        REQUIRE(GB_BIT_CHECK(gb->cpu->interrupt_flag, 2) == reference.interrupt);
+
+        gb->cpu->interrupt_flag = 0;
+        reference.interrupt = false;
+    }
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Timer overflow deadline lands on the interrupt")
+{
+    Gb *gb = gb_create(nullptr);
+    GbTimer *timer = gb->timer;
+
+    REQUIRE(timer->next_interrupt == UINT64_MAX);
+
+    // The boot ROM leaves the system counter running and V-Blank pending
+    gb_timer_reset_div(timer);
+    gb->cpu->interrupt_flag = 0;
+
+    // 16 cycles per step, so TIMA = 0xf0 overflows 16 steps later
+    gb_timer_sync(timer, 5);
+    gb_timer_set_tac(timer, 0b101);
+    gb_timer_set_tima(timer, 0xf0);
+    REQUIRE(timer->next_interrupt == 16 * 16);
+
+    gb_timer_sync(timer, timer->next_interrupt - 1);
+    REQUIRE(gb->cpu->interrupt_flag == 0);
+    gb_timer_sync(timer, timer->next_interrupt);
+    REQUIRE(GB_BIT_CHECK(gb->cpu->interrupt_flag, 2));
+    REQUIRE(timer->tima == timer->tma);
+
+    gb_timer_set_tac(timer, 0b001);
+    REQUIRE(timer->next_interrupt == UINT64_MAX);
+
+    gb_destroy(gb);
+}
+
+TEST_CASE("Timer runs twice as fast in double speed")
+{
+    Gb *gb = gb_create(nullptr);
+    GbTimer *timer = gb->timer;
+
+    // Switching speed resets DIV, so both runs start at the same counter value
+    gb_timer_set_double_speed(timer, false);
+    gb_timer_set_tac(timer, 0b101);
+    gb_timer_sync(timer, 256);
+    REQUIRE(timer->tima == 16);
+
+    gb_timer_set_tima(timer, 0);
+    gb_timer_set_double_speed(timer, true);
+    gb_timer_sync(timer, 512);
+    REQUIRE(timer->tima == 32);
+    REQUIRE(gb_timer_get_div(timer) == 2);
+
+    gb_destroy(gb);
+}